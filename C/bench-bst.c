@@ -0,0 +1,208 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "utils.h"
+#include "bst.h"
+#include "intbst.h"
+
+/*
+ * Benchmarks lookups in a binary search tree that is much larger than the last level cache. The
+ * same random keys are looked up one at a time with bstFind and in batches with bstFindBatch, and
+ * in an integer keyed tree holding the same keys inline.
+ *
+ * The walks over the whole tree are then timed on a degenerate tree, shaped as ascending inserts
+ * leave a plain binary search tree, where every node is the right child of the one before. The tree is built with hinted
+ * appends, which are timed too. Walks that recursed once per level would overflow the stack on a
+ * tree this deep.
+ *
+ * Usage: bench-bst [numElements] [numLookups] [skewedElements]
+ */
+
+/* The number of keys passed to each call of bstFindBatch */
+#define LOOKUP_BATCH_SIZE 256
+
+/* Benchmark prototypes */
+double benchFind( BST *bst, void **keys, int numLookups );
+double benchFindBatch( BST *bst, void **keys, int numLookups );
+double benchIntFind( IntBST *intBST, void **keys, int numLookups );
+void benchSkewed( int numElements );
+
+/* Functions used in benchmarking */
+int comparisonFunction( void *aPtr, void *bPtr );
+int *mallocInt( int a );
+double secondsSince( clock_t start );
+void countNode( BSTNode *node );
+
+/* The number of nodes supplied to countNode */
+long nodesVisited = 0;
+
+int main( int argc, char *argv[] ) {
+    setDebuggingLevel( E_ERROR );
+    srand( 42 );
+
+    int numElements = argc > 1 ? atoi( argv[1] ) : 2000000;
+    int numLookups = argc > 2 ? atoi( argv[2] ) : 2000000;
+    int skewedElements = argc > 3 ? atoi( argv[3] ) : 10000000;
+
+    // Random insertion order keeps the tree's height logarithmic while scattering its nodes. The
+    // integer tree gets the same keys in the same order, so both trees have the same shape.
+    BST *bst = newBST( comparisonFunction );
+    IntBST *intBST = newIntBST();
+    while( bst->size < numElements ) {
+        int *element = mallocInt( rand() );
+        int size = bst->size;
+
+        bstInsert( bst, element );
+        if( bst->size == size ) {
+            free( element );
+        } else {
+            intBSTInsert( intBST, *element, NULL );
+        }
+    }
+
+    void **keys = malloc( sizeof(void *) * numLookups );
+    for( int i = 0; i < numLookups; i++ ) {
+        keys[i] = mallocInt( rand() );
+    }
+
+    printf( "Looking up %d keys in a tree of %d elements\n", numLookups, numElements );
+    printf( "%-24s %10.4fs\n", "bstFind", benchFind( bst, keys, numLookups ) );
+    printf( "%-24s %10.4fs\n", "bstFindBatch", benchFindBatch( bst, keys, numLookups ) );
+    printf( "%-24s %10.4fs\n", "intBSTFind", benchIntFind( intBST, keys, numLookups ) );
+
+    for( int i = 0; i < numLookups; i++ ) {
+        free( keys[i] );
+    }
+
+    free( keys );
+    intBSTFree( intBST );
+    bstFree( bst );
+
+    benchSkewed( skewedElements );
+    return 0;
+}
+
+double benchFind( BST *bst, void **keys, int numLookups ) {
+    clock_t start = clock();
+    int found = 0;
+
+    for( int i = 0; i < numLookups; i++ ) {
+        found += bstFind( bst, keys[i] ) != NULL;
+    }
+
+    double elapsed = secondsSince( start );
+    debug( E_INFO, "bstFind found %d keys\n", found );
+    return elapsed;
+}
+
+double benchFindBatch( BST *bst, void **keys, int numLookups ) {
+    void *results[ LOOKUP_BATCH_SIZE ];
+    clock_t start = clock();
+    int found = 0;
+
+    for( int i = 0; i < numLookups; i += LOOKUP_BATCH_SIZE ) {
+        int batchSize = numLookups - i < LOOKUP_BATCH_SIZE ? numLookups - i : LOOKUP_BATCH_SIZE;
+        found += bstFindBatch( bst, keys + i, batchSize, results );
+    }
+
+    double elapsed = secondsSince( start );
+    debug( E_INFO, "bstFindBatch found %d keys\n", found );
+    return elapsed;
+}
+
+double benchIntFind( IntBST *intBST, void **keys, int numLookups ) {
+    clock_t start = clock();
+    int found = 0;
+
+    for( int i = 0; i < numLookups; i++ ) {
+        found += intBSTFind( intBST, *(int *) keys[i], NULL );
+    }
+
+    double elapsed = secondsSince( start );
+    debug( E_INFO, "intBSTFind found %d keys\n", found );
+    return elapsed;
+}
+
+void benchSkewed( int numElements ) {
+    BST *bst = newBST( comparisonFunction );
+    BSTNode *last = NULL;
+    printf( "\nWalking a degenerate tree of %d elements\n", numElements );
+
+    // A treap would rotate the appended nodes into a balanced shape, so this is a plain tree.
+    // Hinting each insert with the previous node avoids the quadratic cost of ascending inserts.
+    bst->treap = false;
+    clock_t start = clock();
+    for( int i = 0; i < numElements; i++ ) {
+        last = bstInsertHint( bst, last, mallocInt( i ) );
+    }
+
+    printf( "%-24s %10.4fs\n", "bstInsertHint (append)", secondsSince( start ) );
+
+    start = clock();
+    bstPreOrder( bst, countNode );
+    printf( "%-24s %10.4fs\n", "bstPreOrder", secondsSince( start ) );
+
+    start = clock();
+    bstInOrder( bst, countNode );
+    printf( "%-24s %10.4fs\n", "bstInOrder", secondsSince( start ) );
+
+    start = clock();
+    bstPostOrder( bst, countNode );
+    printf( "%-24s %10.4fs\n", "bstPostOrder", secondsSince( start ) );
+
+    start = clock();
+    void **elements = bstElements( bst );
+    printf( "%-24s %10.4fs\n", "bstElements", secondsSince( start ) );
+    free( elements );
+
+    start = clock();
+    BST *copy = bstCopy( bst );
+    printf( "%-24s %10.4fs\n", "bstCopy", secondsSince( start ) );
+
+    start = clock();
+    bstFreeStructure( copy );
+    printf( "%-24s %10.4fs\n", "bstFreeStructure", secondsSince( start ) );
+
+    // Removing the last element walks the full depth of the tree
+    int *deepest = mallocInt( numElements - 1 );
+    start = clock();
+    free( bstRemove( bst, deepest ) );
+    printf( "%-24s %10.4fs\n", "bstRemove (deepest)", secondsSince( start ) );
+    free( deepest );
+
+    start = clock();
+    bstFree( bst );
+    printf( "%-24s %10.4fs\n", "bstFree", secondsSince( start ) );
+
+    debug( E_INFO, "Visited %ld nodes\n", nodesVisited );
+}
+
+/* Functions for use in benchmarking */
+int comparisonFunction( void *aPtr, void *bPtr ) {
+    int a = *((int *) aPtr);
+    int b = *((int *) bPtr);
+
+    if( a < b ) {
+        return -1;
+    } else if( a == b ) {
+        return 0;
+    } else {
+        return 1;
+    }
+}
+
+int *mallocInt( int a ) {
+    int *newInt = malloc( sizeof(int) );
+    *newInt = a;
+
+    return newInt;
+}
+
+double secondsSince( clock_t start ) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+void countNode( BSTNode *node ) {
+    nodesVisited++;
+}
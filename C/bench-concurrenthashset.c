@@ -0,0 +1,156 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "utils.h"
+#include "concurrenthashset.h"
+#include "set.h"
+
+/*
+ * Benchmarks a write-heavy ingest as the number of threads grows. Every thread adds its own range
+ * of elements to one shared set, starting from an empty set so that the table resizes along the
+ * way. The same ingest is run against a ConcurrentHashSet and against a Set guarded by a single
+ * mutex.
+ *
+ * Throughput is measured in wall clock time, so it only scales with the thread count on a machine
+ * with that many free cores.
+ *
+ * Usage: bench-concurrenthashset [elementsPerThread] [maxThreads]
+ */
+
+/* The most threads that will be run at once */
+#define MAX_THREADS 64
+
+/*
+ * The state of one benchmark thread.
+ */
+typedef struct BenchThread {
+    pthread_t thread;
+    int offset;
+} BenchThread;
+
+/* Benchmark prototypes */
+double benchThreads( void *(*run)( void * ), int numThreads );
+void *runHashSet( void *argument );
+void *runLockedSet( void *argument );
+
+/* Functions used in benchmarking */
+int comparisonFunction( void *aPtr, void *bPtr );
+unsigned long hashFunction( void *element );
+int *mallocInt( int a );
+double wallSecondsSince( struct timespec *start );
+
+/* The workload shared by every thread */
+int elementsPerThread = 0;
+ConcurrentHashSet *hashSet = NULL;
+Set *lockedSet = NULL;
+pthread_mutex_t setLock = PTHREAD_MUTEX_INITIALIZER;
+
+int main( int argc, char *argv[] ) {
+    setDebuggingLevel( E_ERROR );
+
+    elementsPerThread = argc > 1 ? atoi( argv[1] ) : 500000;
+    int maxThreads = argc > 2 ? atoi( argv[2] ) : 8;
+
+    if( maxThreads > MAX_THREADS ) {
+        maxThreads = MAX_THREADS;
+    }
+
+    printf( "Each thread adds %d elements to an initially empty set\n", elementsPerThread );
+    printf( "%-8s %24s %20s\n", "threads", "ConcurrentHashSet Mops/s", "mutex Set Mops/s" );
+
+    for( int numThreads = 1; numThreads <= maxThreads; numThreads *= 2 ) {
+        double totalOperations = (double) numThreads * elementsPerThread / 1e6;
+
+        hashSet = newConcurrentHashSet( comparisonFunction, hashFunction );
+        double hashSeconds = benchThreads( runHashSet, numThreads );
+        concurrentHashSetFree( hashSet );
+
+        lockedSet = newSet( comparisonFunction );
+        double lockedSeconds = benchThreads( runLockedSet, numThreads );
+        setFree( lockedSet );
+
+        printf( "%-8d %24.2f %20.2f\n", numThreads, totalOperations / hashSeconds,
+                totalOperations / lockedSeconds );
+    }
+
+    return 0;
+}
+
+double benchThreads( void *(*run)( void * ), int numThreads ) {
+    BenchThread threads[ MAX_THREADS ];
+    struct timespec start;
+
+    clock_gettime( CLOCK_MONOTONIC, &start );
+
+    for( int i = 0; i < numThreads; i++ ) {
+        threads[i].offset = i * elementsPerThread;
+        pthread_create( &threads[i].thread, NULL, run, &threads[i] );
+    }
+
+    for( int i = 0; i < numThreads; i++ ) {
+        pthread_join( threads[i].thread, NULL );
+    }
+
+    return wallSecondsSince( &start );
+}
+
+void *runHashSet( void *argument ) {
+    BenchThread *thread = argument;
+
+    // Multiplying by a large odd constant scatters each thread's range across the key space
+    for( int i = 0; i < elementsPerThread; i++ ) {
+        concurrentHashSetAdd( hashSet, mallocInt( (thread->offset + i) * 2654435761u ) );
+    }
+
+    return NULL;
+}
+
+void *runLockedSet( void *argument ) {
+    BenchThread *thread = argument;
+
+    for( int i = 0; i < elementsPerThread; i++ ) {
+        int *element = mallocInt( (thread->offset + i) * 2654435761u );
+
+        pthread_mutex_lock( &setLock );
+        setAdd( lockedSet, element );
+        pthread_mutex_unlock( &setLock );
+    }
+
+    return NULL;
+}
+
+/* Functions for use in benchmarking */
+int comparisonFunction( void *aPtr, void *bPtr ) {
+    int a = *((int *) aPtr);
+    int b = *((int *) bPtr);
+
+    if( a < b ) {
+        return -1;
+    } else if( a == b ) {
+        return 0;
+    } else {
+        return 1;
+    }
+}
+
+unsigned long hashFunction( void *element ) {
+    return (unsigned long) *(int *) element;
+}
+
+int *mallocInt( int a ) {
+    int *newInt = (int *) malloc( sizeof(int) );
+    *newInt = a;
+
+    return newInt;
+}
+
+double wallSecondsSince( struct timespec *start ) {
+    struct timespec end;
+    clock_gettime( CLOCK_MONOTONIC, &end );
+
+    return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
@@ -0,0 +1,203 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "utils.h"
+#include "concurrentset.h"
+#include "set.h"
+
+/*
+ * Benchmarks the throughput of a mixed workload of lookups and updates as the number of threads
+ * grows. One percent of the operations add or remove an element and the rest are lookups. The same
+ * workload is run against a ConcurrentSet, whose lookups take no locks, and against a Set guarded
+ * by a reader-writer lock.
+ *
+ * Throughput is measured in wall clock time, so it only scales with the thread count on a machine
+ * with that many free cores.
+ *
+ * Usage: bench-concurrentset [numElements] [operationsPerThread] [maxThreads]
+ */
+
+/* One in this many operations is an update */
+#define WRITE_INTERVAL 100
+
+/* The most threads that will be run at once */
+#define MAX_THREADS 64
+
+/*
+ * The state of one benchmark thread.
+ */
+typedef struct BenchThread {
+    pthread_t thread;
+    unsigned int seed;
+    int found;
+} BenchThread;
+
+/* Benchmark prototypes */
+double benchThreads( void *(*run)( void * ), int numThreads );
+void *runConcurrentSet( void *argument );
+void *runLockedSet( void *argument );
+
+/* Functions used in benchmarking */
+int comparisonFunction( void *aPtr, void *bPtr );
+int *mallocInt( int a );
+double wallSecondsSince( struct timespec *start );
+
+/* The workload shared by every thread */
+int numElements = 0;
+int operationsPerThread = 0;
+ConcurrentSet *concurrentSet = NULL;
+Set *lockedSet = NULL;
+pthread_rwlock_t setLock;
+
+int main( int argc, char *argv[] ) {
+    setDebuggingLevel( E_ERROR );
+    srand( 42 );
+
+    numElements = argc > 1 ? atoi( argv[1] ) : 1000000;
+    operationsPerThread = argc > 2 ? atoi( argv[2] ) : 1000000;
+    int maxThreads = argc > 3 ? atoi( argv[3] ) : 8;
+
+    if( maxThreads > MAX_THREADS ) {
+        maxThreads = MAX_THREADS;
+    }
+
+    // Both sets start with the even numbers below twice numElements, so about half of the lookups
+    // and updates find their element
+    concurrentSet = newConcurrentSet( comparisonFunction );
+    lockedSet = newSet( comparisonFunction );
+    pthread_rwlock_init( &setLock, NULL );
+
+    for( int i = 0; i < numElements; i++ ) {
+        int key = 2 * (rand() % numElements);
+        int *element = mallocInt( key );
+
+        if( ! concurrentSetAdd( concurrentSet, element ) ) {
+            free( element );
+        } else {
+            setAdd( lockedSet, mallocInt( key ) );
+        }
+    }
+
+    printf( "%d operations per thread, 1 in %d an update, on sets of about %d elements\n",
+            operationsPerThread, WRITE_INTERVAL, concurrentSetSize( concurrentSet ) );
+    printf( "%-8s %20s %20s\n", "threads", "ConcurrentSet Mops/s", "rwlock Set Mops/s" );
+
+    for( int numThreads = 1; numThreads <= maxThreads; numThreads *= 2 ) {
+        double concurrentSeconds = benchThreads( runConcurrentSet, numThreads );
+        double lockedSeconds = benchThreads( runLockedSet, numThreads );
+        double totalOperations = (double) numThreads * operationsPerThread / 1e6;
+
+        printf( "%-8d %20.2f %20.2f\n", numThreads, totalOperations / concurrentSeconds,
+                totalOperations / lockedSeconds );
+    }
+
+    pthread_rwlock_destroy( &setLock );
+    setFree( lockedSet );
+    concurrentSetFree( concurrentSet );
+    return 0;
+}
+
+double benchThreads( void *(*run)( void * ), int numThreads ) {
+    BenchThread workers[ MAX_THREADS ];
+    struct timespec start;
+    int found = 0;
+
+    clock_gettime( CLOCK_MONOTONIC, &start );
+
+    for( int i = 0; i < numThreads; i++ ) {
+        workers[i].seed = 1000 + i;
+        workers[i].found = 0;
+        pthread_create( &workers[i].thread, NULL, run, &workers[i] );
+    }
+
+    for( int i = 0; i < numThreads; i++ ) {
+        pthread_join( workers[i].thread, NULL );
+        found += workers[i].found;
+    }
+
+    double elapsed = wallSecondsSince( &start );
+    debug( E_INFO, "%d threads found %d keys\n", numThreads, found );
+    return elapsed;
+}
+
+void *runConcurrentSet( void *argument ) {
+    BenchThread *worker = argument;
+    int *key = mallocInt( 0 );
+
+    for( int i = 0; i < operationsPerThread; i++ ) {
+        *key = rand_r( &worker->seed ) % (2 * numElements);
+
+        if( i % WRITE_INTERVAL != 0 ) {
+            worker->found += concurrentSetContains( concurrentSet, key );
+        } else if( ! concurrentSetRemove( concurrentSet, key ) ) {
+            int *element = mallocInt( *key );
+
+            if( ! concurrentSetAdd( concurrentSet, element ) ) {
+                free( element );
+            }
+        }
+    }
+
+    free( key );
+    return NULL;
+}
+
+void *runLockedSet( void *argument ) {
+    BenchThread *worker = argument;
+    int *key = mallocInt( 0 );
+
+    for( int i = 0; i < operationsPerThread; i++ ) {
+        *key = rand_r( &worker->seed ) % (2 * numElements);
+
+        if( i % WRITE_INTERVAL != 0 ) {
+            pthread_rwlock_rdlock( &setLock );
+            worker->found += isInSet( lockedSet, key );
+            pthread_rwlock_unlock( &setLock );
+        } else {
+            pthread_rwlock_wrlock( &setLock );
+
+            int size = lockedSet->size;
+            setRemove( lockedSet, key );
+            if( lockedSet->size == size ) {
+                setAdd( lockedSet, mallocInt( *key ) );
+            }
+
+            pthread_rwlock_unlock( &setLock );
+        }
+    }
+
+    free( key );
+    return NULL;
+}
+
+/* Functions for use in benchmarking */
+int comparisonFunction( void *aPtr, void *bPtr ) {
+    int a = *((int *) aPtr);
+    int b = *((int *) bPtr);
+
+    if( a < b ) {
+        return -1;
+    } else if( a == b ) {
+        return 0;
+    } else {
+        return 1;
+    }
+}
+
+int *mallocInt( int a ) {
+    int *newInt = (int *) malloc( sizeof(int) );
+    *newInt = a;
+
+    return newInt;
+}
+
+double wallSecondsSince( struct timespec *start ) {
+    struct timespec end;
+    clock_gettime( CLOCK_MONOTONIC, &end );
+
+    return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "utils.h"
+#include "bst.h"
+#include "frozenbst.h"
+
+/*
+ * Benchmarks lookups in a frozen Eytzinger array against lookups in the tree it was built from. The
+ * tree size starts at 1000 elements and grows by a factor of ten up to the maximum size, and every
+ * size performs the same number of random lookups, about a quarter of which are hits.
+ *
+ * Usage: bench-frozenbst [maxElements] [numLookups]
+ */
+
+/* Benchmark prototypes */
+double benchTree( BST *bst, int **keys, int numLookups );
+double benchFrozen( FrozenBST *frozen, int **keys, int numLookups );
+
+/* Functions used in benchmarking */
+int comparisonFunction( void *aPtr, void *bPtr );
+int *mallocInt( int a );
+double secondsSince( clock_t start );
+
+int main( int argc, char *argv[] ) {
+    setDebuggingLevel( E_ERROR );
+    srand( 42 );
+
+    int maxElements = argc > 1 ? atoi( argv[1] ) : 1000000;
+    int numLookups = argc > 2 ? atoi( argv[2] ) : 1000000;
+
+    printf( "%12s %12s %12s\n", "Elements", "bstFind", "frozen" );
+
+    for( long numElements = 1000; numElements <= maxElements; numElements *= 10 ) {
+        // Half of the even numbers below 4n are inserted in a random order
+        BST *bst = newBST( comparisonFunction );
+        while( bst->size < numElements ) {
+            int *element = mallocInt( 2 * (rand() % (int) (2 * numElements)) );
+            int size = bst->size;
+
+            bstInsert( bst, element );
+            if( bst->size == size ) {
+                free( element );
+            }
+        }
+
+        int **keys = malloc( sizeof(int *) * numLookups );
+        for( int i = 0; i < numLookups; i++ ) {
+            keys[i] = mallocInt( rand() % (int) (4 * numElements) );
+        }
+
+        FrozenBST *frozen = bstFreeze( bst );
+        double treeTime = benchTree( bst, keys, numLookups );
+        double frozenTime = benchFrozen( frozen, keys, numLookups );
+        printf( "%12ld %11.4fs %11.4fs\n", numElements, treeTime, frozenTime );
+
+        for( int i = 0; i < numLookups; i++ ) {
+            free( keys[i] );
+        }
+
+        free( keys );
+        frozenBSTFreeStructure( frozen );
+        bstFree( bst );
+    }
+
+    return 0;
+}
+
+double benchTree( BST *bst, int **keys, int numLookups ) {
+    clock_t start = clock();
+    int found = 0;
+
+    for( int i = 0; i < numLookups; i++ ) {
+        found += bstFind( bst, keys[i] ) != NULL;
+    }
+
+    double elapsed = secondsSince( start );
+    debug( E_INFO, "bstFind found %d keys\n", found );
+    return elapsed;
+}
+
+double benchFrozen( FrozenBST *frozen, int **keys, int numLookups ) {
+    clock_t start = clock();
+    int found = 0;
+
+    for( int i = 0; i < numLookups; i++ ) {
+        found += frozenBSTFind( frozen, keys[i] ) != NULL;
+    }
+
+    double elapsed = secondsSince( start );
+    debug( E_INFO, "frozenBSTFind found %d keys\n", found );
+    return elapsed;
+}
+
+/* Functions for use in benchmarking */
+int comparisonFunction( void *aPtr, void *bPtr ) {
+    int a = *((int *) aPtr);
+    int b = *((int *) bPtr);
+
+    if( a < b ) {
+        return -1;
+    } else if( a == b ) {
+        return 0;
+    } else {
+        return 1;
+    }
+}
+
+int *mallocInt( int a ) {
+    int *newInt = malloc( sizeof(int) );
+    *newInt = a;
+
+    return newInt;
+}
+
+double secondsSince( clock_t start ) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
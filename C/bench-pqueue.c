@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "utils.h"
+#include "llist.h"
+#include "pqueue.h"
+
+/*
+ * Benchmarks the priority queue against a sorted linked list used as a timer queue. Each benchmark
+ * schedules a number of random deadlines and then fires them all in order.
+ *
+ * Usage: bench-pqueue [numTimers]
+ */
+
+/* Benchmark prototypes */
+double benchSortedList( int *deadlines, int numTimers );
+double benchPriorityQueue( int *deadlines, int numTimers, int arity );
+
+/* Functions used in benchmarking */
+int comparisonFunction( void *aPtr, void *bPtr );
+double secondsSince( clock_t start );
+
+int main( int argc, char *argv[] ) {
+    setDebuggingLevel( E_ERROR );
+    srand( 42 );
+
+    int numTimers = argc > 1 ? atoi( argv[1] ) : 20000;
+    int *deadlines = malloc( sizeof(int) * numTimers );
+    for( int i = 0; i < numTimers; i++ ) {
+        deadlines[i] = rand();
+    }
+
+    printf( "Scheduling and firing %d timers\n", numTimers );
+    printf( "%-24s %10.4fs\n", "Sorted LList", benchSortedList( deadlines, numTimers ) );
+
+    for( int arity = 2; arity <= 8; arity *= 2 ) {
+        char name[32];
+        snprintf( name, sizeof(name), "PriorityQueue (%d-ary)", arity );
+        printf( "%-24s %10.4fs\n", name, benchPriorityQueue( deadlines, numTimers, arity ) );
+    }
+
+    free( deadlines );
+    return 0;
+}
+
+double benchSortedList( int *deadlines, int numTimers ) {
+    clock_t start = clock();
+    LList *list = newList( comparisonFunction );
+
+    for( int i = 0; i < numTimers; i++ ) {
+        listInsert( list, &deadlines[i] );
+    }
+
+    while( list->size > 0 ) {
+        listPopFront( list );
+    }
+
+    double elapsed = secondsSince( start );
+
+    // The deadlines aren't owned by the list
+    listFree( list );
+    return elapsed;
+}
+
+double benchPriorityQueue( int *deadlines, int numTimers, int arity ) {
+    clock_t start = clock();
+    PriorityQueue *pq = newPriorityQueueWithArity( comparisonFunction, arity );
+
+    for( int i = 0; i < numTimers; i++ ) {
+        pqPush( pq, &deadlines[i] );
+    }
+
+    while( ! pqIsEmpty( pq ) ) {
+        pqPop( pq );
+    }
+
+    double elapsed = secondsSince( start );
+    pqFreeStructure( pq );
+    return elapsed;
+}
+
+/* Functions for use in benchmarking */
+int comparisonFunction( void *aPtr, void *bPtr ) {
+    int a = *((int *) aPtr);
+    int b = *((int *) bPtr);
+
+    if( a < b ) {
+        return -1;
+    } else if( a == b ) {
+        return 0;
+    } else {
+        return 1;
+    }
+}
+
+double secondsSince( clock_t start ) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "utils.h"
+#include "set.h"
+
+/*
+ * Benchmarks unioning many sets with setUnionMany against chaining pairwise setUnion calls. Every
+ * set holds a random sample of elements from a shared range, so the sets overlap heavily. The
+ * number of sets starts at 4 and doubles up to the maximum.
+ *
+ * Usage: bench-set [maxSets] [elementsPerSet]
+ */
+
+/* Benchmark prototypes */
+double benchChained( Set **sets, int numSets );
+double benchMany( Set **sets, int numSets );
+
+/* Functions used in benchmarking */
+int comparisonFunction( void *aPtr, void *bPtr );
+int *mallocInt( int a );
+double secondsSince( clock_t start );
+
+int main( int argc, char *argv[] ) {
+    setDebuggingLevel( E_ERROR );
+    srand( 42 );
+
+    int maxSets = argc > 1 ? atoi( argv[1] ) : 64;
+    int elementsPerSet = argc > 2 ? atoi( argv[2] ) : 500;
+
+    printf( "%12s %12s %12s\n", "Sets", "setUnion", "unionMany" );
+
+    for( int numSets = 4; numSets <= maxSets; numSets *= 2 ) {
+        Set **sets = malloc( sizeof(Set *) * numSets );
+        int range = 4 * elementsPerSet;
+
+        for( int i = 0; i < numSets; i++ ) {
+            sets[i] = newSet( comparisonFunction );
+
+            while( sets[i]->size < elementsPerSet ) {
+                int *element = mallocInt( rand() % range );
+                int size = sets[i]->size;
+
+                setAdd( sets[i], element );
+                if( sets[i]->size == size ) {
+                    free( element );
+                }
+            }
+        }
+
+        double chainedTime = benchChained( sets, numSets );
+        double manyTime = benchMany( sets, numSets );
+        printf( "%12d %11.4fs %11.4fs\n", numSets, chainedTime, manyTime );
+
+        for( int i = 0; i < numSets; i++ ) {
+            setFree( sets[i] );
+        }
+
+        free( sets );
+    }
+
+    return 0;
+}
+
+double benchChained( Set **sets, int numSets ) {
+    clock_t start = clock();
+    Set *result = setUnion( sets[0], sets[1], NULL );
+
+    for( int i = 2; i < numSets; i++ ) {
+        Set *next = setUnion( result, sets[i], NULL );
+        setFreeStructure( result );
+        result = next;
+    }
+
+    double elapsed = secondsSince( start );
+    debug( E_INFO, "setUnion produced %d elements\n", result->size );
+    setFreeStructure( result );
+    return elapsed;
+}
+
+double benchMany( Set **sets, int numSets ) {
+    clock_t start = clock();
+    Set *result = setUnionMany( sets, numSets );
+
+    double elapsed = secondsSince( start );
+    debug( E_INFO, "setUnionMany produced %d elements\n", result->size );
+    setFreeStructure( result );
+    return elapsed;
+}
+
+/* Functions for use in benchmarking */
+int comparisonFunction( void *aPtr, void *bPtr ) {
+    int a = *((int *) aPtr);
+    int b = *((int *) bPtr);
+
+    if( a < b ) {
+        return -1;
+    } else if( a == b ) {
+        return 0;
+    } else {
+        return 1;
+    }
+}
+
+int *mallocInt( int a ) {
+    int *newInt = malloc( sizeof(int) );
+    *newInt = a;
+
+    return newInt;
+}
+
+double secondsSince( clock_t start ) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
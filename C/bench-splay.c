@@ -0,0 +1,157 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "utils.h"
+#include "bst.h"
+
+/*
+ * Benchmarks lookups in a plain binary search tree against a splay tree holding the same elements.
+ * Both trees are searched with a uniform stream of keys and with a Zipfian stream, where the key of
+ * rank r is looked up with probability proportional to 1 / r^exponent.
+ *
+ * Usage: bench-splay [numElements] [numLookups] [exponent]
+ */
+
+/* Benchmark prototypes */
+double benchFind( BST *bst, void **keys, int numLookups );
+
+/* Functions used in benchmarking */
+void **uniformKeys( void **elements, int numElements, int numLookups );
+void **zipfKeys( void **elements, int numElements, int numLookups, double exponent );
+void shuffle( void **elements, int numElements );
+int comparisonFunction( void *aPtr, void *bPtr );
+int *mallocInt( int a );
+double secondsSince( clock_t start );
+
+int main( int argc, char *argv[] ) {
+    setDebuggingLevel( E_ERROR );
+    srand( 42 );
+
+    int numElements = argc > 1 ? atoi( argv[1] ) : 1000000;
+    int numLookups = argc > 2 ? atoi( argv[2] ) : 2000000;
+    double exponent = argc > 3 ? atof( argv[3] ) : 1.2;
+
+    // Both trees are built from the same shuffled elements so their shapes start out the same
+    void **elements = malloc( sizeof(void *) * numElements );
+    for( int i = 0; i < numElements; i++ ) {
+        elements[i] = mallocInt( 2 * i );
+    }
+
+    shuffle( elements, numElements );
+
+    BST *plain = newBST( comparisonFunction );
+    BST *splay = newSplayTree( comparisonFunction );
+    for( int i = 0; i < numElements; i++ ) {
+        bstInsert( plain, elements[i] );
+        bstInsert( splay, elements[i] );
+    }
+
+    void **uniform = uniformKeys( elements, numElements, numLookups );
+    void **zipf = zipfKeys( elements, numElements, numLookups, exponent );
+
+    printf( "Looking up %d keys in trees of %d elements, Zipf exponent %.2f\n", numLookups,
+            numElements, exponent );
+    printf( "%-24s %10.4fs\n", "uniform, plain", benchFind( plain, uniform, numLookups ) );
+    printf( "%-24s %10.4fs\n", "uniform, splay", benchFind( splay, uniform, numLookups ) );
+    printf( "%-24s %10.4fs\n", "zipf, plain", benchFind( plain, zipf, numLookups ) );
+    printf( "%-24s %10.4fs\n", "zipf, splay", benchFind( splay, zipf, numLookups ) );
+
+    free( uniform );
+    free( zipf );
+    free( elements );
+    bstFreeStructure( splay );
+    bstFree( plain );
+    return 0;
+}
+
+double benchFind( BST *bst, void **keys, int numLookups ) {
+    clock_t start = clock();
+    int found = 0;
+
+    for( int i = 0; i < numLookups; i++ ) {
+        found += bstFind( bst, keys[i] ) != NULL;
+    }
+
+    double elapsed = secondsSince( start );
+    debug( E_INFO, "bstFind found %d keys\n", found );
+    return elapsed;
+}
+
+/* Functions for use in benchmarking */
+void **uniformKeys( void **elements, int numElements, int numLookups ) {
+    void **keys = malloc( sizeof(void *) * numLookups );
+
+    for( int i = 0; i < numLookups; i++ ) {
+        keys[i] = elements[ rand() % numElements ];
+    }
+
+    return keys;
+}
+
+void **zipfKeys( void **elements, int numElements, int numLookups, double exponent ) {
+    void **keys = malloc( sizeof(void *) * numLookups );
+    double *cumulative = malloc( sizeof(double) * numElements );
+    double total = 0;
+
+    for( int rank = 0; rank < numElements; rank++ ) {
+        total += 1.0 / pow( rank + 1, exponent );
+        cumulative[rank] = total;
+    }
+
+    // Ranks are mapped onto the shuffled elements, so the hot keys are scattered through the tree
+    for( int i = 0; i < numLookups; i++ ) {
+        double target = total * rand() / ((double) RAND_MAX + 1);
+        int low = 0;
+        int high = numElements - 1;
+
+        while( low < high ) {
+            int middle = low + (high - low) / 2;
+
+            if( cumulative[middle] <= target ) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+
+        keys[i] = elements[low];
+    }
+
+    free( cumulative );
+    return keys;
+}
+
+void shuffle( void **elements, int numElements ) {
+    for( int i = numElements - 1; i > 0; i-- ) {
+        int j = rand() % (i + 1);
+        void *temp = elements[i];
+        elements[i] = elements[j];
+        elements[j] = temp;
+    }
+}
+
+int comparisonFunction( void *aPtr, void *bPtr ) {
+    int a = *((int *) aPtr);
+    int b = *((int *) bPtr);
+
+    if( a < b ) {
+        return -1;
+    } else if( a == b ) {
+        return 0;
+    } else {
+        return 1;
+    }
+}
+
+int *mallocInt( int a ) {
+    int *newInt = malloc( sizeof(int) );
+    *newInt = a;
+
+    return newInt;
+}
+
+double secondsSince( clock_t start ) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
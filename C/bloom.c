@@ -0,0 +1,131 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bloom.h"
+
+/* Implementation specific helper functions */
+BloomBlock *blockFor( BloomFilter *filter, uint64_t mixed );
+
+/*
+ * Creates a new, empty bloom filter sized for the expected number of elements. With the default of
+ * 10 bits per element, the false positive rate stays around 1% until the filter holds more elements
+ * than it was sized for.
+ *
+ * Arguments:
+ * expectedElements -- The number of elements the filter is expected to hold
+ *
+ * Returns:
+ * An empty bloom filter
+ */
+BloomFilter *newBloomFilter( int expectedElements ) {
+    if( expectedElements < 1 ) {
+        expectedElements = 1;
+    }
+
+    unsigned long bits = (unsigned long) expectedElements * BLOOM_BITS_PER_ELEMENT;
+    BloomFilter *filter = malloc( sizeof(BloomFilter) );
+    filter->numBlocks = (bits + BLOOM_BLOCK_BITS - 1) / BLOOM_BLOCK_BITS;
+    filter->capacity = expectedElements;
+    filter->size = 0;
+
+    // Aligning the blocks to cache lines is what keeps every query to a single line
+    void *blocks = NULL;
+    if( posix_memalign( &blocks, CACHE_LINE_SIZE, sizeof(BloomBlock) * filter->numBlocks ) != 0 ) {
+        debug( E_ERROR, "Could not allocate the blocks of a bloom filter!\n" );
+        free( filter );
+        return NULL;
+    }
+
+    filter->blocks = blocks;
+    bloomClear( filter );
+
+    return filter;
+}
+
+/*
+ * Chooses the block of the filter that a hash maps to, using the upper half of the mixed hash.
+ *
+ * Arguments:
+ * filter -- The filter being accessed
+ * mixed  -- The mixed hash of an element
+ *
+ * Returns:
+ * The block holding the element's bits
+ */
+BloomBlock *blockFor( BloomFilter *filter, uint64_t mixed ) {
+    return &filter->blocks[ (mixed >> 32) % filter->numBlocks ];
+}
+
+/*
+ * Adds an element's hash to the filter.
+ *
+ * Arguments:
+ * filter -- The filter to add the hash to
+ * hash   -- The hash of the element being added
+ */
+void bloomAdd( BloomFilter *filter, unsigned long hash ) {
+    uint64_t mixed = mixHash( hash );
+    BloomBlock *block = blockFor( filter, mixed );
+
+    // Each probe takes 9 bits of a second mix to pick one of the 512 bits in the block
+    uint64_t probes = mixHash( mixed );
+    for( int i = 0; i < BLOOM_NUM_PROBES; i++ ) {
+        unsigned int bit = probes & (BLOOM_BLOCK_BITS - 1);
+        block->words[ bit / 64 ] |= (uint64_t) 1 << (bit % 64);
+        probes >>= 9;
+    }
+
+    filter->size++;
+}
+
+/*
+ * Determines whether an element with the supplied hash might have been added to the filter.
+ *
+ * Arguments:
+ * filter -- The filter to check
+ * hash   -- The hash of the element being looked for
+ *
+ * Returns:
+ * False if the element was definitely never added, true if it may have been
+ */
+bool bloomMightContain( BloomFilter *filter, unsigned long hash ) {
+    uint64_t mixed = mixHash( hash );
+    BloomBlock *block = blockFor( filter, mixed );
+
+    uint64_t probes = mixHash( mixed );
+    for( int i = 0; i < BLOOM_NUM_PROBES; i++ ) {
+        unsigned int bit = probes & (BLOOM_BLOCK_BITS - 1);
+
+        if( ! (block->words[ bit / 64 ] & ((uint64_t) 1 << (bit % 64))) ) {
+            return false;
+        }
+
+        probes >>= 9;
+    }
+
+    return true;
+}
+
+/*
+ * Removes every hash from the filter without changing its size.
+ *
+ * Arguments:
+ * filter -- The filter to clear
+ */
+void bloomClear( BloomFilter *filter ) {
+    memset( filter->blocks, 0, sizeof(BloomBlock) * filter->numBlocks );
+    filter->size = 0;
+}
+
+/*
+ * Frees the filter.
+ *
+ * Arguments:
+ * filter -- The filter that is being freed
+ */
+void bloomFree( BloomFilter *filter ) {
+    free( filter->blocks );
+    free( filter );
+}
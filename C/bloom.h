@@ -0,0 +1,87 @@
+#ifndef BLOOM_H
+#define BLOOM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "utils.h"
+
+/* The number of bits in a single block of a bloom filter, which is the size of a cache line */
+#define BLOOM_BLOCK_BITS (CACHE_LINE_SIZE * 8)
+
+/* The number of filter bits reserved for each expected element */
+#define BLOOM_BITS_PER_ELEMENT 10
+
+/* The number of bits set within a block for each element */
+#define BLOOM_NUM_PROBES 7
+
+/*
+ * A single cache line of a blocked bloom filter.
+ */
+typedef struct BloomBlock {
+    uint64_t words[ BLOOM_BLOCK_BITS / 64 ];
+} BloomBlock;
+
+/*
+ * A blocked bloom filter. Every element is mapped to a single cache-line sized block, and all of
+ * its bits are set within that block, so a query reads exactly one cache line. The filter stores hashes
+ * rather than elements, so it never produces false negatives but may produce false positives.
+ */
+typedef struct BloomFilter {
+    BloomBlock *blocks;
+    unsigned long numBlocks;
+    int capacity;
+    int size;
+} BloomFilter;
+
+/*
+ * Creates a new, empty bloom filter sized for the expected number of elements. With the default of
+ * 10 bits per element, the false positive rate stays around 1% until the filter holds more elements
+ * than it was sized for.
+ *
+ * Arguments:
+ * expectedElements -- The number of elements the filter is expected to hold
+ *
+ * Returns:
+ * An empty bloom filter
+ */
+extern BloomFilter *newBloomFilter( int expectedElements );
+
+/*
+ * Adds an element's hash to the filter.
+ *
+ * Arguments:
+ * filter -- The filter to add the hash to
+ * hash   -- The hash of the element being added
+ */
+extern void bloomAdd( BloomFilter *filter, unsigned long hash );
+
+/*
+ * Determines whether an element with the supplied hash might have been added to the filter.
+ *
+ * Arguments:
+ * filter -- The filter to check
+ * hash   -- The hash of the element being looked for
+ *
+ * Returns:
+ * False if the element was definitely never added, true if it may have been
+ */
+extern bool bloomMightContain( BloomFilter *filter, unsigned long hash );
+
+/*
+ * Removes every hash from the filter without changing its size.
+ *
+ * Arguments:
+ * filter -- The filter to clear
+ */
+extern void bloomClear( BloomFilter *filter );
+
+/*
+ * Frees the filter.
+ *
+ * Arguments:
+ * filter -- The filter that is being freed
+ */
+extern void bloomFree( BloomFilter *filter );
+
+#endif
@@ -1,3 +1,4 @@
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -5,15 +6,88 @@
 #include "bst.h"
 #include "utils.h"
 
+/* Subproblems of the join-based operations deeper than this are not spawned as separate tasks */
+#define SPAWN_DEPTH 8
+
+/*
+ * The join-based set operations.
+ */
+typedef enum TreeOperation {
+    TREE_UNION,
+    TREE_INTERSECT,
+    TREE_DIFFERENCE
+} TreeOperation;
+
+/*
+ * One subproblem of a join-based operation. The result is the combination of the two subtrees and
+ * matches is the number of elements that were found in both of them.
+ */
+typedef struct TreeOperationTask {
+    TreeOperation operation;
+    ThreadPool *pool;
+    ComparisonFunction compare;
+    int depth;
+    BSTNode *a;
+    BSTNode *b;
+    BSTNode *result;
+    int matches;
+} TreeOperationTask;
+
+/*
+ * The state of one in-flight search of a bstFindBatch. A search alternates between two stages at
+ * every node: first the node is read and its element prefetched, then the element is compared and
+ * the next node prefetched. The key index is negative once the slot has no keys left to search for.
+ */
+typedef enum BatchStage {
+    BATCH_LOAD_ELEMENT,
+    BATCH_COMPARE
+} BatchStage;
+
+typedef struct BatchSearch {
+    int keyIndex;
+    BSTNode *node;
+    BatchStage stage;
+} BatchSearch;
+
+/*
+ * The orders in which walkNodes can visit the nodes of a subtree.
+ */
+typedef enum TraversalOrder {
+    PRE_ORDER,
+    IN_ORDER,
+    POST_ORDER
+} TraversalOrder;
+
 /* Implementation specific helper functions */
-void preOrderHelper(BSTNode *node, BSTNodeConsumer consumer );
-void postOrderHelper(BSTNode *node, BSTNodeConsumer consumer );
-void inOrderHelper(BSTNode *node, BSTNodeConsumer consumer );
+void walkNodes( BSTNode *root, TraversalOrder order, BSTNodeConsumer consumer );
+BSTNode *leftmostNode( BSTNode *node );
+BSTNode *rightmostNode( BSTNode *node );
+BSTNode *minimumNode( BST *bst );
+BSTNode *maximumNode( BST *bst );
+void *removeTreeNode( BST *bst, BSTNode *node );
+BSTNode *insertFromRoot( BST *bst, void *element );
+BSTNode *attachNode( BST *bst, BSTNode *parent, bool asLeft, void *element );
 void freeNode( BSTNode *node );
 void freeNodeStructure( BSTNode *node );
 void replaceNodeInParent( BST *bst, BSTNode *node, BSTNode *replacement );
-void bstElementsHelper( BSTNode *current, void **elements, int *index );
-void *removeHelper( BST *bst, BSTNode *node, void *data );
+int startBatchSearch( BST *bst, BatchSearch *search, int *nextKey, int numKeys );
+BSTNode *buildBalanced( void **elements, int start, int end, BSTNode *parent );
+BSTNode *copyNodes( BSTNode *root );
+int countNodes( BSTNode *node );
+uint64_t nodePriority( BSTNode *node );
+void setLeft( BSTNode *node, BSTNode *child );
+void setRight( BSTNode *node, BSTNode *child );
+BSTNode *splitNodes( BSTNode *root, void *key, ComparisonFunction compare, BSTNode **less,
+        BSTNode **greater );
+BSTNode *joinNodes( BSTNode *less, BSTNode *middle, BSTNode *greater );
+BSTNode *joinTwoNodes( BSTNode *less, BSTNode *greater );
+void hangNode( BSTNode **root, BSTNode *parent, bool asLeft, BSTNode *child );
+void runTreeOperation( void *argument );
+BST *treeOperation( TreeOperation operation, BST *a, BST *b, ThreadPool *pool );
+void rotateUp( BST *bst, BSTNode *node );
+void splayNode( BST *bst, BSTNode *node );
+void treeToVine( BSTNode *pseudoRoot );
+void compressVine( BSTNode *pseudoRoot, int count );
 
 /*
  * Creates a new binary search tree node. This node has some data, and references to its left and
@@ -55,6 +129,10 @@ BST *newBST( ComparisonFunction comparisonFunction ) {
         bst->root = NULL;
         bst->comparisonFunction = comparisonFunction;
         bst->size = 0;
+        bst->splay = false;
+        bst->minNode = NULL;
+        bst->maxNode = NULL;
+        bst->treap = true;
 
         return bst;
     } else {
@@ -62,57 +140,195 @@ BST *newBST( ComparisonFunction comparisonFunction ) {
     }
 }
 
+/*
+ * Creates a new splay tree. bstFind, bstInsert and bstRemove splay the node they reach to the root
+ * of a splay tree, so even lookups modify it and must not run concurrently with anything else.
+ *
+ * Arguments:
+ * comparisonFunction -- A function that will be used to order the inserted elements.
+ *
+ * Returns:
+ * An empty splay tree, or NULL if the comparison function is NULL
+ */
+BST *newSplayTree( ComparisonFunction comparisonFunction ) {
+    BST *bst = newBST( comparisonFunction );
+
+    if( bst != NULL ) {
+        bst->splay = true;
+    }
+
+    return bst;
+}
+
 /*
  * Inserts an element into the tree. This element will be placed in its correct ordinal position as
  * determined by the tree's comparison function. If the element or the treeis NULL, then the element
- * will not be inserted.
+ * will not be inserted. In a treap, the new node is rotated up to the position its priority calls
+ * for, which takes an expected O(1) rotations.
  *
  * Arguments:
  * bst             -- The tree to insert the element into.
  * elementToInsert -- The element that you would like to insert into the tree.
  */
 void bstInsert( BST *bst, void *elementToInsert ) {
+    insertFromRoot( bst, elementToInsert );
+}
+
+/*
+ * Inserts an element next to a hint node, which skips the search from the root whenever the element
+ * belongs immediately before or after the hint. The hint is checked against its neighbour in order,
+ * so a wrong hint only costs two comparisons before the element is inserted normally. Finding the
+ * neighbour takes time proportional to the distance between the two nodes, except at either end of
+ * the tree, where the cached extremes show that there is no neighbour. Appending ascending keys
+ * with the previous node (or NULL) as the hint therefore takes expected O(1) time per key. As with
+ * bstInsert, a treap rotates the new node up into place, so a tree built this way stays balanced,
+ * and a splay tree still splays the inserted node.
+ *
+ * Arguments:
+ * bst     -- The tree to insert the element into
+ * hint    -- A node of the tree that the element should be placed next to. If this is NULL, the
+ *            element is expected to be larger than every element in the tree.
+ * element -- The element to insert
+ *
+ * Returns:
+ * The node holding the element, or the node holding an equivalent element if there already was
+ * one. This makes a good hint for the next insertion. If the element is NULL, NULL is returned.
+ */
+BSTNode *bstInsertHint( BST *bst, BSTNode *hint, void *element ) {
+    if( element == NULL ) {
+        return NULL;
+    }
+
+    ComparisonFunction compare = bst->comparisonFunction;
+
+    if( hint == NULL ) {
+        // A missing hint refers to the position past the largest element
+        BSTNode *last = maximumNode( bst );
+
+        if( last == NULL ) {
+            return attachNode( bst, NULL, false, element );
+        } else if( compare( element, last->data ) > 0 ) {
+            return attachNode( bst, last, false, element );
+        }
+
+        return insertFromRoot( bst, element );
+    }
+
+    int comparisonResult = compare( element, hint->data );
+
+    if( comparisonResult == 0 ) {
+        return hint;
+    } else if( comparisonResult < 0 ) {
+        // The element belongs just before the hint if it is larger than the hint's predecessor,
+        // which has a free right child whenever the hint's left child is taken
+        BSTNode *before = hint == bst->minNode ? NULL : predecessor( hint );
+
+        if( before == NULL || compare( element, before->data ) > 0 ) {
+            return hint->left ? attachNode( bst, before, false, element ) :
+                attachNode( bst, hint, true, element );
+        }
+    } else {
+        BSTNode *after = hint == bst->maxNode ? NULL : successor( hint );
+
+        if( after == NULL || compare( element, after->data ) < 0 ) {
+            return hint->right ? attachNode( bst, after, true, element ) :
+                attachNode( bst, hint, false, element );
+        }
+    }
+
+    return insertFromRoot( bst, element );
+}
+
+/*
+ * Inserts an element by searching for its position from the root of the tree.
+ *
+ * Arguments:
+ * bst     -- The tree to insert the element into
+ * element -- The element to insert
+ *
+ * Returns:
+ * The node holding the element, or the node holding an equivalent element if there already was one
+ */
+BSTNode *insertFromRoot( BST *bst, void *element ) {
     BSTNode *current = bst->root;
     BSTNode *parent = NULL;
     ComparisonFunction compare = bst->comparisonFunction;
+    int comparisonResult = 0;
 
     // Find where we should insert this new node
     while( current != NULL ) {
-        int comparisonResult = compare( elementToInsert, current->data );
+        comparisonResult = compare( element, current->data );
 
         if( comparisonResult == 0 ) {
             // Can't insert the same item multiple times
-            return;
-        } else if( comparisonResult < 0 ) {
-            parent = current;
-            current = current->left;
-        } else {
-            parent = current;
-            current = current->right;
+            if( bst->splay ) {
+                splayNode( bst, current );
+            }
+
+            return current;
         }
+
+        parent = current;
+        current = comparisonResult < 0 ? current->left : current->right;
     }
 
-    current = newNode( elementToInsert, parent, NULL, NULL );
-    bst->size += 1;
+    return attachNode( bst, parent, comparisonResult < 0, element );
+}
+
+/*
+ * Creates a node for an element and hangs it from a free child slot of its parent, keeping the
+ * size and the cached extremes of the tree up to date. A splay tree splays the new node.
+ *
+ * Arguments:
+ * bst     -- The tree the node is being added to
+ * parent  -- The node to hang the new node from, or NULL if the tree is empty
+ * asLeft  -- Whether the new node becomes the parent's left child rather than its right child
+ * element -- The element the new node holds
+ *
+ * Returns:
+ * The new node
+ */
+BSTNode *attachNode( BST *bst, BSTNode *parent, bool asLeft, void *element ) {
+    BSTNode *node = newNode( element, parent, NULL, NULL );
 
-    if( parent != NULL ) {
-        // At this point, current is NULL and parent is our soon-to-be parent
-        int parentComparison = compare( elementToInsert, parent->data );
+    if( bst->size != BST_SIZE_UNKNOWN ) {
+        bst->size += 1;
+    }
 
-        // Determine which side of the parent we should be placed on
-        if( parentComparison > 0 ) {
-            parent->right = current;
-        } else {
-            parent->left = current;
-        }
+    if( parent == NULL ) {
+        bst->root = node;
+    } else if( asLeft ) {
+        parent->left = node;
     } else {
-        bst->root = current;
+        parent->right = node;
+    }
+
+    // A new node only displaces a cached extreme by hanging from it on the outside
+    if( parent == NULL ) {
+        bst->minNode = node;
+        bst->maxNode = node;
+    } else if( parent == bst->minNode && asLeft ) {
+        bst->minNode = node;
+    } else if( parent == bst->maxNode && ! asLeft ) {
+        bst->maxNode = node;
+    }
+
+    if( bst->splay ) {
+        splayNode( bst, node );
+    } else if( bst->treap ) {
+        // Rotations keep the order of the nodes, so the cached extremes are still right
+        while( node->parent && nodePriority( node ) > nodePriority( node->parent ) ) {
+            rotateUp( bst, node );
+        }
     }
+
+    return node;
 }
 
 /*
  * Attempts to find the desired element from the tree. If the element cannot be found, then this
- * function will return NULL, otherwise it will return the removed element.
+ * function will return NULL, otherwise it will return the removed element. In a treap, the node is
+ * rotated down until it has a free child slot, so the other elements keep their nodes.
  *
  * Arguments:
  * bst             -- The tree to remove the element from.
@@ -122,59 +338,176 @@ void bstInsert( BST *bst, void *elementToInsert ) {
  * The element that was removed, or NULL if the element could not be found.
  */
 void *bstRemove( BST *bst, void *elementToRemove ) {
-    void *removed = removeHelper( bst, bst->root, elementToRemove );
+    if( bst->splay ) {
+        // Bringing the element to the root leaves the removal below only its successor to find
+        bstFind( bst, elementToRemove );
+    }
 
-    if( removed ) {
-        bst->size -= 1;
+    BSTNode *node = bst->root;
+    ComparisonFunction compare = bst->comparisonFunction;
+
+    while( node != NULL ) {
+        int comparisonResult = compare( elementToRemove, node->data );
+
+        if( comparisonResult == 0 ) {
+            break;
+        }
+
+        node = comparisonResult < 0 ? node->left : node->right;
     }
 
-    return removed;
+    if( node == NULL ) {
+        return NULL;
+    }
+
+    return removeTreeNode( bst, node );
 }
 
 /*
- * Helper function for node deletion in the binary search tree
+ * Removes a node from the tree, keeping the cached extremes up to date.
  *
  * Arguments:
- * node -- The node that is being removed from the tree
+ * bst  -- The tree containing the node
+ * node -- The node being removed
  *
  * Returns:
- * The element that was removed, or NULL if the element could not be found.
+ * The element that the node held
  */
-void *removeHelper( BST *bst, BSTNode *node, void *data ) {
-    void *removed = NULL;
-    if( bst && node ) {
-        int comparisonResult = bst->comparisonFunction( data, node->data );
+void *removeTreeNode( BST *bst, BSTNode *node ) {
+    void *removed = node->data;
 
-        if( comparisonResult < 0 ) {
-            removed = removeHelper( bst, node->left, data );
-        } else if( comparisonResult > 0 ) {
-            removed = removeHelper( bst, node->right, data );
-        } else {
-            removed = node->data;
-            BSTNode *left = node->left;
-            BSTNode *right = node->right;
-
-            if( left && right ) {
-                // Node with both children
-                BSTNode *successorNode = successor( node );
-                node->data = successorNode->data;
-                removeHelper( bst, successorNode, successorNode->data );
-            } else if( left ) {
-                // Node with only a left child
-                replaceNodeInParent(bst, node, left);
-            } else if( right ) {
-                // Node with only a right child
-                replaceNodeInParent(bst, node, right);
-            } else {
-                // Node with no children
-                replaceNodeInParent( bst, node, NULL );
-            }
+    if( bst->treap ) {
+        // Rotating the higher priority child above the node keeps the heap ordering, and the node
+        // sinks until one of its child slots is free
+        while( node->left && node->right ) {
+            rotateUp( bst, nodePriority( node->left ) > nodePriority( node->right ) ? node->left :
+                    node->right );
         }
+    } else if( node->left && node->right ) {
+        // A node with both children takes its successor's data, and the successor is removed
+        // instead. The successor has no left child, so it is unlinked like any other node.
+        BSTNode *successorNode = successor( node );
+        node->data = successorNode->data;
+        node = successorNode;
+    }
+
+    // The extremes have at most one child, so their neighbours are below that child or the parent
+    if( node == bst->minNode ) {
+        bst->minNode = node->right ? leftmostNode( node->right ) : node->parent;
+    }
+
+    if( node == bst->maxNode ) {
+        bst->maxNode = node->left ? rightmostNode( node->left ) : node->parent;
+    }
+
+    replaceNodeInParent( bst, node, node->left ? node->left : node->right );
+    if( bst->size != BST_SIZE_UNKNOWN ) {
+        bst->size -= 1;
     }
 
     return removed;
 }
 
+/*
+ * Gets the smallest element of the tree. This takes O(1) time while the cached leftmost node is
+ * valid, and time proportional to the height of the tree when it has to be found again.
+ *
+ * Arguments:
+ * bst -- The tree to search
+ *
+ * Returns:
+ * The smallest element in the tree, or NULL if the tree is empty
+ */
+void *bstMin( BST *bst ) {
+    BSTNode *node = minimumNode( bst );
+
+    return node ? node->data : NULL;
+}
+
+/*
+ * Gets the largest element of the tree. This takes O(1) time while the cached rightmost node is
+ * valid, and time proportional to the height of the tree when it has to be found again.
+ *
+ * Arguments:
+ * bst -- The tree to search
+ *
+ * Returns:
+ * The largest element in the tree, or NULL if the tree is empty
+ */
+void *bstMax( BST *bst ) {
+    BSTNode *node = maximumNode( bst );
+
+    return node ? node->data : NULL;
+}
+
+/*
+ * Removes the smallest element from the tree. The leftmost node never has a left child, so it is
+ * unlinked without a search, and the next smallest node is found by walking from it. Popping every
+ * element in turn takes amortized O(1) time per element. Splay trees are not splayed by this.
+ *
+ * Arguments:
+ * bst -- The tree to remove the element from
+ *
+ * Returns:
+ * The element that was removed, or NULL if the tree is empty
+ */
+void *bstPopMin( BST *bst ) {
+    BSTNode *node = minimumNode( bst );
+
+    return node ? removeTreeNode( bst, node ) : NULL;
+}
+
+/*
+ * Removes the largest element from the tree. The rightmost node never has a right child, so it is
+ * unlinked without a search, and the next largest node is found by walking from it. Popping every
+ * element in turn takes amortized O(1) time per element. Splay trees are not splayed by this.
+ *
+ * Arguments:
+ * bst -- The tree to remove the element from
+ *
+ * Returns:
+ * The element that was removed, or NULL if the tree is empty
+ */
+void *bstPopMax( BST *bst ) {
+    BSTNode *node = maximumNode( bst );
+
+    return node ? removeTreeNode( bst, node ) : NULL;
+}
+
+/*
+ * Gets the leftmost node of the tree, finding it again if it isn't cached.
+ *
+ * Arguments:
+ * bst -- The tree to search
+ *
+ * Returns:
+ * The leftmost node, or NULL if the tree is empty
+ */
+BSTNode *minimumNode( BST *bst ) {
+    if( bst->minNode == NULL ) {
+        bst->minNode = leftmostNode( bst->root );
+    }
+
+    return bst->minNode;
+}
+
+/*
+ * Gets the rightmost node of the tree, finding it again if it isn't cached.
+ *
+ * Arguments:
+ * bst -- The tree to search
+ *
+ * Returns:
+ * The rightmost node, or NULL if the tree is empty
+ */
+BSTNode *maximumNode( BST *bst ) {
+    if( bst->maxNode == NULL ) {
+        bst->maxNode = rightmostNode( bst->root );
+    }
+
+    return bst->maxNode;
+}
+
 /*
  * Replaces a node inside its parent with a replacement
  *
@@ -288,140 +621,1172 @@ BSTNode *predecessor( BSTNode *node ) {
  */
 void *bstFind( BST *bst, void *element ) {
     BSTNode *current = bst->root;
+    BSTNode *last = NULL;
     ComparisonFunction compare = bst->comparisonFunction;
 
     while( current != NULL ) {
         int comparisonResult = compare( element, current->data );
 
         if( comparisonResult == 0 ) {
+            if( bst->splay ) {
+                splayNode( bst, current );
+            }
+
             return current->data;
-        } else if( comparisonResult < 0 ) {
+        }
+
+        last = current;
+        if( comparisonResult < 0 ) {
             current = current->left;
         } else {
             current = current->right;
         }
     }
 
+    // Splaying the last node on the path keeps unsuccessful searches amortized too
+    if( bst->splay && last != NULL ) {
+        splayNode( bst, last );
+    }
+
     return NULL;
 }
 
 /*
- * Performs a pre-order traversal and executes the consumer function on each node in the traversal.
- * In a pre-order traversal, at each node, the node will be supplied to the consumer, then the
- * traversal will be recursively called on the left child and then the right child.
+ * Rotates a node above its parent, preserving the ordering of the tree and every parent pointer.
  *
  * Arguments:
- * bst      -- The binary search tree that the pre-order traversal is being performed on
- * consumer -- The function that is applied to every node along the traversal
+ * bst  -- The tree containing the node
+ * node -- The node being rotated upwards, which must have a parent
  */
-void bstPreOrder( BST *bst, BSTNodeConsumer consumer ) {
-    preOrderHelper( bst->root, consumer );
+void rotateUp( BST *bst, BSTNode *node ) {
+    BSTNode *parent = node->parent;
+    BSTNode *grandparent = parent->parent;
+
+    if( parent->left == node ) {
+        setLeft( parent, node->right );
+        setRight( node, parent );
+    } else {
+        setRight( parent, node->left );
+        setLeft( node, parent );
+    }
+
+    node->parent = grandparent;
+    if( grandparent == NULL ) {
+        bst->root = node;
+    } else if( grandparent->left == parent ) {
+        grandparent->left = node;
+    } else {
+        grandparent->right = node;
+    }
 }
 
 /*
- * Helper function for pre-order binary search tree traversals
+ * Moves a node to the root of the tree with bottom-up splaying. When the node and its parent are
+ * on the same side of their parents (zig-zig), the parent is rotated first, which roughly halves
+ * the depth of every node along the path. Otherwise (zig-zag) the node is rotated twice.
  *
  * Arguments:
- * node     -- The node currently being traversed
- * consumer -- The function to apply to each node along the traversal
+ * bst  -- The tree containing the node
+ * node -- The node to move to the root
  */
-void preOrderHelper(BSTNode *node, BSTNodeConsumer consumer ) {
-    if( node != NULL ) {
-        consumer( node );
-        preOrderHelper( node->left, consumer );
-        preOrderHelper( node->right, consumer );
+void splayNode( BST *bst, BSTNode *node ) {
+    // Splaying ignores the priorities, so the tree is no longer a treap
+    if( node->parent != NULL ) {
+        bst->treap = false;
+    }
+
+    while( node->parent != NULL ) {
+        BSTNode *parent = node->parent;
+        BSTNode *grandparent = parent->parent;
+
+        if( grandparent == NULL ) {
+            rotateUp( bst, node );
+        } else if( (grandparent->left == parent) == (parent->left == node) ) {
+            rotateUp( bst, parent );
+            rotateUp( bst, node );
+        } else {
+            rotateUp( bst, node );
+            rotateUp( bst, node );
+        }
     }
 }
 
 /*
- * Performs an in-order traversal and executes the consumer function on each node in the traversal.
- * In an in-order traversal, at each node, we will recurse on the left child, then we will apply
- * the consumer function to the current node, and then we will recurse on the right child.
+ * Searches the tree for a batch of elements at once. Up to BST_BATCH_WIDTH searches are in flight
+ * at a time and are advanced in turn, one step each, in the style of asynchronous memory access
+ * chaining. Each step prefetches the memory the search will need on its next turn, so the cache
+ * misses of different searches overlap instead of being paid one after another. Splay trees are not
+ * splayed by this search.
  *
  * Arguments:
- * bst      -- The binary search tree that the in-order traversal is being performed on
- * consumer -- The function that is applied to every node along the traversal
+ * bst     -- The binary search tree to search through
+ * keys    -- The elements being searched for
+ * numKeys -- The number of elements being searched for
+ * results -- An array that the found elements are written to. For each key, this holds the
+ *            element in the tree equivalent to it, or NULL if there was no such element.
+ *
+ * Returns:
+ * The number of keys that were found in the tree
  */
-void bstInOrder( BST *bst, BSTNodeConsumer consumer ) {
-    inOrderHelper( bst->root, consumer );
+int bstFindBatch( BST *bst, void **keys, int numKeys, void **results ) {
+    ComparisonFunction compare = bst->comparisonFunction;
+    BatchSearch searches[ BST_BATCH_WIDTH ];
+    int nextKey = 0;
+    int active = 0;
+    int found = 0;
+
+    for( int i = 0; i < BST_BATCH_WIDTH; i++ ) {
+        active += startBatchSearch( bst, &searches[i], &nextKey, numKeys );
+    }
+
+    while( active > 0 ) {
+        for( int i = 0; i < BST_BATCH_WIDTH; i++ ) {
+            BatchSearch *search = &searches[i];
+
+            if( search->keyIndex < 0 ) {
+                continue;
+            }
+
+            if( search->node == NULL ) {
+                // The search fell off the tree
+                results[ search->keyIndex ] = NULL;
+                active -= ! startBatchSearch( bst, search, &nextKey, numKeys );
+            } else if( search->stage == BATCH_LOAD_ELEMENT ) {
+                // The node was prefetched on the last turn, so reading the element is cheap
+                PREFETCH( search->node->data );
+                search->stage = BATCH_COMPARE;
+            } else {
+                void *data = search->node->data;
+                int comparisonResult = compare( keys[ search->keyIndex ], data );
+
+                if( comparisonResult == 0 ) {
+                    results[ search->keyIndex ] = data;
+                    found++;
+                    active -= ! startBatchSearch( bst, search, &nextKey, numKeys );
+                } else {
+                    search->node = comparisonResult < 0 ? search->node->left : search->node->right;
+                    search->stage = BATCH_LOAD_ELEMENT;
+
+                    if( search->node ) {
+                        PREFETCH( search->node );
+                    }
+                }
+            }
+        }
+    }
+
+    return found;
 }
 
 /*
- * Helper function for in-order binary search tree traversals
+ * Points a bstFindBatch search slot at the next key that hasn't been searched for yet, and
+ * prefetches the root for it.
  *
  * Arguments:
- * node     -- The node currently being traversed
- * consumer -- The function to apply to each node along the traversal
+ * bst     -- The tree being searched
+ * search  -- The slot to reuse
+ * nextKey -- The index of the next key to search for, which is advanced
+ * numKeys -- The number of keys in the batch
+ *
+ * Returns:
+ * 1 if the slot was given a key, 0 if there were no keys left
  */
-void inOrderHelper(BSTNode *node, BSTNodeConsumer consumer ) {
-    if( node != NULL ) {
-        inOrderHelper( node->left, consumer );
-        consumer(node);
-        inOrderHelper( node->left, consumer );
+int startBatchSearch( BST *bst, BatchSearch *search, int *nextKey, int numKeys ) {
+    if( *nextKey >= numKeys ) {
+        search->keyIndex = -1;
+        return 0;
+    }
+
+    search->keyIndex = *nextKey;
+    search->node = bst->root;
+    search->stage = BATCH_LOAD_ELEMENT;
+    *nextKey += 1;
+
+    if( search->node ) {
+        PREFETCH( search->node );
     }
+
+    return 1;
 }
 
 /*
- * Performs a post-order traversal and executes the consumer function on each node in the traversal.
- * In a post-order traversal, at each node, the node will be supplied to the consumer, then the
- * traversal will be recursively called on the right child and then the left child.
+ * Performs a pre-order traversal and executes the consumer function on each node in the traversal.
+ * In a pre-order traversal, at each node, the node will be supplied to the consumer, then the
+ * traversal will be recursively called on the left child and then the right child.
  *
  * Arguments:
- * bst      -- The binary search tree that the post-order traversal is being performed on
+ * bst      -- The binary search tree that the pre-order traversal is being performed on
  * consumer -- The function that is applied to every node along the traversal
  */
-void bstPostOrder( BST *bst, BSTNodeConsumer consumer ) {
-    postOrderHelper( bst->root, consumer );
+void bstPreOrder( BST *bst, BSTNodeConsumer consumer ) {
+    walkNodes( bst->root, PRE_ORDER, consumer );
 }
 
 /*
- * Helper function for post-order binary search tree traversals
+ * Performs an in-order traversal and executes the consumer function on each node in the traversal.
+ * In an in-order traversal, at each node, we will recurse on the left child, then we will apply
+ * the consumer function to the current node, and then we will recurse on the right child.
  *
  * Arguments:
- * node     -- The node currently being traversed
- * consumer -- The function to apply to each node along the traversal
+ * bst      -- The binary search tree that the in-order traversal is being performed on
+ * consumer -- The function that is applied to every node along the traversal
  */
-void postOrderHelper(BSTNode *node, BSTNodeConsumer consumer ) {
-    if( node != NULL ) {
-        postOrderHelper( node->left, consumer );
-        postOrderHelper( node->right, consumer );
-        consumer( node );
-    }
+void bstInOrder( BST *bst, BSTNodeConsumer consumer ) {
+    walkNodes( bst->root, IN_ORDER, consumer );
 }
 
 /*
- * Creates and returns an array of the elements within this binary search tree. The items inside the
- * array will be in-order.
+ * Performs a post-order traversal and executes the consumer function on each node in the traversal.
+ * In a post-order traversal, at each node, the traversal will visit the left child and then the
+ * right child, and then the node will be supplied to the consumer.
  *
  * Arguments:
- * bst -- The binary search tree whose elements are being copied into an array.
- *
- * Returns:
- * An array containing data from the binary search tree.
+ * bst      -- The binary search tree that the post-order traversal is being performed on
+ * consumer -- The function that is applied to every node along the traversal
  */
-void **bstElements( BST *bst ) {
-    void **elements = calloc( bst->size, sizeof(void *) );
-    int *index = malloc( sizeof(int) );
-    *index = 0;
-    bstElementsHelper( bst->root, elements, index );
-    free( index );
-    return elements;
+void bstPostOrder( BST *bst, BSTNodeConsumer consumer ) {
+    walkNodes( bst->root, POST_ORDER, consumer );
 }
 
 /*
- * Recursively traverses the subtrees of the current node, copies the data in each node, and adds
- * them to the vector.
+ * Visits every node of a subtree in the requested order without recursion or a stack. The walk
+ * follows child and parent pointers and uses the node it just left to tell whether it is arriving
+ * from the parent, returning from the left child, or returning from the right child. The parent of
+ * a node is read before the node is supplied to a post-order consumer, so the consumer may free it.
  *
  * Arguments:
- * current -- The node that is being traversed
- * vector  -- The vector that elements are being added to
+ * root     -- The root of the subtree being walked
+ * order    -- The order in which nodes are supplied to the consumer
+ * consumer -- The function to apply to each node along the walk
  */
-void bstElementsHelper( BSTNode *current, void **elements, int *index ) {
-    if( current ) {
-        bstElementsHelper( current->left, elements, index );
-        elements[ *index ] = current->data;
-        *index += 1;
-        bstElementsHelper( current->right, elements, index );
+void walkNodes( BSTNode *root, TraversalOrder order, BSTNodeConsumer consumer ) {
+    BSTNode *current = root;
+    BSTNode *previous = root ? root->parent : NULL;
+
+    while( current != NULL ) {
+        BSTNode *parent = current->parent;
+        BSTNode *next = parent;
+
+        if( previous == parent ) {
+            // Arriving at this node for the first time
+            if( order == PRE_ORDER ) {
+                consumer( current );
+            }
+
+            if( current->left ) {
+                next = current->left;
+            } else {
+                if( order == IN_ORDER ) {
+                    consumer( current );
+                }
+
+                if( current->right ) {
+                    next = current->right;
+                }
+            }
+        } else if( previous == current->left ) {
+            if( order == IN_ORDER ) {
+                consumer( current );
+            }
+
+            if( current->right ) {
+                next = current->right;
+            }
+        }
+
+        bool leaving = next == parent;
+        bool finished = leaving && current == root;
+
+        if( leaving && order == POST_ORDER ) {
+            consumer( current );
+        }
+
+        previous = current;
+        current = finished ? NULL : next;
+    }
+}
+
+/*
+ * Finds the node holding the smallest element of a subtree.
+ *
+ * Arguments:
+ * node -- The root of the subtree, which may be NULL
+ *
+ * Returns:
+ * The leftmost node of the subtree, or NULL if it is empty
+ */
+BSTNode *leftmostNode( BSTNode *node ) {
+    while( node != NULL && node->left != NULL ) {
+        node = node->left;
+    }
+
+    return node;
+}
+
+/*
+ * Finds the node holding the largest element of a subtree.
+ *
+ * Arguments:
+ * node -- The root of the subtree, which may be NULL
+ *
+ * Returns:
+ * The rightmost node of the subtree, or NULL if it is empty
+ */
+BSTNode *rightmostNode( BSTNode *node ) {
+    while( node != NULL && node->right != NULL ) {
+        node = node->right;
+    }
+
+    return node;
+}
+
+/*
+ * Creates and returns an array of the elements within this binary search tree. The items inside the
+ * array will be in-order.
+ *
+ * Arguments:
+ * bst -- The binary search tree whose elements are being copied into an array.
+ *
+ * Returns:
+ * An array containing data from the binary search tree.
+ */
+void **bstElements( BST *bst ) {
+    void **elements = calloc( bstSize( bst ), sizeof(void *) );
+    int index = 0;
+
+    for( BSTNode *node = leftmostNode( bst->root ); node != NULL; node = successor( node ) ) {
+        elements[ index++ ] = node->data;
+    }
+
+    return elements;
+}
+
+/*
+ * Gets the number of elements in the tree, counting them if the size isn't known because the tree
+ * was split off another tree. Counting takes O(n) time, and the count is kept for later calls.
+ *
+ * Arguments:
+ * bst -- The tree whose elements are being counted
+ *
+ * Returns:
+ * The number of elements in the tree
+ */
+int bstSize( BST *bst ) {
+    if( bst->size == BST_SIZE_UNKNOWN ) {
+        bst->size = countNodes( bst->root );
+    }
+
+    return bst->size;
+}
+
+/*
+ * Computes the height of the tree, which is the number of nodes on its longest path from the root
+ * to a leaf. The tree is walked through its parent pointers, so this uses O(1) space even when the
+ * tree has degenerated into a list.
+ *
+ * Arguments:
+ * bst -- The tree whose height is being computed
+ *
+ * Returns:
+ * The height of the tree, or 0 if it is empty
+ */
+int bstHeight( BST *bst ) {
+    BSTShapeStats stats;
+    bstShapeStats( bst, &stats );
+
+    return stats.height;
+}
+
+/*
+ * Computes the size, height, and average node depth of the tree in O(n) time and O(1) space. The
+ * walk remembers the node it came from to decide whether it is descending into a node or returning
+ * from one of its children, so it needs no stack.
+ *
+ * Arguments:
+ * bst   -- The tree whose shape is being measured
+ * stats -- The statistics that are filled in
+ */
+void bstShapeStats( BST *bst, BSTShapeStats *stats ) {
+    BSTNode *current = bst->root;
+    BSTNode *previous = NULL;
+    long totalDepth = 0;
+    int depth = 1;
+
+    stats->size = 0;
+    stats->height = 0;
+
+    while( current != NULL ) {
+        BSTNode *next;
+
+        if( previous == current->parent ) {
+            // Arriving at this node for the first time
+            stats->size += 1;
+            totalDepth += depth;
+            if( depth > stats->height ) {
+                stats->height = depth;
+            }
+
+            next = current->left ? current->left : current->right ? current->right
+                : current->parent;
+        } else if( previous == current->left && current->right != NULL ) {
+            next = current->right;
+        } else {
+            next = current->parent;
+        }
+
+        depth += next == current->parent ? -1 : 1;
+        previous = current;
+        current = next;
+    }
+
+    stats->averageDepth = stats->size > 0 ? (double) totalDepth / stats->size : 0;
+}
+
+/*
+ * Rebalances the tree in place with the Day-Stout-Warren algorithm. The tree is first rotated into
+ * a sorted vine of right children and then compressed into a tree where every level except the
+ * last is full. This takes O(n) time and O(1) extra space, and no nodes are allocated or freed.
+ *
+ * Arguments:
+ * bst -- The tree to rebalance
+ */
+void bstRebalance( BST *bst ) {
+    int size = bstSize( bst );
+
+    // A node on the stack stands in above the root so the root can be rotated like any other node
+    BSTNode pseudoRoot = { NULL, NULL, NULL, NULL };
+    setRight( &pseudoRoot, bst->root );
+
+    treeToVine( &pseudoRoot );
+
+    // Fill the bottom level first so that every compression afterwards halves a perfect vine
+    int perfectSize = 1;
+    while( perfectSize * 2 + 1 <= size ) {
+        perfectSize = perfectSize * 2 + 1;
+    }
+
+    compressVine( &pseudoRoot, size - perfectSize );
+    for( size = perfectSize; size > 1; size /= 2 ) {
+        compressVine( &pseudoRoot, size / 2 );
+    }
+
+    bst->root = pseudoRoot.right;
+    bst->treap = bst->size <= 1;
+    if( bst->root ) {
+        bst->root->parent = NULL;
+    }
+}
+
+/*
+ * Rotates every left child in the tree below the pseudo root up to the right, which leaves the
+ * nodes in a sorted chain of right children.
+ *
+ * Arguments:
+ * pseudoRoot -- A node whose right child is the root of the tree
+ */
+void treeToVine( BSTNode *pseudoRoot ) {
+    BSTNode *tail = pseudoRoot;
+    BSTNode *rest = tail->right;
+
+    while( rest != NULL ) {
+        if( rest->left == NULL ) {
+            tail = rest;
+            rest = rest->right;
+        } else {
+            BSTNode *left = rest->left;
+            setLeft( rest, left->right );
+            setRight( left, rest );
+            setRight( tail, left );
+            rest = left;
+        }
+    }
+}
+
+/*
+ * Performs left rotations on every other node along the vine, starting at the top, which moves
+ * each rotated node's right child above it.
+ *
+ * Arguments:
+ * pseudoRoot -- A node whose right child is the top of the vine
+ * count      -- The number of rotations to perform
+ */
+void compressVine( BSTNode *pseudoRoot, int count ) {
+    BSTNode *scanner = pseudoRoot;
+
+    for( int i = 0; i < count; i++ ) {
+        BSTNode *child = scanner->right;
+        setRight( scanner, child->right );
+        scanner = scanner->right;
+        setRight( child, scanner->left );
+        setLeft( scanner, child );
+    }
+}
+
+/*
+ * Creates a perfectly balanced binary search tree from an array of elements in O(n) time. The
+ * elements must already be sorted according to the comparison function and contain no duplicates.
+ *
+ * Arguments:
+ * comparisonFunction -- The function that will be used to order elements in the tree
+ * elements           -- The sorted elements to place in the tree
+ * numElements        -- The number of elements in the array
+ *
+ * Returns:
+ * A binary search tree containing the elements, or NULL if the comparison function is NULL
+ */
+BST *bstFromSortedArray( ComparisonFunction comparisonFunction, void **elements,
+        int numElements ) {
+    BST *bst = newBST( comparisonFunction );
+
+    if( bst != NULL ) {
+        bst->root = buildBalanced( elements, 0, numElements, NULL );
+        bst->size = numElements;
+        bst->treap = numElements <= 1;
+    }
+
+    return bst;
+}
+
+/*
+ * Recursively builds a balanced subtree whose root is the middle element of [start, end).
+ *
+ * Arguments:
+ * elements -- The sorted elements being placed in the tree
+ * start    -- The first index of the subtree's elements
+ * end      -- One past the last index of the subtree's elements
+ * parent   -- The node that the subtree will hang from
+ *
+ * Returns:
+ * The root of the subtree, or NULL if the range is empty
+ */
+BSTNode *buildBalanced( void **elements, int start, int end, BSTNode *parent ) {
+    if( start >= end ) {
+        return NULL;
+    }
+
+    int middle = start + (end - start) / 2;
+    BSTNode *node = newNode( elements[middle], parent, NULL, NULL );
+    node->left = buildBalanced( elements, start, middle, node );
+    node->right = buildBalanced( elements, middle + 1, end, node );
+
+    return node;
+}
+
+/*
+ * Creates a copy of the tree's structure. The copy shares its elements with the original tree.
+ *
+ * Arguments:
+ * bst -- The tree to copy
+ *
+ * Returns:
+ * A new tree with the same shape and elements as the original
+ */
+BST *bstCopy( BST *bst ) {
+    BST *copy = newBST( bst->comparisonFunction );
+    copy->root = copyNodes( bst->root );
+    copy->size = bstSize( bst );
+    copy->splay = bst->splay;
+
+    // The copied nodes have new addresses, and so new priorities
+    copy->treap = copy->size <= 1;
+
+    return copy;
+}
+
+/*
+ * Copies a subtree. The copy is built alongside a walk of the original through its parent
+ * pointers, so no recursion is needed.
+ *
+ * Arguments:
+ * root -- The root of the subtree to copy
+ *
+ * Returns:
+ * The root of the copied subtree, which has no parent
+ */
+BSTNode *copyNodes( BSTNode *root ) {
+    if( root == NULL ) {
+        return NULL;
+    }
+
+    BSTNode *copyRoot = newNode( root->data, NULL, NULL, NULL );
+    BSTNode *copy = copyRoot;
+    BSTNode *current = root;
+    BSTNode *previous = root->parent;
+
+    while( true ) {
+        BSTNode *next;
+        bool arrived = previous == current->parent;
+
+        if( arrived && current->left ) {
+            next = current->left;
+            copy->left = newNode( next->data, copy, NULL, NULL );
+            copy = copy->left;
+        } else if( (arrived || previous == current->left) && current->right ) {
+            next = current->right;
+            copy->right = newNode( next->data, copy, NULL, NULL );
+            copy = copy->right;
+        } else if( current == root ) {
+            break;
+        } else {
+            next = current->parent;
+            copy = copy->parent;
+        }
+
+        previous = current;
+        current = next;
+    }
+
+    return copyRoot;
+}
+
+/*
+ * Counts the nodes in a subtree by walking it in order.
+ *
+ * Arguments:
+ * node -- The root of the subtree, which must have no parent
+ *
+ * Returns:
+ * The number of nodes in the subtree
+ */
+int countNodes( BSTNode *node ) {
+    int count = 0;
+
+    for( node = leftmostNode( node ); node != NULL; node = successor( node ) ) {
+        count++;
+    }
+
+    return count;
+}
+
+/*
+ * Derives a node's treap priority by mixing the bits of its address, which behaves like a random
+ * priority that is fixed for the lifetime of the node.
+ *
+ * Arguments:
+ * node -- The node whose priority is being computed
+ *
+ * Returns:
+ * The node's priority
+ */
+uint64_t nodePriority( BSTNode *node ) {
+    return mixHash( (uint64_t) (uintptr_t) node );
+}
+
+/*
+ * Sets the left child of a node and the child's parent pointer.
+ *
+ * Arguments:
+ * node  -- The node whose left child is being set
+ * child -- The new left child, which may be NULL
+ */
+void setLeft( BSTNode *node, BSTNode *child ) {
+    node->left = child;
+
+    if( child ) {
+        child->parent = node;
+    }
+}
+
+/*
+ * Sets the right child of a node and the child's parent pointer.
+ *
+ * Arguments:
+ * node  -- The node whose right child is being set
+ * child -- The new right child, which may be NULL
+ */
+void setRight( BSTNode *node, BSTNode *child ) {
+    node->right = child;
+
+    if( child ) {
+        child->parent = node;
+    }
+}
+
+/*
+ * Splits a subtree around a key by walking down the path to it, which takes time proportional to
+ * the height of the subtree. Because only that path is cut apart, the heap ordering of the
+ * priorities is preserved in both halves. The parents of the returned roots are not modified.
+ *
+ * Arguments:
+ * root    -- The root of the subtree to split
+ * key     -- The key to split the subtree around
+ * compare -- The function used to order the elements
+ * less    -- Set to the root of the elements less than the key
+ * greater -- Set to the root of the elements greater than the key
+ *
+ * Returns:
+ * The detached node equivalent to the key, or NULL if there was no such node
+ */
+BSTNode *splitNodes( BSTNode *root, void *key, ComparisonFunction compare, BSTNode **less,
+        BSTNode **greater ) {
+    // The lesser pieces hang off the right of the last lesser node found on the path, and the
+    // greater pieces off the left of the last greater node
+    BSTNode *lessTail = NULL;
+    BSTNode *greaterTail = NULL;
+    BSTNode *found = NULL;
+
+    *less = NULL;
+    *greater = NULL;
+
+    while( root != NULL ) {
+        int comparisonResult = compare( key, root->data );
+
+        if( comparisonResult == 0 ) {
+            found = root;
+            break;
+        }
+
+        BSTNode *next = NULL;
+
+        if( comparisonResult < 0 ) {
+            next = root->left;
+            hangNode( greater, greaterTail, true, root );
+            greaterTail = root;
+        } else {
+            next = root->right;
+            hangNode( less, lessTail, false, root );
+            lessTail = root;
+        }
+
+        root = next;
+    }
+
+    BSTNode *lesser = found ? found->left : NULL;
+    BSTNode *larger = found ? found->right : NULL;
+
+    if( found ) {
+        found->left = NULL;
+        found->right = NULL;
+    }
+
+    hangNode( less, lessTail, false, lesser );
+    hangNode( greater, greaterTail, true, larger );
+
+    return found;
+}
+
+/*
+ * Joins two subtrees around a middle node. The middle node is placed as deep as its priority
+ * allows, so that the priorities stay heap ordered. The walk down follows the inner spines of the
+ * two subtrees, so it takes time proportional to their heights.
+ *
+ * Arguments:
+ * less    -- The root of the subtree of lesser elements
+ * middle  -- A detached node whose element lies between the two subtrees
+ * greater -- The root of the subtree of greater elements
+ *
+ * Returns:
+ * The root of the joined subtree
+ */
+BSTNode *joinNodes( BSTNode *less, BSTNode *middle, BSTNode *greater ) {
+    uint64_t priority = nodePriority( middle );
+    BSTNode *root = NULL;
+    BSTNode *parent = NULL;
+    bool asLeft = false;
+
+    while( true ) {
+        uint64_t lessPriority = less ? nodePriority( less ) : 0;
+        uint64_t greaterPriority = greater ? nodePriority( greater ) : 0;
+
+        if( priority >= lessPriority && priority >= greaterPriority ) {
+            setLeft( middle, less );
+            setRight( middle, greater );
+            hangNode( &root, parent, asLeft, middle );
+            return root;
+        } else if( lessPriority > greaterPriority ) {
+            hangNode( &root, parent, asLeft, less );
+            parent = less;
+            asLeft = false;
+            less = less->right;
+        } else {
+            hangNode( &root, parent, asLeft, greater );
+            parent = greater;
+            asLeft = true;
+            greater = greater->left;
+        }
+    }
+}
+
+/*
+ * Joins two subtrees where every element of the first is less than every element of the second.
+ * Like joinNodes, this walks down the inner spines of the two subtrees.
+ *
+ * Arguments:
+ * less    -- The root of the subtree of lesser elements
+ * greater -- The root of the subtree of greater elements
+ *
+ * Returns:
+ * The root of the joined subtree
+ */
+BSTNode *joinTwoNodes( BSTNode *less, BSTNode *greater ) {
+    BSTNode *root = NULL;
+    BSTNode *parent = NULL;
+    bool asLeft = false;
+
+    while( less != NULL && greater != NULL ) {
+        if( nodePriority( less ) > nodePriority( greater ) ) {
+            hangNode( &root, parent, asLeft, less );
+            parent = less;
+            asLeft = false;
+            less = less->right;
+        } else {
+            hangNode( &root, parent, asLeft, greater );
+            parent = greater;
+            asLeft = true;
+            greater = greater->left;
+        }
+    }
+
+    hangNode( &root, parent, asLeft, less ? less : greater );
+    return root;
+}
+
+/*
+ * Hangs a subtree from a node that is being assembled, or makes it the root if there is no node to
+ * hang it from yet. The parent of a new root is not modified.
+ *
+ * Arguments:
+ * root   -- The root of the tree being assembled
+ * parent -- The node to hang the subtree from, or NULL if the subtree becomes the root
+ * asLeft -- Whether the subtree becomes the parent's left child rather than its right child
+ * child  -- The subtree, which may be NULL
+ */
+void hangNode( BSTNode **root, BSTNode *parent, bool asLeft, BSTNode *child ) {
+    if( parent == NULL ) {
+        *root = child;
+    } else if( asLeft ) {
+        setLeft( parent, child );
+    } else {
+        setRight( parent, child );
+    }
+}
+
+/*
+ * Rebuilds a tree into a treap from its own nodes, unless it is known to be one already. The nodes
+ * are gathered in order and linked into a Cartesian tree on their priorities with a stack of the
+ * right spine built so far, which takes O(n) time and allocates no nodes. The join-based operations
+ * do this to any tree they are given that isn't a treap.
+ *
+ * Arguments:
+ * bst -- The tree to rebuild
+ */
+void bstMakeTreap( BST *bst ) {
+    if( bst->treap ) {
+        return;
+    }
+
+    int size = bstSize( bst );
+    BSTNode **nodes = malloc( sizeof(BSTNode *) * (size > 0 ? size : 1) );
+    int numNodes = 0;
+
+    for( BSTNode *node = leftmostNode( bst->root ); node != NULL; node = successor( node ) ) {
+        nodes[ numNodes++ ] = node;
+    }
+
+    // The stack never holds more nodes than have been read, so it shares the array
+    int top = 0;
+    for( int i = 0; i < numNodes; i++ ) {
+        BSTNode *node = nodes[i];
+        BSTNode *popped = NULL;
+        uint64_t priority = nodePriority( node );
+
+        while( top > 0 && nodePriority( nodes[ top - 1 ] ) < priority ) {
+            popped = nodes[ --top ];
+        }
+
+        node->left = NULL;
+        node->right = NULL;
+        setLeft( node, popped );
+
+        if( top > 0 ) {
+            setRight( nodes[ top - 1 ], node );
+        }
+
+        nodes[ top++ ] = node;
+    }
+
+    bst->root = numNodes > 0 ? nodes[0] : NULL;
+    if( bst->root ) {
+        bst->root->parent = NULL;
+    }
+
+    bst->treap = true;
+    free( nodes );
+}
+
+/*
+ * Splits a tree into the elements that are less than a key and the elements that are greater than
+ * it. The original tree is consumed and should not be used afterwards. Only the path from the root
+ * to the key is restructured, so this takes O(height) time, which is expected O(log n) on a treap.
+ * The halves are not counted: their sizes are BST_SIZE_UNKNOWN unless a half is empty, and bstSize
+ * counts them on demand. Both halves are treaps if the tree was one.
+ *
+ * Arguments:
+ * bst     -- The tree to split
+ * key     -- The key to split the tree around
+ * less    -- Set to a new tree containing the elements less than the key
+ * greater -- Set to a new tree containing the elements greater than the key
+ *
+ * Returns:
+ * The element in the tree that is equivalent to the key, or NULL if there was no such element
+ */
+void *bstSplit( BST *bst, void *key, BST **less, BST **greater ) {
+    *less = newBST( bst->comparisonFunction );
+    *greater = newBST( bst->comparisonFunction );
+    (*less)->splay = bst->splay;
+    (*greater)->splay = bst->splay;
+    (*less)->treap = bst->treap;
+    (*greater)->treap = bst->treap;
+
+    BSTNode *found = splitNodes( bst->root, key, bst->comparisonFunction, &(*less)->root,
+            &(*greater)->root );
+    void *element = NULL;
+
+    if( found ) {
+        element = found->data;
+        free( found );
+    }
+
+    if( (*less)->root ) {
+        (*less)->root->parent = NULL;
+    }
+
+    if( (*greater)->root ) {
+        (*greater)->root->parent = NULL;
+    }
+
+    // Counting the halves would take longer than the split, so only the trivial sizes are known
+    int remaining = bst->size == BST_SIZE_UNKNOWN ? BST_SIZE_UNKNOWN : bst->size - (found ? 1 : 0);
+    (*less)->size = (*less)->root ? BST_SIZE_UNKNOWN : 0;
+    (*greater)->size = (*greater)->root ? BST_SIZE_UNKNOWN : 0;
+
+    if( (*less)->root == NULL ) {
+        (*greater)->size = remaining;
+    } else if( (*greater)->root == NULL ) {
+        (*less)->size = remaining;
+    }
+
+    free( bst );
+    return element;
+}
+
+/*
+ * Joins two trees around an element. Every element in the lesser tree must be less than the
+ * element, which must be less than every element in the greater tree. Both trees are consumed and
+ * the joined tree is returned in place of the lesser tree. Its size is unknown if either tree's
+ * size was.
+ *
+ * Trees are joined as treaps, which takes time proportional to the heights of the two trees. If
+ * both trees are treaps, as those produced by the join-based operations are, then the joined tree
+ * is too, and its expected height is logarithmic in its size. Otherwise the joined tree is a valid
+ * binary search tree but may be as tall as the two trees put together.
+ *
+ * Arguments:
+ * less    -- The tree containing the lesser elements
+ * element -- The element to place between the trees. If this is NULL, the trees are joined
+ *            directly.
+ * greater -- The tree containing the greater elements
+ *
+ * Returns:
+ * The joined tree
+ */
+BST *bstJoin( BST *less, void *element, BST *greater ) {
+    if( less->size == BST_SIZE_UNKNOWN || greater->size == BST_SIZE_UNKNOWN ) {
+        less->size = BST_SIZE_UNKNOWN;
+    } else {
+        less->size += greater->size + (element ? 1 : 0);
+    }
+
+    if( element ) {
+        less->root = joinNodes( less->root, newNode( element, NULL, NULL, NULL ), greater->root );
+    } else {
+        less->root = joinTwoNodes( less->root, greater->root );
+    }
+
+    less->minNode = NULL;
+    less->maxNode = NULL;
+    less->treap = less->treap && greater->treap;
+
+    if( less->root ) {
+        less->root->parent = NULL;
+    }
+
+    free( greater );
+
+    return less;
+}
+
+/*
+ * Computes the union of two trees using the join-based divide and conquer algorithm of Blelloch et
+ * al. On treaps, which bstInsert and bstRemove maintain, this takes O(m log(n/m + 1)) expected
+ * work, where m is the size of the smaller tree, and the two halves of every split are processed
+ * in parallel. A tree that isn't a treap, such as a splay tree or a copy, is first rebuilt into one
+ * from its own nodes in O(n) time. The result is a treap, and its size is unknown if the size of
+ * either tree was. Both trees are consumed. Where both trees contain equivalent elements, the
+ * element from the first tree is kept and the other is not freed.
+ *
+ * Arguments:
+ * a    -- The first tree
+ * b    -- The second tree, which must use an equivalent comparison function
+ * pool -- The pool used to process subtrees in parallel, or NULL to run sequentially
+ *
+ * Returns:
+ * A tree containing every element from either tree, which reuses the first tree's structure
+ */
+BST *bstUnion( BST *a, BST *b, ThreadPool *pool ) {
+    return treeOperation( TREE_UNION, a, b, pool );
+}
+
+/*
+ * Computes the intersection of two trees using the join-based divide and conquer algorithm. The
+ * work is bounded as in bstUnion, with the same rebuild of trees that aren't treaps, and the result
+ * is a treap. Both trees are consumed. Elements that are not kept are not freed, but the nodes that
+ * held them are, which takes time proportional to their number.
+ *
+ * Arguments:
+ * a    -- The first tree. Elements in the result come from this tree.
+ * b    -- The second tree, which must use an equivalent comparison function
+ * pool -- The pool used to process subtrees in parallel, or NULL to run sequentially
+ *
+ * Returns:
+ * A tree containing the elements present in both trees, which reuses the first tree's structure
+ */
+BST *bstIntersect( BST *a, BST *b, ThreadPool *pool ) {
+    return treeOperation( TREE_INTERSECT, a, b, pool );
+}
+
+/*
+ * Computes the elements of the first tree that are not in the second tree, using the join-based
+ * divide and conquer algorithm. The work is bounded as in bstUnion, with the same rebuild of trees
+ * that aren't treaps, and the result is a treap. Its size is unknown if the first tree's was. Both
+ * trees are consumed. Elements that are not kept are not freed, but the nodes that held them are.
+ *
+ * Arguments:
+ * a    -- The tree whose elements are kept
+ * b    -- The tree whose elements are removed, which must use an equivalent comparison function
+ * pool -- The pool used to process subtrees in parallel, or NULL to run sequentially
+ *
+ * Returns:
+ * A tree containing the elements of a that are not in b, which reuses the first tree's structure
+ */
+BST *bstDifference( BST *a, BST *b, ThreadPool *pool ) {
+    return treeOperation( TREE_DIFFERENCE, a, b, pool );
+}
+
+/*
+ * Runs a join-based operation on two trees and works out the size of the result from the number of
+ * elements that the trees had in common.
+ *
+ * Arguments:
+ * operation -- The operation to run
+ * a         -- The first tree, whose structure holds the result
+ * b         -- The second tree, which is freed
+ * pool      -- The pool used to process subtrees in parallel, or NULL to run sequentially
+ *
+ * Returns:
+ * The first tree, now holding the result
+ */
+BST *treeOperation( TreeOperation operation, BST *a, BST *b, ThreadPool *pool ) {
+    // The recursion follows the second tree's shape and the splits follow the first's, so both
+    // need the logarithmic height of a treap. Trees kept up by bstInsert and bstRemove already are.
+    bstMakeTreap( a );
+    bstMakeTreap( b );
+
+    TreeOperationTask task = { operation, pool, a->comparisonFunction, 0, a->root, b->root, NULL,
+        0 };
+    runTreeOperation( &task );
+
+    a->root = task.result;
+    a->minNode = NULL;
+    a->maxNode = NULL;
+    a->treap = true;
+    if( a->root ) {
+        a->root->parent = NULL;
+    }
+
+    if( operation == TREE_INTERSECT ) {
+        a->size = task.matches;
+    } else if( a->size != BST_SIZE_UNKNOWN && operation == TREE_DIFFERENCE ) {
+        a->size = a->size - task.matches;
+    } else if( a->size != BST_SIZE_UNKNOWN && b->size != BST_SIZE_UNKNOWN ) {
+        a->size = a->size + b->size - task.matches;
+    } else {
+        // Counting the result would cost more than the operation itself
+        a->size = BST_SIZE_UNKNOWN;
+    }
+
+    free( b );
+    return a;
+}
+
+/*
+ * Solves one subproblem of a join-based operation. The first subtree is split around the root of
+ * the second, the operation is applied to the matching halves, and the results are joined back
+ * together. Near the top of the recursion, the lesser halves are spawned onto the pool.
+ *
+ * Arguments:
+ * argument -- The TreeOperationTask describing the subproblem
+ */
+void runTreeOperation( void *argument ) {
+    TreeOperationTask *task = argument;
+    BSTNode *a = task->a;
+    BSTNode *b = task->b;
+
+    if( a == NULL || b == NULL ) {
+        if( task->operation == TREE_UNION ) {
+            task->result = a ? a : b;
+        } else if( task->operation == TREE_INTERSECT ) {
+            walkNodes( a, POST_ORDER, freeNodeStructure );
+            walkNodes( b, POST_ORDER, freeNodeStructure );
+            task->result = NULL;
+        } else {
+            walkNodes( b, POST_ORDER, freeNodeStructure );
+            task->result = a;
+        }
+
+        task->matches = 0;
+        return;
+    }
+
+    // Split the first subtree around the root of the second
+    BSTNode *lessA = NULL;
+    BSTNode *greaterA = NULL;
+    BSTNode *found = splitNodes( a, b->data, task->compare, &lessA, &greaterA );
+
+    TreeOperationTask less = { task->operation, task->pool, task->compare, task->depth + 1, lessA,
+        b->left, NULL, 0 };
+    TreeOperationTask greater = { task->operation, task->pool, task->compare, task->depth + 1,
+        greaterA, b->right, NULL, 0 };
+    b->left = NULL;
+    b->right = NULL;
+
+    if( task->pool && task->depth < SPAWN_DEPTH ) {
+        Task *spawned = threadPoolSpawn( task->pool, runTreeOperation, &less );
+        runTreeOperation( &greater );
+        threadPoolJoin( task->pool, spawned );
+    } else {
+        runTreeOperation( &less );
+        runTreeOperation( &greater );
+    }
+
+    task->matches = less.matches + greater.matches + (found ? 1 : 0);
+
+    if( task->operation == TREE_DIFFERENCE || (task->operation == TREE_INTERSECT && ! found) ) {
+        // The root of the second subtree is not part of the result
+        free( b );
+        if( found ) {
+            free( found );
+        }
+
+        task->result = joinTwoNodes( less.result, greater.result );
+    } else {
+        // Keep the first tree's element where both trees had one
+        if( found ) {
+            b->data = found->data;
+            free( found );
+        }
+
+        task->result = joinNodes( less.result, b, greater.result );
     }
 }
 
@@ -1,7 +1,16 @@
 #ifndef BST_H
 #define BST_H
 
+#include <stdbool.h>
+
 #include "functions.h"
+#include "threadpool.h"
+
+/* The number of searches that bstFindBatch keeps in flight at once */
+#define BST_BATCH_WIDTH 8
+
+/* The size of a tree whose nodes haven't been counted since it was split off another tree */
+#define BST_SIZE_UNKNOWN -1
 
 typedef struct BSTNode {
     void *data;
@@ -10,12 +19,45 @@ typedef struct BSTNode {
     struct BSTNode *right;
 } BSTNode;
 
+/*
+ * A binary search tree. A splay tree is a binary search tree that moves every node it finds,
+ * inserts, or removes around to the root, so that recently used elements are found quickly.
+ *
+ * The tree caches its leftmost and rightmost nodes, which bstInsert and bstRemove keep up to date.
+ * A NULL cache in a non-empty tree means the node hasn't been found since the tree was built or
+ * restructured by a bulk operation, and it is found again the next time it is needed.
+ *
+ * Trees other than splay trees are kept as treaps, where each node's priority is derived from a
+ * hash of its address. bstInsert rotates a new leaf up above any parent with a lower priority, and
+ * bstRemove rotates the removed node down below its higher priority child until it can be unlinked,
+ * so the nodes stay heap ordered on their priorities and the expected height of the tree is
+ * logarithmic in its size. The treap flag records whether this holds. Splaying, rebalancing,
+ * building from a sorted array and copying produce trees that are not treaps, and inserts into such
+ * a tree leave it as it is. Clearing the flag of an empty tree gives a plain binary search tree
+ * whose shape follows the order of its inserts.
+ *
+ * The size of a tree produced by bstSplit is BST_SIZE_UNKNOWN until bstSize counts it.
+ */
 typedef struct BST {
     BSTNode *root;
     ComparisonFunction comparisonFunction;
     int size;
+    bool splay;
+    BSTNode *minNode;
+    BSTNode *maxNode;
+    bool treap;
 } BST;
 
+/*
+ * A summary of a tree's shape. The depth of the root is 1, and the height is the depth of the
+ * deepest node, so an empty tree has a height and average depth of 0.
+ */
+typedef struct BSTShapeStats {
+    int size;
+    int height;
+    double averageDepth;
+} BSTShapeStats;
+
 /*
  * A BST Node Consumer function takes a BST node and performs some operation on it.
  */
@@ -48,10 +90,25 @@ extern BSTNode *newNode( void *data, BSTNode *parent, BSTNode *left, BSTNode *ri
  */
 extern BST *newBST( ComparisonFunction comparisonFunction );
 
+/*
+ * Creates a new splay tree. bstFind, bstInsert and bstRemove splay the node they reach to the root
+ * of a splay tree, so even lookups modify it and must not run concurrently with anything else.
+ * Frequently accessed elements stay near the root, which suits skewed access patterns, and every
+ * operation takes amortized O(log n) time.
+ *
+ * Arguments:
+ * comparisonFunction -- A function that will be used to order the inserted elements.
+ *
+ * Returns:
+ * An empty splay tree, or NULL if the comparison function is NULL
+ */
+extern BST *newSplayTree( ComparisonFunction comparisonFunction );
+
 /*
  * Inserts an element into the tree. This element will be placed in its correct ordinal position as
  * determined by the tree's comparison function. If the element or the treeis NULL, then the element
- * will not be inserted.
+ * will not be inserted. In a treap, the new node is rotated up to the position its priority calls
+ * for, which takes an expected O(1) rotations.
  *
  * Arguments:
  * bst             -- The tree to insert the element into.
@@ -59,9 +116,32 @@ extern BST *newBST( ComparisonFunction comparisonFunction );
  */
 extern void bstInsert( BST *bst, void *elementToInsert );
 
+/*
+ * Inserts an element next to a hint node, which skips the search from the root whenever the element
+ * belongs immediately before or after the hint. The hint is checked against its neighbour in order,
+ * so a wrong hint only costs two comparisons before the element is inserted normally. Finding the
+ * neighbour takes time proportional to the distance between the two nodes, except at either end of
+ * the tree, where the cached extremes show that there is no neighbour. Appending ascending keys
+ * with the previous node (or NULL) as the hint therefore takes expected O(1) time per key. As with
+ * bstInsert, a treap rotates the new node up into place, so a tree built this way stays balanced,
+ * and a splay tree still splays the inserted node.
+ *
+ * Arguments:
+ * bst     -- The tree to insert the element into
+ * hint    -- A node of the tree that the element should be placed next to. If this is NULL, the
+ *            element is expected to be larger than every element in the tree.
+ * element -- The element to insert
+ *
+ * Returns:
+ * The node holding the element, or the node holding an equivalent element if there already was
+ * one. This makes a good hint for the next insertion. If the element is NULL, NULL is returned.
+ */
+extern BSTNode *bstInsertHint( BST *bst, BSTNode *hint, void *element );
+
 /*
  * Attempts to find the desired element from the tree. If the element cannot be found, then this
- * function will return NULL, otherwise it will return the removed element.
+ * function will return NULL, otherwise it will return the removed element. In a treap, the node is
+ * rotated down until it has a free child slot, so the other elements keep their nodes.
  *
  * Arguments:
  * bst             -- The tree to remove the element from.
@@ -72,6 +152,56 @@ extern void bstInsert( BST *bst, void *elementToInsert );
  */
 extern void *bstRemove( BST *bst, void *elementToRemove );
 
+/*
+ * Gets the smallest element of the tree. This takes O(1) time while the cached leftmost node is
+ * valid, and time proportional to the height of the tree when it has to be found again.
+ *
+ * Arguments:
+ * bst -- The tree to search
+ *
+ * Returns:
+ * The smallest element in the tree, or NULL if the tree is empty
+ */
+extern void *bstMin( BST *bst );
+
+/*
+ * Gets the largest element of the tree. This takes O(1) time while the cached rightmost node is
+ * valid, and time proportional to the height of the tree when it has to be found again.
+ *
+ * Arguments:
+ * bst -- The tree to search
+ *
+ * Returns:
+ * The largest element in the tree, or NULL if the tree is empty
+ */
+extern void *bstMax( BST *bst );
+
+/*
+ * Removes the smallest element from the tree. The leftmost node never has a left child, so it is
+ * unlinked without a search, and the next smallest node is found by walking from it. Popping every
+ * element in turn takes amortized O(1) time per element. Splay trees are not splayed by this.
+ *
+ * Arguments:
+ * bst -- The tree to remove the element from
+ *
+ * Returns:
+ * The element that was removed, or NULL if the tree is empty
+ */
+extern void *bstPopMin( BST *bst );
+
+/*
+ * Removes the largest element from the tree. The rightmost node never has a right child, so it is
+ * unlinked without a search, and the next largest node is found by walking from it. Popping every
+ * element in turn takes amortized O(1) time per element. Splay trees are not splayed by this.
+ *
+ * Arguments:
+ * bst -- The tree to remove the element from
+ *
+ * Returns:
+ * The element that was removed, or NULL if the tree is empty
+ */
+extern void *bstPopMax( BST *bst );
+
 /*
  * Finds the ordinal successor for a tree node.
  *
@@ -108,6 +238,25 @@ extern BSTNode *predecessor( BSTNode *node );
  */
 extern void *bstFind( BST *bst, void *element );
 
+/*
+ * Searches the tree for a batch of elements at once. Up to BST_BATCH_WIDTH searches are in flight
+ * at a time and are advanced in turn, one step each, in the style of asynchronous memory access
+ * chaining. Each step prefetches the memory the search will need on its next turn, so the cache
+ * misses of different searches overlap instead of being paid one after another. Splay trees are not
+ * splayed by this search.
+ *
+ * Arguments:
+ * bst     -- The binary search tree to search through
+ * keys    -- The elements being searched for
+ * numKeys -- The number of elements being searched for
+ * results -- An array that the found elements are written to. For each key, this holds the
+ *            element in the tree equivalent to it, or NULL if there was no such element.
+ *
+ * Returns:
+ * The number of keys that were found in the tree
+ */
+extern int bstFindBatch( BST *bst, void **keys, int numKeys, void **results );
+
 /*
  * Performs a pre-order traversal and executes the consumer function on each node in the traversal.
  * In a pre-order traversal, at each node, the node will be supplied to the consumer, then the
@@ -132,8 +281,8 @@ extern void bstInOrder( BST *bst, BSTNodeConsumer consumer );
 
 /*
  * Performs a post-order traversal and executes the consumer function on each node in the traversal.
- * In a post-order traversal, at each node, the node will be supplied to the consumer, then the
- * traversal will be recursively called on the right child and then the left child.
+ * In a post-order traversal, at each node, the traversal will visit the left child and then the
+ * right child, and then the node will be supplied to the consumer.
  *
  * Arguments:
  * bst      -- The binary search tree that the post-order traversal is being performed on
@@ -153,6 +302,178 @@ extern void bstPostOrder( BST *bst, BSTNodeConsumer consumer );
  */
 extern void **bstElements( BST *bst );
 
+/*
+ * Gets the number of elements in the tree, counting them if the size isn't known because the tree
+ * was split off another tree. Counting takes O(n) time, and the count is kept for later calls.
+ *
+ * Arguments:
+ * bst -- The tree whose elements are being counted
+ *
+ * Returns:
+ * The number of elements in the tree
+ */
+extern int bstSize( BST *bst );
+
+/*
+ * Computes the height of the tree, which is the number of nodes on its longest path from the root
+ * to a leaf. The tree is walked through its parent pointers, so this uses O(1) space even when the
+ * tree has degenerated into a list.
+ *
+ * Arguments:
+ * bst -- The tree whose height is being computed
+ *
+ * Returns:
+ * The height of the tree, or 0 if it is empty
+ */
+extern int bstHeight( BST *bst );
+
+/*
+ * Computes the size, height, and average node depth of the tree in O(n) time and O(1) space.
+ *
+ * Arguments:
+ * bst   -- The tree whose shape is being measured
+ * stats -- The statistics that are filled in
+ */
+extern void bstShapeStats( BST *bst, BSTShapeStats *stats );
+
+/*
+ * Rebalances the tree in place with the Day-Stout-Warren algorithm. The tree is first rotated into
+ * a sorted vine of right children and then compressed into a tree where every level except the
+ * last is full. This takes O(n) time and O(1) extra space, and no nodes are allocated or freed.
+ *
+ * Arguments:
+ * bst -- The tree to rebalance
+ */
+extern void bstRebalance( BST *bst );
+
+/*
+ * Rebuilds a tree into a treap from its own nodes, unless it is known to be one already. The nodes
+ * are gathered in order and linked into a Cartesian tree on their priorities with a stack of the
+ * right spine built so far, which takes O(n) time and allocates no nodes. The join-based operations
+ * do this to any tree they are given that isn't a treap.
+ *
+ * Arguments:
+ * bst -- The tree to rebuild
+ */
+extern void bstMakeTreap( BST *bst );
+
+/*
+ * Creates a perfectly balanced binary search tree from an array of elements in O(n) time. The
+ * elements must already be sorted according to the comparison function and contain no duplicates.
+ *
+ * Arguments:
+ * comparisonFunction -- The function that will be used to order elements in the tree
+ * elements           -- The sorted elements to place in the tree
+ * numElements        -- The number of elements in the array
+ *
+ * Returns:
+ * A binary search tree containing the elements, or NULL if the comparison function is NULL
+ */
+extern BST *bstFromSortedArray( ComparisonFunction comparisonFunction, void **elements,
+        int numElements );
+
+/*
+ * Creates a copy of the tree's structure. The copy shares its elements with the original tree.
+ *
+ * Arguments:
+ * bst -- The tree to copy
+ *
+ * Returns:
+ * A new tree with the same shape and elements as the original
+ */
+extern BST *bstCopy( BST *bst );
+
+/*
+ * Splits a tree into the elements that are less than a key and the elements that are greater than
+ * it. The original tree is consumed and should not be used afterwards. Only the path from the root
+ * to the key is restructured, so this takes O(height) time, which is expected O(log n) on a treap.
+ * The halves are not counted: their sizes are BST_SIZE_UNKNOWN unless a half is empty, and bstSize
+ * counts them on demand. Both halves are treaps if the tree was one.
+ *
+ * Arguments:
+ * bst     -- The tree to split
+ * key     -- The key to split the tree around
+ * less    -- Set to a new tree containing the elements less than the key
+ * greater -- Set to a new tree containing the elements greater than the key
+ *
+ * Returns:
+ * The element in the tree that is equivalent to the key, or NULL if there was no such element
+ */
+extern void *bstSplit( BST *bst, void *key, BST **less, BST **greater );
+
+/*
+ * Joins two trees around an element. Every element in the lesser tree must be less than the
+ * element, which must be less than every element in the greater tree. Both trees are consumed and
+ * the joined tree is returned in place of the lesser tree. Its size is unknown if either tree's
+ * size was.
+ *
+ * Trees are joined as treaps, which takes time proportional to the heights of the two trees. If
+ * both trees are treaps, as those produced by the join-based operations are, then the joined tree
+ * is too, and its expected height is logarithmic in its size. Otherwise the joined tree is a valid
+ * binary search tree but may be as tall as the two trees put together.
+ *
+ * Arguments:
+ * less    -- The tree containing the lesser elements
+ * element -- The element to place between the trees. If this is NULL, the trees are joined
+ *            directly.
+ * greater -- The tree containing the greater elements
+ *
+ * Returns:
+ * The joined tree
+ */
+extern BST *bstJoin( BST *less, void *element, BST *greater );
+
+/*
+ * Computes the union of two trees using the join-based divide and conquer algorithm of Blelloch et
+ * al. On treaps, which bstInsert and bstRemove maintain, this takes O(m log(n/m + 1)) expected
+ * work, where m is the size of the smaller tree, and the two halves of every split are processed
+ * in parallel. A tree that isn't a treap, such as a splay tree or a copy, is first rebuilt into one
+ * from its own nodes in O(n) time. The result is a treap, and its size is unknown if the size of
+ * either tree was. Both trees are consumed. Where both trees contain equivalent elements, the
+ * element from the first tree is kept and the other is not freed.
+ *
+ * Arguments:
+ * a    -- The first tree
+ * b    -- The second tree, which must use an equivalent comparison function
+ * pool -- The pool used to process subtrees in parallel, or NULL to run sequentially
+ *
+ * Returns:
+ * A tree containing every element from either tree, which reuses the first tree's structure
+ */
+extern BST *bstUnion( BST *a, BST *b, ThreadPool *pool );
+
+/*
+ * Computes the intersection of two trees using the join-based divide and conquer algorithm. The
+ * work is bounded as in bstUnion, with the same rebuild of trees that aren't treaps, and the result
+ * is a treap. Both trees are consumed. Elements that are not kept are not freed, but the nodes that
+ * held them are, which takes time proportional to their number.
+ *
+ * Arguments:
+ * a    -- The first tree. Elements in the result come from this tree.
+ * b    -- The second tree, which must use an equivalent comparison function
+ * pool -- The pool used to process subtrees in parallel, or NULL to run sequentially
+ *
+ * Returns:
+ * A tree containing the elements present in both trees, which reuses the first tree's structure
+ */
+extern BST *bstIntersect( BST *a, BST *b, ThreadPool *pool );
+
+/*
+ * Computes the elements of the first tree that are not in the second tree, using the join-based
+ * divide and conquer algorithm. The work is bounded as in bstUnion, with the same rebuild of trees
+ * that aren't treaps, and the result is a treap. Its size is unknown if the first tree's was. Both
+ * trees are consumed. Elements that are not kept are not freed, but the nodes that held them are.
+ *
+ * Arguments:
+ * a    -- The tree whose elements are kept
+ * b    -- The tree whose elements are removed, which must use an equivalent comparison function
+ * pool -- The pool used to process subtrees in parallel, or NULL to run sequentially
+ *
+ * Returns:
+ * A tree containing the elements of a that are not in b, which reuses the first tree's structure
+ */
+extern BST *bstDifference( BST *a, BST *b, ThreadPool *pool );
+
 /*
  * Frees the binary search tree and all nodes within it. This is expressed as a post order traversal
  * on the provided tree where the consumer function frees the node.
@@ -0,0 +1,538 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "btree.h"
+#include "utils.h"
+
+/* Implementation specific helper functions */
+BTreeNode *newBTreeNode( bool leaf );
+int findKeyIndex( BTreeNode *node, void *key, ComparisonFunction compare, bool *found );
+void splitChild( BTreeNode *parent, int index );
+void *removeFromNode( BTree *btree, BTreeNode *node, void *key );
+void *removeKeyAt( BTreeNode *node, int index );
+void fillChild( BTreeNode *node, int index );
+void mergeChildren( BTreeNode *node, int index );
+void iteratorDescend( BTreeIterator *iterator, BTreeNode *node );
+void freeBTreeNode( BTreeNode *node, bool freeKeys );
+
+/*
+ * Creates a new, empty B-tree.
+ *
+ * Arguments:
+ * comparisonFunction -- A function that will be used to order the inserted elements
+ *
+ * Returns:
+ * An empty B-tree, or NULL if the comparison function is NULL
+ */
+BTree *newBTree( ComparisonFunction comparisonFunction ) {
+    if( comparisonFunction == NULL ) {
+        return NULL;
+    }
+
+    BTree *btree = malloc( sizeof(BTree) );
+    btree->root = newBTreeNode( true );
+    btree->comparisonFunction = comparisonFunction;
+    btree->size = 0;
+
+    return btree;
+}
+
+/*
+ * Allocates an empty node on a cache line boundary, so that it spans as few lines as possible.
+ *
+ * Arguments:
+ * leaf -- Whether the node is a leaf
+ *
+ * Returns:
+ * The new node, or NULL if it could not be allocated
+ */
+BTreeNode *newBTreeNode( bool leaf ) {
+    void *memory = NULL;
+    if( posix_memalign( &memory, CACHE_LINE_SIZE, sizeof(BTreeNode) ) != 0 ) {
+        debug( E_ERROR, "Could not allocate a B-tree node!\n" );
+        return NULL;
+    }
+
+    BTreeNode *node = memory;
+    node->numKeys = 0;
+    node->leaf = leaf;
+
+    return node;
+}
+
+/*
+ * Binary searches a node's keys.
+ *
+ * Arguments:
+ * node    -- The node to search
+ * key     -- The key being searched for
+ * compare -- The function used to order the keys
+ * found   -- Set to whether the key at the returned index is equivalent to the one searched for
+ *
+ * Returns:
+ * The index of the first key in the node that is not less than the one searched for
+ */
+int findKeyIndex( BTreeNode *node, void *key, ComparisonFunction compare, bool *found ) {
+    int low = 0;
+    int high = node->numKeys;
+
+    while( low < high ) {
+        int middle = (low + high) / 2;
+
+        if( compare( node->keys[middle], key ) < 0 ) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    *found = low < node->numKeys && compare( node->keys[low], key ) == 0;
+    return low;
+}
+
+/*
+ * Inserts an element into the tree, splitting full nodes on the way down so that the insertion
+ * never has to back up. Elements equivalent to one already in the tree are not inserted.
+ *
+ * Arguments:
+ * btree           -- The tree to insert the element into
+ * elementToInsert -- The element to insert
+ *
+ * Returns:
+ * True if the element was inserted, false if it was NULL or an equivalent element was present
+ */
+bool btreeInsert( BTree *btree, void *elementToInsert ) {
+    if( elementToInsert == NULL ) {
+        return false;
+    }
+
+    // Check for a duplicate first so that no nodes are split for an insertion that won't happen
+    if( btreeFind( btree, elementToInsert ) ) {
+        return false;
+    }
+
+    if( btree->root->numKeys == BTREE_MAX_KEYS ) {
+        BTreeNode *root = newBTreeNode( false );
+        root->children[0] = btree->root;
+        btree->root = root;
+        splitChild( root, 0 );
+    }
+
+    BTreeNode *node = btree->root;
+    bool found;
+
+    while( ! node->leaf ) {
+        int index = findKeyIndex( node, elementToInsert, btree->comparisonFunction, &found );
+
+        if( node->children[index]->numKeys == BTREE_MAX_KEYS ) {
+            splitChild( node, index );
+
+            // The middle key of the child moved up to index, so pick the half to continue into
+            if( btree->comparisonFunction( node->keys[index], elementToInsert ) < 0 ) {
+                index++;
+            }
+        }
+
+        node = node->children[index];
+    }
+
+    int index = findKeyIndex( node, elementToInsert, btree->comparisonFunction, &found );
+    memmove( &node->keys[index + 1], &node->keys[index], sizeof(void *) * (node->numKeys - index) );
+    node->keys[index] = elementToInsert;
+    node->numKeys++;
+    btree->size++;
+
+    return true;
+}
+
+/*
+ * Splits a full child in two and moves its middle key up into the parent, which must not be full.
+ *
+ * Arguments:
+ * parent -- The parent of the full child
+ * index  -- The index of the full child within the parent
+ */
+void splitChild( BTreeNode *parent, int index ) {
+    BTreeNode *child = parent->children[index];
+    BTreeNode *sibling = newBTreeNode( child->leaf );
+    const int t = BTREE_MIN_DEGREE;
+
+    // The upper t - 1 keys and t children move to the new sibling
+    sibling->numKeys = t - 1;
+    memcpy( sibling->keys, &child->keys[t], sizeof(void *) * (t - 1) );
+    if( ! child->leaf ) {
+        memcpy( sibling->children, &child->children[t], sizeof(BTreeNode *) * t );
+    }
+    child->numKeys = t - 1;
+
+    // Make room in the parent for the middle key and the new sibling
+    memmove( &parent->children[index + 2], &parent->children[index + 1],
+            sizeof(BTreeNode *) * (parent->numKeys - index) );
+    memmove( &parent->keys[index + 1], &parent->keys[index],
+            sizeof(void *) * (parent->numKeys - index) );
+
+    parent->children[index + 1] = sibling;
+    parent->keys[index] = child->keys[t - 1];
+    parent->numKeys++;
+}
+
+/*
+ * Removes an element from the tree. Nodes on the way down are topped up so that a key can always be
+ * removed from the node it ends up in without backing up.
+ *
+ * Arguments:
+ * btree           -- The tree to remove the element from
+ * elementToRemove -- The element to remove
+ *
+ * Returns:
+ * The element that was removed, or NULL if the element could not be found
+ */
+void *btreeRemove( BTree *btree, void *elementToRemove ) {
+    void *removed = removeFromNode( btree, btree->root, elementToRemove );
+
+    if( removed ) {
+        btree->size--;
+    }
+
+    // A root emptied by a merge is replaced by its only child
+    if( btree->root->numKeys == 0 && ! btree->root->leaf ) {
+        BTreeNode *root = btree->root;
+        btree->root = root->children[0];
+        free( root );
+    }
+
+    return removed;
+}
+
+/*
+ * Removes a key from the subtree rooted at a node. Every node this descends into other than the
+ * root holds at least BTREE_MIN_DEGREE keys, so removing a key from it never leaves it underfull.
+ *
+ * Arguments:
+ * btree -- The tree being modified
+ * node  -- The root of the subtree
+ * key   -- The key to remove
+ *
+ * Returns:
+ * The removed element, or NULL if the key was not in the subtree
+ */
+void *removeFromNode( BTree *btree, BTreeNode *node, void *key ) {
+    ComparisonFunction compare = btree->comparisonFunction;
+    const int t = BTREE_MIN_DEGREE;
+
+    while( 1 ) {
+        bool found;
+        int index = findKeyIndex( node, key, compare, &found );
+
+        if( found && node->leaf ) {
+            return removeKeyAt( node, index );
+        } else if( found ) {
+            void *removed = node->keys[index];
+            BTreeNode *left = node->children[index];
+            BTreeNode *right = node->children[index + 1];
+
+            if( left->numKeys >= t ) {
+                // Replace the key with its predecessor, then remove the predecessor from the left
+                BTreeNode *current = left;
+                while( ! current->leaf ) {
+                    current = current->children[ current->numKeys ];
+                }
+
+                void *predecessor = current->keys[ current->numKeys - 1 ];
+                removeFromNode( btree, left, predecessor );
+                node->keys[index] = predecessor;
+            } else if( right->numKeys >= t ) {
+                // Replace the key with its successor, then remove the successor from the right
+                BTreeNode *current = right;
+                while( ! current->leaf ) {
+                    current = current->children[0];
+                }
+
+                void *successor = current->keys[0];
+                removeFromNode( btree, right, successor );
+                node->keys[index] = successor;
+            } else {
+                // Both neighbours are minimal, so merge them around the key and remove it there
+                mergeChildren( node, index );
+                removeFromNode( btree, left, key );
+            }
+
+            return removed;
+        } else if( node->leaf ) {
+            return NULL;
+        }
+
+        // Make sure the child being descended into can afford to lose a key
+        if( node->children[index]->numKeys < t ) {
+            fillChild( node, index );
+
+            if( index > node->numKeys ) {
+                // The last child was merged into its left sibling
+                index--;
+            }
+        }
+
+        node = node->children[index];
+    }
+}
+
+/*
+ * Removes the key at an index of a leaf.
+ *
+ * Arguments:
+ * node  -- The leaf to remove the key from
+ * index -- The index of the key
+ *
+ * Returns:
+ * The removed key
+ */
+void *removeKeyAt( BTreeNode *node, int index ) {
+    void *removed = node->keys[index];
+
+    memmove( &node->keys[index], &node->keys[index + 1],
+            sizeof(void *) * (node->numKeys - index - 1) );
+    node->numKeys--;
+
+    return removed;
+}
+
+/*
+ * Tops up a child with only BTREE_MIN_DEGREE - 1 keys, either by borrowing a key through the parent
+ * from a sibling that can spare one or by merging it with a sibling.
+ *
+ * Arguments:
+ * node  -- The parent of the child
+ * index -- The index of the child within the parent
+ */
+void fillChild( BTreeNode *node, int index ) {
+    BTreeNode *child = node->children[index];
+    const int t = BTREE_MIN_DEGREE;
+
+    if( index > 0 && node->children[index - 1]->numKeys >= t ) {
+        // Rotate the separating key down into the child and the left sibling's last key up
+        BTreeNode *left = node->children[index - 1];
+
+        memmove( &child->keys[1], &child->keys[0], sizeof(void *) * child->numKeys );
+        if( ! child->leaf ) {
+            memmove( &child->children[1], &child->children[0],
+                    sizeof(BTreeNode *) * (child->numKeys + 1) );
+            child->children[0] = left->children[ left->numKeys ];
+        }
+
+        child->keys[0] = node->keys[index - 1];
+        node->keys[index - 1] = left->keys[ left->numKeys - 1 ];
+        child->numKeys++;
+        left->numKeys--;
+    } else if( index < node->numKeys && node->children[index + 1]->numKeys >= t ) {
+        // Rotate the separating key down into the child and the right sibling's first key up
+        BTreeNode *right = node->children[index + 1];
+
+        child->keys[ child->numKeys ] = node->keys[index];
+        if( ! child->leaf ) {
+            child->children[ child->numKeys + 1 ] = right->children[0];
+            memmove( &right->children[0], &right->children[1],
+                    sizeof(BTreeNode *) * right->numKeys );
+        }
+
+        node->keys[index] = right->keys[0];
+        memmove( &right->keys[0], &right->keys[1], sizeof(void *) * (right->numKeys - 1) );
+        child->numKeys++;
+        right->numKeys--;
+    } else if( index < node->numKeys ) {
+        mergeChildren( node, index );
+    } else {
+        mergeChildren( node, index - 1 );
+    }
+}
+
+/*
+ * Merges the child at an index with its right sibling, pulling the key that separates them down
+ * from the parent. Both children must hold BTREE_MIN_DEGREE - 1 keys.
+ *
+ * Arguments:
+ * node  -- The parent of the children
+ * index -- The index of the left child
+ */
+void mergeChildren( BTreeNode *node, int index ) {
+    BTreeNode *left = node->children[index];
+    BTreeNode *right = node->children[index + 1];
+
+    left->keys[ left->numKeys ] = node->keys[index];
+    memcpy( &left->keys[ left->numKeys + 1 ], right->keys, sizeof(void *) * right->numKeys );
+    if( ! left->leaf ) {
+        memcpy( &left->children[ left->numKeys + 1 ], right->children,
+                sizeof(BTreeNode *) * (right->numKeys + 1) );
+    }
+    left->numKeys += right->numKeys + 1;
+
+    memmove( &node->keys[index], &node->keys[index + 1],
+            sizeof(void *) * (node->numKeys - index - 1) );
+    memmove( &node->children[index + 1], &node->children[index + 2],
+            sizeof(BTreeNode *) * (node->numKeys - index - 1) );
+    node->numKeys--;
+
+    free( right );
+}
+
+/*
+ * Searches the tree for an element.
+ *
+ * Arguments:
+ * btree   -- The tree to search through
+ * element -- The element that is being searched for
+ *
+ * Returns:
+ * The element in the tree equivalent to the one searched for, or NULL if there is none
+ */
+void *btreeFind( BTree *btree, void *element ) {
+    BTreeNode *node = btree->root;
+
+    while( 1 ) {
+        bool found;
+        int index = findKeyIndex( node, element, btree->comparisonFunction, &found );
+
+        if( found ) {
+            return node->keys[index];
+        } else if( node->leaf ) {
+            return NULL;
+        }
+
+        node = node->children[index];
+    }
+}
+
+/*
+ * Creates and returns an array of the elements within the tree, in order.
+ *
+ * Arguments:
+ * btree -- The tree whose elements are being copied into an array
+ *
+ * Returns:
+ * An array containing the tree's elements
+ */
+void **btreeElements( BTree *btree ) {
+    void **elements = calloc( btree->size, sizeof(void *) );
+    BTreeIterator iterator;
+    void *element;
+    int index = 0;
+
+    btreeIteratorInit( &iterator, btree );
+    while( (element = btreeIteratorNext( &iterator )) != NULL ) {
+        elements[ index++ ] = element;
+    }
+
+    return elements;
+}
+
+/*
+ * Positions an iterator before the smallest element of a tree.
+ *
+ * Arguments:
+ * iterator -- The iterator to initialize
+ * btree    -- The tree that will be iterated over
+ */
+void btreeIteratorInit( BTreeIterator *iterator, BTree *btree ) {
+    iterator->depth = 0;
+    iteratorDescend( iterator, btree->root );
+}
+
+/*
+ * Pushes the path from a node down to its leftmost leaf onto an iterator's stack.
+ *
+ * Arguments:
+ * iterator -- The iterator being positioned
+ * node     -- The node to start from
+ */
+void iteratorDescend( BTreeIterator *iterator, BTreeNode *node ) {
+    while( 1 ) {
+        iterator->nodes[ iterator->depth ] = node;
+        iterator->indices[ iterator->depth ] = 0;
+        iterator->depth++;
+
+        if( node->leaf ) {
+            break;
+        }
+
+        node = node->children[0];
+    }
+}
+
+/*
+ * Advances an iterator to the next element of its tree.
+ *
+ * Arguments:
+ * iterator -- The iterator to advance
+ *
+ * Returns:
+ * The next element in order, or NULL once every element has been returned
+ */
+void *btreeIteratorNext( BTreeIterator *iterator ) {
+    while( iterator->depth > 0 ) {
+        int top = iterator->depth - 1;
+        BTreeNode *node = iterator->nodes[top];
+        int index = iterator->indices[top];
+
+        if( index >= node->numKeys ) {
+            // Every key in this node has been returned, so resume in its parent
+            iterator->depth--;
+            continue;
+        }
+
+        // Return the key, then visit the subtree that follows it before the next key
+        iterator->indices[top] = index + 1;
+        if( ! node->leaf ) {
+            iteratorDescend( iterator, node->children[index + 1] );
+        }
+
+        return node->keys[index];
+    }
+
+    return NULL;
+}
+
+/*
+ * Frees the tree and the elements within it.
+ *
+ * Arguments:
+ * btree -- The tree that is being freed
+ */
+void btreeFree( BTree *btree ) {
+    freeBTreeNode( btree->root, true );
+    free( btree );
+}
+
+/*
+ * Frees the structural memory of the tree without freeing the elements within it.
+ *
+ * Arguments:
+ * btree -- The tree whose structural memory is being freed
+ */
+void btreeFreeStructure( BTree *btree ) {
+    freeBTreeNode( btree->root, false );
+    free( btree );
+}
+
+/*
+ * Frees a node and the subtrees beneath it.
+ *
+ * Arguments:
+ * node     -- The node to free
+ * freeKeys -- Whether the elements stored in the nodes are freed as well
+ */
+void freeBTreeNode( BTreeNode *node, bool freeKeys ) {
+    if( ! node->leaf ) {
+        for( int i = 0; i <= node->numKeys; i++ ) {
+            freeBTreeNode( node->children[i], freeKeys );
+        }
+    }
+
+    if( freeKeys ) {
+        for( int i = 0; i < node->numKeys; i++ ) {
+            free( node->keys[i] );
+        }
+    }
+
+    free( node );
+}
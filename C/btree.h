@@ -0,0 +1,147 @@
+#ifndef BTREE_H
+#define BTREE_H
+
+#include <stdbool.h>
+
+#include "functions.h"
+
+/*
+ * The minimum degree of the tree. Every node other than the root holds between BTREE_MIN_DEGREE - 1
+ * and BTREE_MAX_KEYS keys. With 8-byte pointers, a node is 256 bytes, and nodes are allocated on
+ * cache line boundaries, so each one occupies exactly four 64-byte cache lines.
+ */
+#define BTREE_MIN_DEGREE 8
+#define BTREE_MAX_KEYS (2 * BTREE_MIN_DEGREE - 1)
+
+/* An upper bound on the height of a tree, which is enough for more than 2^40 elements */
+#define BTREE_MAX_DEPTH 16
+
+/*
+ * A node of a B-tree. The keys are stored contiguously in sorted order, and the subtree at
+ * children[i] holds the keys between keys[i - 1] and keys[i]. Leaves have no children.
+ */
+typedef struct BTreeNode {
+    int numKeys;
+    bool leaf;
+    void *keys[ BTREE_MAX_KEYS ];
+    struct BTreeNode *children[ BTREE_MAX_KEYS + 1 ];
+} BTreeNode;
+
+/*
+ * A B-tree. Because each node holds many keys, a search touches about log2(BTREE_MIN_DEGREE) times
+ * fewer nodes than a search through a balanced binary tree of the same size.
+ */
+typedef struct BTree {
+    BTreeNode *root;
+    ComparisonFunction comparisonFunction;
+    int size;
+} BTree;
+
+/*
+ * An in-order iterator over a B-tree. The path from the root to the current key is kept in fixed
+ * size arrays, so iterating does not allocate. The tree must not be modified while it is being
+ * iterated over.
+ */
+typedef struct BTreeIterator {
+    int depth;
+    BTreeNode *nodes[ BTREE_MAX_DEPTH ];
+    int indices[ BTREE_MAX_DEPTH ];
+} BTreeIterator;
+
+/*
+ * Creates a new, empty B-tree.
+ *
+ * Arguments:
+ * comparisonFunction -- A function that will be used to order the inserted elements
+ *
+ * Returns:
+ * An empty B-tree, or NULL if the comparison function is NULL
+ */
+extern BTree *newBTree( ComparisonFunction comparisonFunction );
+
+/*
+ * Inserts an element into the tree, splitting full nodes on the way down so that the insertion
+ * never has to back up. Elements equivalent to one already in the tree are not inserted.
+ *
+ * Arguments:
+ * btree           -- The tree to insert the element into
+ * elementToInsert -- The element to insert
+ *
+ * Returns:
+ * True if the element was inserted, false if it was NULL or an equivalent element was present
+ */
+extern bool btreeInsert( BTree *btree, void *elementToInsert );
+
+/*
+ * Removes an element from the tree. Nodes on the way down are topped up so that a key can always be
+ * removed from the node it ends up in without backing up.
+ *
+ * Arguments:
+ * btree           -- The tree to remove the element from
+ * elementToRemove -- The element to remove
+ *
+ * Returns:
+ * The element that was removed, or NULL if the element could not be found
+ */
+extern void *btreeRemove( BTree *btree, void *elementToRemove );
+
+/*
+ * Searches the tree for an element.
+ *
+ * Arguments:
+ * btree   -- The tree to search through
+ * element -- The element that is being searched for
+ *
+ * Returns:
+ * The element in the tree equivalent to the one searched for, or NULL if there is none
+ */
+extern void *btreeFind( BTree *btree, void *element );
+
+/*
+ * Creates and returns an array of the elements within the tree, in order.
+ *
+ * Arguments:
+ * btree -- The tree whose elements are being copied into an array
+ *
+ * Returns:
+ * An array containing the tree's elements
+ */
+extern void **btreeElements( BTree *btree );
+
+/*
+ * Positions an iterator before the smallest element of a tree.
+ *
+ * Arguments:
+ * iterator -- The iterator to initialize
+ * btree    -- The tree that will be iterated over
+ */
+extern void btreeIteratorInit( BTreeIterator *iterator, BTree *btree );
+
+/*
+ * Advances an iterator to the next element of its tree.
+ *
+ * Arguments:
+ * iterator -- The iterator to advance
+ *
+ * Returns:
+ * The next element in order, or NULL once every element has been returned
+ */
+extern void *btreeIteratorNext( BTreeIterator *iterator );
+
+/*
+ * Frees the tree and the elements within it.
+ *
+ * Arguments:
+ * btree -- The tree that is being freed
+ */
+extern void btreeFree( BTree *btree );
+
+/*
+ * Frees the structural memory of the tree without freeing the elements within it.
+ *
+ * Arguments:
+ * btree -- The tree whose structural memory is being freed
+ */
+extern void btreeFreeStructure( BTree *btree );
+
+#endif
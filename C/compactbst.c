@@ -0,0 +1,308 @@
+#include <stdlib.h>
+
+#include "compactbst.h"
+#include "utils.h"
+
+/* Implementation specific helper functions */
+uint32_t allocateCompactNode( CompactBST *bst, void *data );
+void releaseCompactNode( CompactBST *bst, uint32_t index );
+uint32_t *compactLink( CompactBST *bst, uint32_t parent, bool rightSide );
+
+/*
+ * Creates a new, empty compact tree.
+ *
+ * Arguments:
+ * comparisonFunction -- A function that will be used to order the inserted elements
+ * capacity           -- The number of nodes to allocate room for up front. If this is not
+ *                       positive, COMPACT_BST_INITIAL_CAPACITY is used.
+ *
+ * Returns:
+ * An empty compact tree, or NULL if the comparison function is NULL
+ */
+CompactBST *newCompactBST( ComparisonFunction comparisonFunction, int capacity ) {
+    if( comparisonFunction == NULL ) {
+        return NULL;
+    }
+
+    if( capacity <= 0 ) {
+        capacity = COMPACT_BST_INITIAL_CAPACITY;
+    }
+
+    CompactBST *bst = malloc( sizeof(CompactBST) );
+
+    // Slot 0 is reserved for COMPACT_NULL, so one extra slot is allocated
+    bst->capacity = (uint32_t) capacity + 1;
+    bst->nodes = malloc( sizeof(CompactNode) * bst->capacity );
+    bst->used = 1;
+    bst->freeList = COMPACT_NULL;
+    bst->root = COMPACT_NULL;
+    bst->comparisonFunction = comparisonFunction;
+    bst->size = 0;
+
+    return bst;
+}
+
+/*
+ * Takes a node from the free list, or from the end of the array if the free list is empty. The
+ * array is doubled when it is full, which may move every node.
+ *
+ * Arguments:
+ * bst  -- The tree the node belongs to
+ * data -- The element the node holds
+ *
+ * Returns:
+ * The index of the new leaf node
+ */
+uint32_t allocateCompactNode( CompactBST *bst, void *data ) {
+    uint32_t index = bst->freeList;
+
+    if( index != COMPACT_NULL ) {
+        bst->freeList = bst->nodes[index].left;
+    } else {
+        if( bst->used == bst->capacity ) {
+            bst->capacity *= 2;
+            bst->nodes = realloc( bst->nodes, sizeof(CompactNode) * bst->capacity );
+        }
+
+        index = bst->used++;
+    }
+
+    bst->nodes[index].data = data;
+    bst->nodes[index].left = COMPACT_NULL;
+    bst->nodes[index].right = COMPACT_NULL;
+
+    return index;
+}
+
+/*
+ * Puts a node on the free list. Its data is cleared so that compactBSTFree can skip it.
+ *
+ * Arguments:
+ * bst   -- The tree the node belongs to
+ * index -- The index of the node being released
+ */
+void releaseCompactNode( CompactBST *bst, uint32_t index ) {
+    bst->nodes[index].data = NULL;
+    bst->nodes[index].left = bst->freeList;
+    bst->nodes[index].right = COMPACT_NULL;
+    bst->freeList = index;
+}
+
+/*
+ * Finds the link that refers to a child of a node, or to the root if there is no parent. The
+ * returned pointer is only valid until the node array next grows.
+ *
+ * Arguments:
+ * bst       -- The tree containing the node
+ * parent    -- The index of the parent node, or COMPACT_NULL for the root
+ * rightSide -- Whether the right child's link is wanted rather than the left
+ *
+ * Returns:
+ * A pointer to the link
+ */
+uint32_t *compactLink( CompactBST *bst, uint32_t parent, bool rightSide ) {
+    if( parent == COMPACT_NULL ) {
+        return &bst->root;
+    }
+
+    return rightSide ? &bst->nodes[parent].right : &bst->nodes[parent].left;
+}
+
+/*
+ * Inserts an element into the tree. The node array doubles in size when it runs out of room.
+ *
+ * Arguments:
+ * bst     -- The tree to insert the element into
+ * element -- The element to insert. NULL elements are not inserted.
+ *
+ * Returns:
+ * True if the element was inserted, false if it was NULL or an equivalent element was present
+ */
+bool compactBSTInsert( CompactBST *bst, void *element ) {
+    if( element == NULL ) {
+        debug( E_WARNING, "Cannot add a NULL element to the compact tree!\n" );
+        return false;
+    }
+
+    ComparisonFunction compare = bst->comparisonFunction;
+    uint32_t parent = COMPACT_NULL;
+    uint32_t current = bst->root;
+    bool rightSide = false;
+
+    while( current != COMPACT_NULL ) {
+        int comparisonResult = compare( element, bst->nodes[current].data );
+
+        if( comparisonResult == 0 ) {
+            return false;
+        }
+
+        parent = current;
+        rightSide = comparisonResult > 0;
+        current = rightSide ? bst->nodes[current].right : bst->nodes[current].left;
+    }
+
+    // Allocating may move the array, so the link is looked up afterwards
+    uint32_t node = allocateCompactNode( bst, element );
+    *compactLink( bst, parent, rightSide ) = node;
+    bst->size += 1;
+
+    return true;
+}
+
+/*
+ * Removes an element from the tree. Its node is put on the free list. A node with two children
+ * takes its successor's element, and the successor's node is spliced out instead.
+ *
+ * Arguments:
+ * bst     -- The tree to remove the element from
+ * element -- The element to remove
+ *
+ * Returns:
+ * The element that was removed, or NULL if there was no equivalent element in the tree
+ */
+void *compactBSTRemove( CompactBST *bst, void *element ) {
+    ComparisonFunction compare = bst->comparisonFunction;
+    CompactNode *nodes = bst->nodes;
+    uint32_t parent = COMPACT_NULL;
+    uint32_t current = bst->root;
+    bool rightSide = false;
+
+    while( current != COMPACT_NULL ) {
+        int comparisonResult = compare( element, nodes[current].data );
+
+        if( comparisonResult == 0 ) {
+            break;
+        }
+
+        parent = current;
+        rightSide = comparisonResult > 0;
+        current = rightSide ? nodes[current].right : nodes[current].left;
+    }
+
+    if( current == COMPACT_NULL ) {
+        return NULL;
+    }
+
+    void *removed = nodes[current].data;
+
+    if( nodes[current].left != COMPACT_NULL && nodes[current].right != COMPACT_NULL ) {
+        // The successor is the leftmost node of the right subtree, so it has no left child
+        uint32_t successorParent = current;
+        uint32_t successor = nodes[current].right;
+        bool successorRightSide = true;
+
+        while( nodes[successor].left != COMPACT_NULL ) {
+            successorParent = successor;
+            successor = nodes[successor].left;
+            successorRightSide = false;
+        }
+
+        nodes[current].data = nodes[successor].data;
+        *compactLink( bst, successorParent, successorRightSide ) = nodes[successor].right;
+        releaseCompactNode( bst, successor );
+    } else {
+        uint32_t child = nodes[current].left != COMPACT_NULL ? nodes[current].left :
+            nodes[current].right;
+        *compactLink( bst, parent, rightSide ) = child;
+        releaseCompactNode( bst, current );
+    }
+
+    bst->size -= 1;
+    return removed;
+}
+
+/*
+ * Searches the tree for an element.
+ *
+ * Arguments:
+ * bst     -- The tree to search through
+ * element -- The element that is being searched for
+ *
+ * Returns:
+ * The element in the tree equivalent to the one searched for, or NULL if there is none
+ */
+void *compactBSTFind( CompactBST *bst, void *element ) {
+    ComparisonFunction compare = bst->comparisonFunction;
+    CompactNode *nodes = bst->nodes;
+    uint32_t current = bst->root;
+
+    while( current != COMPACT_NULL ) {
+        int comparisonResult = compare( element, nodes[current].data );
+
+        if( comparisonResult == 0 ) {
+            return nodes[current].data;
+        }
+
+        current = comparisonResult < 0 ? nodes[current].left : nodes[current].right;
+    }
+
+    return NULL;
+}
+
+/*
+ * Creates an array of the elements in the tree, in order. Nodes don't point at their parents and
+ * the tree is never rebalanced, so the walk keeps the path back up in a stack of indices that grows
+ * on the heap rather than recursing once per level.
+ *
+ * Arguments:
+ * bst -- The tree whose elements are being copied into an array
+ *
+ * Returns:
+ * An array containing the tree's elements
+ */
+void **compactBSTElements( CompactBST *bst ) {
+    void **elements = malloc( sizeof(void *) * (bst->size > 0 ? bst->size : 1) );
+    CompactNode *nodes = bst->nodes;
+    int next = 0;
+
+    int stackCapacity = 32;
+    int stackSize = 0;
+    uint32_t *stack = malloc( sizeof(uint32_t) * stackCapacity );
+    uint32_t current = bst->root;
+
+    while( current != COMPACT_NULL || stackSize > 0 ) {
+        // Descend to the leftmost node, remembering the nodes that are passed along the way
+        while( current != COMPACT_NULL ) {
+            if( stackSize == stackCapacity ) {
+                stackCapacity *= 2;
+                stack = realloc( stack, sizeof(uint32_t) * stackCapacity );
+            }
+
+            stack[ stackSize++ ] = current;
+            current = nodes[current].left;
+        }
+
+        current = stack[ --stackSize ];
+        elements[ next++ ] = nodes[current].data;
+        current = nodes[current].right;
+    }
+
+    free( stack );
+    return elements;
+}
+
+/*
+ * Frees the tree and the elements within it. Released nodes hold no data, so every slot of the
+ * array can be freed without walking the tree.
+ *
+ * Arguments:
+ * bst -- The tree that is being freed
+ */
+void compactBSTFree( CompactBST *bst ) {
+    for( uint32_t i = 1; i < bst->used; i++ ) {
+        free( bst->nodes[i].data );
+    }
+
+    compactBSTFreeStructure( bst );
+}
+
+/*
+ * Frees the structural memory of the tree without freeing the elements within it.
+ *
+ * Arguments:
+ * bst -- The tree whose structural memory is being freed
+ */
+void compactBSTFreeStructure( CompactBST *bst ) {
+    free( bst->nodes );
+    free( bst );
+}
@@ -0,0 +1,118 @@
+#ifndef COMPACTBST_H
+#define COMPACTBST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "functions.h"
+
+/* The index that stands in for a missing child. Slot 0 of the node array is never used. */
+#define COMPACT_NULL 0
+
+/* The number of node slots allocated by newCompactBST when no capacity is requested */
+#define COMPACT_BST_INITIAL_CAPACITY 16
+
+/*
+ * A node of a compact tree. Children are referred to by their index in the tree's node array, so a
+ * node takes 16 bytes rather than the 32 of a BSTNode. Nodes do not point at their parents.
+ */
+typedef struct CompactNode {
+    void *data;
+    uint32_t left;
+    uint32_t right;
+} CompactNode;
+
+/*
+ * A binary search tree whose nodes all live in one growable array. Because links are indices
+ * rather than pointers, the array can be moved or grown with realloc, and the tree's structure can
+ * be written out and read back with a single copy of the array. Removed nodes are kept on a free
+ * list, linked through their left indices, and reused by later insertions.
+ */
+typedef struct CompactBST {
+    CompactNode *nodes;
+    uint32_t capacity;
+    uint32_t used;
+    uint32_t freeList;
+    uint32_t root;
+    ComparisonFunction comparisonFunction;
+    int size;
+} CompactBST;
+
+/*
+ * Creates a new, empty compact tree.
+ *
+ * Arguments:
+ * comparisonFunction -- A function that will be used to order the inserted elements
+ * capacity           -- The number of nodes to allocate room for up front. If this is not
+ *                       positive, COMPACT_BST_INITIAL_CAPACITY is used.
+ *
+ * Returns:
+ * An empty compact tree, or NULL if the comparison function is NULL
+ */
+extern CompactBST *newCompactBST( ComparisonFunction comparisonFunction, int capacity );
+
+/*
+ * Inserts an element into the tree. The node array doubles in size when it runs out of room.
+ *
+ * Arguments:
+ * bst     -- The tree to insert the element into
+ * element -- The element to insert. NULL elements are not inserted.
+ *
+ * Returns:
+ * True if the element was inserted, false if it was NULL or an equivalent element was present
+ */
+extern bool compactBSTInsert( CompactBST *bst, void *element );
+
+/*
+ * Removes an element from the tree. Its node is put on the free list.
+ *
+ * Arguments:
+ * bst     -- The tree to remove the element from
+ * element -- The element to remove
+ *
+ * Returns:
+ * The element that was removed, or NULL if there was no equivalent element in the tree
+ */
+extern void *compactBSTRemove( CompactBST *bst, void *element );
+
+/*
+ * Searches the tree for an element.
+ *
+ * Arguments:
+ * bst     -- The tree to search through
+ * element -- The element that is being searched for
+ *
+ * Returns:
+ * The element in the tree equivalent to the one searched for, or NULL if there is none
+ */
+extern void *compactBSTFind( CompactBST *bst, void *element );
+
+/*
+ * Creates an array of the elements in the tree, in order. The walk uses a stack on the heap, so
+ * it is safe on trees of any height.
+ *
+ * Arguments:
+ * bst -- The tree whose elements are being copied into an array
+ *
+ * Returns:
+ * An array containing the tree's elements
+ */
+extern void **compactBSTElements( CompactBST *bst );
+
+/*
+ * Frees the tree and the elements within it.
+ *
+ * Arguments:
+ * bst -- The tree that is being freed
+ */
+extern void compactBSTFree( CompactBST *bst );
+
+/*
+ * Frees the structural memory of the tree without freeing the elements within it.
+ *
+ * Arguments:
+ * bst -- The tree whose structural memory is being freed
+ */
+extern void compactBSTFreeStructure( CompactBST *bst );
+
+#endif
@@ -0,0 +1,480 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+
+#include "concurrenthashset.h"
+
+/* Implementation specific helper functions */
+HashTable *newHashTable( long numBuckets );
+void freeHashTable( HashTable *table, bool freeElements );
+HashStripe *lockStripe( ConcurrentHashSet *set, unsigned long hash );
+HashEntry **findBucket( ConcurrentHashSet *set, unsigned long hash );
+HashEntry **findEntry( ConcurrentHashSet *set, HashEntry **bucket, void *element,
+        unsigned long hash );
+void lockAllStripes( ConcurrentHashSet *set );
+void unlockAllStripes( ConcurrentHashSet *set );
+void startResize( ConcurrentHashSet *set );
+void helpResize( ConcurrentHashSet *set );
+bool migrateBucket( ConcurrentHashSet *set, long index );
+void finishResize( ConcurrentHashSet *set );
+void freeConcurrentHashSet( ConcurrentHashSet *set, bool freeElements );
+
+/*
+ * Creates a new, empty concurrent hash set.
+ *
+ * Arguments:
+ * comparisonFunction -- A function that will compare elements to determine equality
+ * hashFunction       -- A hash function that agrees with the comparison function
+ *
+ * Returns:
+ * An empty set, or NULL if either function is NULL
+ */
+ConcurrentHashSet *newConcurrentHashSet( ComparisonFunction comparisonFunction,
+        HashFunction hashFunction ) {
+    if( comparisonFunction == NULL || hashFunction == NULL ) {
+        return NULL;
+    }
+
+    void *stripes = NULL;
+    if( posix_memalign( &stripes, CACHE_LINE_SIZE, sizeof(HashStripe) * HASH_SET_STRIPES ) != 0 ) {
+        return NULL;
+    }
+
+    ConcurrentHashSet *set = malloc( sizeof(ConcurrentHashSet) );
+    set->comparisonFunction = comparisonFunction;
+    set->hashFunction = hashFunction;
+    set->stripes = stripes;
+    set->table = newHashTable( HASH_SET_INITIAL_BUCKETS );
+    set->next = NULL;
+    set->resizing = 0;
+    set->migrateCursor = 0;
+    set->migrateLimit = 0;
+    set->bucketsMigrated = 0;
+
+    for( int i = 0; i < HASH_SET_STRIPES; i++ ) {
+        pthread_mutex_init( &set->stripes[i].lock, NULL );
+        set->stripes[i].size = 0;
+    }
+
+    return set;
+}
+
+/*
+ * Allocates a table of empty buckets.
+ *
+ * Arguments:
+ * numBuckets -- The number of buckets in the table, which must be a power of two
+ *
+ * Returns:
+ * The new table
+ */
+HashTable *newHashTable( long numBuckets ) {
+    HashTable *table = malloc( sizeof(HashTable) );
+    table->numBuckets = numBuckets;
+    table->buckets = calloc( numBuckets, sizeof(HashEntry *) );
+    table->migrated = calloc( numBuckets, sizeof(bool) );
+
+    return table;
+}
+
+/*
+ * Frees a table along with the entries in its buckets.
+ *
+ * Arguments:
+ * table        -- The table that is being freed
+ * freeElements -- Whether the elements held by the entries should also be freed
+ */
+void freeHashTable( HashTable *table, bool freeElements ) {
+    for( long i = 0; i < table->numBuckets; i++ ) {
+        HashEntry *entry = table->buckets[i];
+
+        while( entry != NULL ) {
+            HashEntry *next = entry->next;
+
+            if( freeElements ) {
+                free( entry->element );
+            }
+
+            free( entry );
+            entry = next;
+        }
+    }
+
+    free( table->buckets );
+    free( table->migrated );
+    free( table );
+}
+
+/*
+ * Locks the stripe guarding the buckets that a hash can belong to.
+ *
+ * Arguments:
+ * set  -- The set being operated on
+ * hash -- The mixed hash of an element
+ *
+ * Returns:
+ * The locked stripe
+ */
+HashStripe *lockStripe( ConcurrentHashSet *set, unsigned long hash ) {
+    HashStripe *stripe = &set->stripes[ hash & (HASH_SET_STRIPES - 1) ];
+    pthread_mutex_lock( &stripe->lock );
+
+    return stripe;
+}
+
+/*
+ * Finds the bucket that currently holds the elements with a hash. If the set is being resized and
+ * the hash's bucket in the old table has already been moved, the bucket in the new table is used.
+ * The caller must hold the hash's stripe lock.
+ *
+ * Arguments:
+ * set  -- The set being operated on
+ * hash -- The mixed hash of an element
+ *
+ * Returns:
+ * A pointer to the head of the bucket's chain
+ */
+HashEntry **findBucket( ConcurrentHashSet *set, unsigned long hash ) {
+    HashTable *table = set->table;
+    long index = hash & (table->numBuckets - 1);
+
+    if( set->next != NULL && table->migrated[index] ) {
+        table = set->next;
+        index = hash & (table->numBuckets - 1);
+    }
+
+    return &table->buckets[index];
+}
+
+/*
+ * Searches a bucket for an element. The caller must hold the bucket's stripe lock.
+ *
+ * Arguments:
+ * set     -- The set being operated on
+ * bucket  -- The head of the bucket's chain
+ * element -- The element being searched for
+ * hash    -- The mixed hash of the element
+ *
+ * Returns:
+ * A pointer to the link that points at the equivalent entry, or to the chain's final NULL link if
+ * there is no equivalent entry
+ */
+HashEntry **findEntry( ConcurrentHashSet *set, HashEntry **bucket, void *element,
+        unsigned long hash ) {
+    HashEntry **link = bucket;
+
+    while( *link != NULL ) {
+        HashEntry *entry = *link;
+
+        // Comparing the stored hashes first skips most calls to the comparison function
+        if( entry->hash == hash && set->comparisonFunction( element, entry->element ) == 0 ) {
+            break;
+        }
+
+        link = &entry->next;
+    }
+
+    return link;
+}
+
+/*
+ * Adds an element to the set if no equivalent element is present. This may be called concurrently
+ * with any other operation except freeing the set.
+ *
+ * Arguments:
+ * set     -- The set to add the element to
+ * element -- The element to add. NULL elements are not added.
+ *
+ * Returns:
+ * True if the element was added, false otherwise. If the element was not added, the caller still
+ * owns it.
+ */
+bool concurrentHashSetAdd( ConcurrentHashSet *set, void *element ) {
+    if( element == NULL ) {
+        debug( E_WARNING, "Cannot add a NULL element to a concurrent hash set!\n" );
+        return false;
+    }
+
+    unsigned long hash = mixHash( set->hashFunction( element ) );
+    HashStripe *stripe = lockStripe( set, hash );
+    HashEntry **link = findEntry( set, findBucket( set, hash ), element, hash );
+    bool added = *link == NULL;
+    bool overloaded = false;
+
+    if( added ) {
+        HashEntry *entry = malloc( sizeof(HashEntry) );
+        entry->element = element;
+        entry->hash = hash;
+        entry->next = NULL;
+        *link = entry;
+
+        // The stripes hold roughly equal shares of the elements, so one stripe's share is enough
+        // to tell when the whole table is overloaded
+        long size = __atomic_add_fetch( &stripe->size, 1, __ATOMIC_RELAXED );
+        long capacity = set->table->numBuckets * HASH_SET_MAX_LOAD;
+        overloaded = set->next == NULL && size * HASH_SET_STRIPES > capacity;
+    }
+
+    pthread_mutex_unlock( &stripe->lock );
+
+    if( overloaded ) {
+        startResize( set );
+    }
+
+    helpResize( set );
+    return added;
+}
+
+/*
+ * Removes and frees the element equivalent to the supplied one. This may be called concurrently
+ * with any other operation except freeing the set.
+ *
+ * Arguments:
+ * set     -- The set to remove the element from
+ * element -- The element to remove
+ *
+ * Returns:
+ * True if an element was removed, false if there was no equivalent element
+ */
+bool concurrentHashSetRemove( ConcurrentHashSet *set, void *element ) {
+    unsigned long hash = mixHash( set->hashFunction( element ) );
+    HashStripe *stripe = lockStripe( set, hash );
+    HashEntry **link = findEntry( set, findBucket( set, hash ), element, hash );
+    HashEntry *entry = *link;
+
+    if( entry != NULL ) {
+        *link = entry->next;
+        __atomic_sub_fetch( &stripe->size, 1, __ATOMIC_RELAXED );
+    }
+
+    pthread_mutex_unlock( &stripe->lock );
+
+    if( entry != NULL ) {
+        free( entry->element );
+        free( entry );
+    }
+
+    helpResize( set );
+    return entry != NULL;
+}
+
+/*
+ * Determines whether an element is in the set. This may be called concurrently with any other
+ * operation except freeing the set.
+ *
+ * Arguments:
+ * set     -- The set to search through
+ * element -- The element to check the set for
+ *
+ * Returns:
+ * True if the element is in the set, false otherwise
+ */
+bool concurrentHashSetContains( ConcurrentHashSet *set, void *element ) {
+    unsigned long hash = mixHash( set->hashFunction( element ) );
+    HashStripe *stripe = lockStripe( set, hash );
+    bool found = *findEntry( set, findBucket( set, hash ), element, hash ) != NULL;
+
+    pthread_mutex_unlock( &stripe->lock );
+    return found;
+}
+
+/*
+ * Locks every stripe, in order, so that the tables can be replaced.
+ *
+ * Arguments:
+ * set -- The set whose stripes are being locked
+ */
+void lockAllStripes( ConcurrentHashSet *set ) {
+    for( int i = 0; i < HASH_SET_STRIPES; i++ ) {
+        pthread_mutex_lock( &set->stripes[i].lock );
+    }
+}
+
+/*
+ * Unlocks every stripe.
+ *
+ * Arguments:
+ * set -- The set whose stripes are being unlocked
+ */
+void unlockAllStripes( ConcurrentHashSet *set ) {
+    for( int i = HASH_SET_STRIPES - 1; i >= 0; i-- ) {
+        pthread_mutex_unlock( &set->stripes[i].lock );
+    }
+}
+
+/*
+ * Allocates a table twice the size of the current one and starts moving buckets to it, unless a
+ * resize is already under way. The caller must not hold any stripe lock.
+ *
+ * Arguments:
+ * set -- The set being resized
+ */
+void startResize( ConcurrentHashSet *set ) {
+    int idle = 0;
+    if( ! __atomic_compare_exchange_n( &set->resizing, &idle, 1, false, __ATOMIC_ACQ_REL,
+            __ATOMIC_RELAXED ) ) {
+        return;
+    }
+
+    lockAllStripes( set );
+
+    set->next = newHashTable( 2 * set->table->numBuckets );
+    __atomic_store_n( &set->migrateCursor, 0, __ATOMIC_RELAXED );
+    __atomic_store_n( &set->bucketsMigrated, 0, __ATOMIC_RELAXED );
+    __atomic_store_n( &set->migrateLimit, set->table->numBuckets, __ATOMIC_RELAXED );
+
+    unlockAllStripes( set );
+}
+
+/*
+ * Moves the next few unclaimed buckets of the old table to the new one, if the set is being
+ * resized. The thread that moves the last bucket finishes the resize. The caller must not hold any
+ * stripe lock.
+ *
+ * Arguments:
+ * set -- The set being resized
+ */
+void helpResize( ConcurrentHashSet *set ) {
+    if( ! __atomic_load_n( &set->resizing, __ATOMIC_ACQUIRE ) ) {
+        return;
+    }
+
+    long start = __atomic_fetch_add( &set->migrateCursor, HASH_SET_MIGRATE_CHUNK,
+            __ATOMIC_RELAXED );
+    long moved = 0;
+
+    for( long index = start; index < start + HASH_SET_MIGRATE_CHUNK; index++ ) {
+        moved += migrateBucket( set, index );
+    }
+
+    if( moved > 0 ) {
+        long total = __atomic_add_fetch( &set->bucketsMigrated, moved, __ATOMIC_ACQ_REL );
+
+        if( total == __atomic_load_n( &set->migrateLimit, __ATOMIC_RELAXED ) ) {
+            finishResize( set );
+        }
+    }
+}
+
+/*
+ * Moves the elements of one bucket of the old table to the two buckets they belong to in the new
+ * table. Claims on buckets can outlive the resize they were made for, so the bucket is checked
+ * under its stripe lock before it is moved.
+ *
+ * Arguments:
+ * set   -- The set being resized
+ * index -- The index of the bucket in the old table
+ *
+ * Returns:
+ * True if this call moved the bucket, false if it had already been moved or doesn't exist
+ */
+bool migrateBucket( ConcurrentHashSet *set, long index ) {
+    HashStripe *stripe = lockStripe( set, index );
+    HashTable *table = set->table;
+    HashTable *next = set->next;
+    bool moved = false;
+
+    if( next != NULL && index < table->numBuckets && ! table->migrated[index] ) {
+        HashEntry *entry = table->buckets[index];
+
+        while( entry != NULL ) {
+            HashEntry *following = entry->next;
+            long nextIndex = entry->hash & (next->numBuckets - 1);
+
+            entry->next = next->buckets[nextIndex];
+            next->buckets[nextIndex] = entry;
+            entry = following;
+        }
+
+        table->buckets[index] = NULL;
+        table->migrated[index] = true;
+        moved = true;
+    }
+
+    pthread_mutex_unlock( &stripe->lock );
+    return moved;
+}
+
+/*
+ * Replaces the old table with the new one once every bucket has been moved. The caller must not
+ * hold any stripe lock.
+ *
+ * Arguments:
+ * set -- The set being resized
+ */
+void finishResize( ConcurrentHashSet *set ) {
+    lockAllStripes( set );
+
+    long limit = set->table->numBuckets;
+    if( set->next != NULL && __atomic_load_n( &set->bucketsMigrated, __ATOMIC_RELAXED ) == limit ) {
+        freeHashTable( set->table, false );
+        set->table = set->next;
+        set->next = NULL;
+        __atomic_store_n( &set->resizing, 0, __ATOMIC_RELEASE );
+    }
+
+    unlockAllStripes( set );
+}
+
+/*
+ * Finds the number of elements in the set. While other threads are updating the set, the result
+ * may not match the size of the set at any single moment.
+ *
+ * Arguments:
+ * set -- The set whose size is being found
+ *
+ * Returns:
+ * The number of elements in the set
+ */
+int concurrentHashSetSize( ConcurrentHashSet *set ) {
+    long size = 0;
+
+    for( int i = 0; i < HASH_SET_STRIPES; i++ ) {
+        size += __atomic_load_n( &set->stripes[i].size, __ATOMIC_RELAXED );
+    }
+
+    return (int) size;
+}
+
+/*
+ * Frees the set's tables, stripes, and optionally its elements.
+ *
+ * Arguments:
+ * set          -- The set that is being freed
+ * freeElements -- Whether the elements within the set should also be freed
+ */
+void freeConcurrentHashSet( ConcurrentHashSet *set, bool freeElements ) {
+    // Buckets that were moved are empty in the old table, so each element is only freed once
+    freeHashTable( set->table, freeElements );
+    if( set->next != NULL ) {
+        freeHashTable( set->next, freeElements );
+    }
+
+    for( int i = 0; i < HASH_SET_STRIPES; i++ ) {
+        pthread_mutex_destroy( &set->stripes[i].lock );
+    }
+
+    free( set->stripes );
+    free( set );
+}
+
+/*
+ * Frees the set along with the elements within it. No other thread may be using the set.
+ *
+ * Arguments:
+ * set -- The set that is being freed
+ */
+void concurrentHashSetFree( ConcurrentHashSet *set ) {
+    freeConcurrentHashSet( set, true );
+}
+
+/*
+ * Frees the structural memory of the set without freeing the elements within it. No other thread
+ * may be using the set.
+ *
+ * Arguments:
+ * set -- The set whose structural memory is being freed
+ */
+void concurrentHashSetFreeStructure( ConcurrentHashSet *set ) {
+    freeConcurrentHashSet( set, false );
+}
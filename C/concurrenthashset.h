@@ -0,0 +1,162 @@
+#ifndef CONCURRENTHASHSET_H
+#define CONCURRENTHASHSET_H
+
+#include <pthread.h>
+#include <stdbool.h>
+
+#include "functions.h"
+#include "utils.h"
+
+/* The number of locks that the buckets are spread across. This must be a power of two. */
+#define HASH_SET_STRIPES 64
+
+/* The number of buckets in a new set. This must be a power of two no smaller than the stripes. */
+#define HASH_SET_INITIAL_BUCKETS 64
+
+/* The table is doubled once there are more than this many elements per bucket */
+#define HASH_SET_MAX_LOAD 2
+
+/* The number of buckets an update moves to the new table while the set is being resized */
+#define HASH_SET_MIGRATE_CHUNK 16
+
+/*
+ * An element in a bucket's chain. The element's hash is kept so that it never has to be recomputed
+ * when the element is moved to a larger table.
+ */
+typedef struct HashEntry {
+    void *element;
+    unsigned long hash;
+    struct HashEntry *next;
+} HashEntry;
+
+/*
+ * An array of buckets. While the set is being resized, the migrated flag records which buckets of
+ * the old table have had their elements moved to the new one.
+ */
+typedef struct HashTable {
+    long numBuckets;
+    HashEntry **buckets;
+    bool *migrated;
+} HashTable;
+
+/*
+ * A lock guarding every bucket whose index is congruent to the stripe's index, along with the
+ * number of elements in those buckets. Every stripe is on its own cache line.
+ */
+typedef struct HashStripe {
+    pthread_mutex_t lock;
+    long size;
+    char padding[CACHE_LINE_SIZE - (sizeof(pthread_mutex_t) + sizeof(long)) % CACHE_LINE_SIZE];
+} HashStripe;
+
+/*
+ * A hash set that any number of threads may add to, remove from, and search at the same time.
+ * Instead of a single lock, each bucket is guarded by one of HASH_SET_STRIPES locks, so threads
+ * working on elements in different stripes never wait for each other.
+ *
+ * Bucket counts are powers of two no smaller than the number of stripes, so a bucket and the two
+ * buckets its elements move to in a table twice the size are always guarded by the same stripe.
+ * That lets the set grow incrementally: once it is overloaded, a table twice the size is allocated,
+ * and every later update moves a few buckets across while holding only their stripe's lock. An
+ * operation on a bucket that has already been moved uses the new table. The tables are only
+ * swapped, with every stripe locked, once the last bucket has been moved.
+ */
+typedef struct ConcurrentHashSet {
+    ComparisonFunction comparisonFunction;
+    HashFunction hashFunction;
+    HashStripe *stripes;
+
+    /* The tables are only replaced while every stripe is locked */
+    HashTable *table;
+    HashTable *next;
+
+    /* The progress of an incremental resize, which is read and updated atomically */
+    int resizing;
+    long migrateCursor;
+    long migrateLimit;
+    long bucketsMigrated;
+} ConcurrentHashSet;
+
+/*
+ * Creates a new, empty concurrent hash set.
+ *
+ * Arguments:
+ * comparisonFunction -- A function that will compare elements to determine equality
+ * hashFunction       -- A hash function that agrees with the comparison function
+ *
+ * Returns:
+ * An empty set, or NULL if either function is NULL
+ */
+extern ConcurrentHashSet *newConcurrentHashSet( ComparisonFunction comparisonFunction,
+        HashFunction hashFunction );
+
+/*
+ * Adds an element to the set if no equivalent element is present. This may be called concurrently
+ * with any other operation except freeing the set.
+ *
+ * Arguments:
+ * set     -- The set to add the element to
+ * element -- The element to add. NULL elements are not added.
+ *
+ * Returns:
+ * True if the element was added, false otherwise. If the element was not added, the caller still
+ * owns it.
+ */
+extern bool concurrentHashSetAdd( ConcurrentHashSet *set, void *element );
+
+/*
+ * Removes and frees the element equivalent to the supplied one. This may be called concurrently
+ * with any other operation except freeing the set.
+ *
+ * Arguments:
+ * set     -- The set to remove the element from
+ * element -- The element to remove
+ *
+ * Returns:
+ * True if an element was removed, false if there was no equivalent element
+ */
+extern bool concurrentHashSetRemove( ConcurrentHashSet *set, void *element );
+
+/*
+ * Determines whether an element is in the set. This may be called concurrently with any other
+ * operation except freeing the set.
+ *
+ * Arguments:
+ * set     -- The set to search through
+ * element -- The element to check the set for
+ *
+ * Returns:
+ * True if the element is in the set, false otherwise
+ */
+extern bool concurrentHashSetContains( ConcurrentHashSet *set, void *element );
+
+/*
+ * Finds the number of elements in the set. While other threads are updating the set, the result
+ * may not match the size of the set at any single moment.
+ *
+ * Arguments:
+ * set -- The set whose size is being found
+ *
+ * Returns:
+ * The number of elements in the set
+ */
+extern int concurrentHashSetSize( ConcurrentHashSet *set );
+
+/*
+ * Frees the set along with the elements within it. No other thread may be using the set.
+ *
+ * Arguments:
+ * set -- The set that is being freed
+ */
+extern void concurrentHashSetFree( ConcurrentHashSet *set );
+
+/*
+ * Frees the structural memory of the set without freeing the elements within it. No other thread
+ * may be using the set.
+ *
+ * Arguments:
+ * set -- The set whose structural memory is being freed
+ */
+extern void concurrentHashSetFreeStructure( ConcurrentHashSet *set );
+
+#endif
@@ -0,0 +1,311 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <sched.h>
+#include <stdlib.h>
+
+#include "concurrentset.h"
+
+/* The reader slot used by the current thread, or -1 until the thread first reads a set */
+static __thread int readerSlot = -1;
+
+/* The slot handed to the next thread that reads a set */
+static int nextReaderSlot = 0;
+
+/* Implementation specific helper functions */
+int currentReaderSlot();
+int enterReader( ConcurrentSet *set );
+void exitReader( ConcurrentSet *set, int epoch );
+void publishVersion( ConcurrentSet *set, PersistentBST *next, void *removed );
+void waitForReaders( ConcurrentSet *set );
+void reclaimRetired( ConcurrentSet *set );
+
+/*
+ * Creates a new, empty concurrent set.
+ *
+ * Arguments:
+ * comparisonFunction -- A function that will compare elements to determine equality and prevent
+ *                       duplicates from being added.
+ *
+ * Returns:
+ * An empty set, or NULL if the comparison function is NULL
+ */
+ConcurrentSet *newConcurrentSet( ComparisonFunction comparisonFunction ) {
+    if( comparisonFunction == NULL ) {
+        return NULL;
+    }
+
+    void *readers = NULL;
+    size_t readersSize = sizeof(ReaderSlot) * CONCURRENT_SET_READER_SLOTS;
+    if( posix_memalign( &readers, CACHE_LINE_SIZE, readersSize ) != 0 ) {
+        return NULL;
+    }
+
+    ConcurrentSet *set = malloc( sizeof(ConcurrentSet) );
+    set->current = newPersistentBST( comparisonFunction );
+    set->epoch = 0;
+    set->readers = readers;
+    set->retired = NULL;
+    set->numRetired = 0;
+    pthread_mutex_init( &set->writeLock, NULL );
+
+    for( int i = 0; i < CONCURRENT_SET_READER_SLOTS; i++ ) {
+        set->readers[i].active[0] = 0;
+        set->readers[i].active[1] = 0;
+    }
+
+    return set;
+}
+
+/*
+ * Finds the reader slot for the calling thread, assigning one the first time the thread reads a
+ * set. Threads are assigned slots round-robin, so up to CONCURRENT_SET_READER_SLOTS threads never
+ * share a slot.
+ *
+ * Returns:
+ * The index of the thread's reader slot
+ */
+int currentReaderSlot() {
+    if( readerSlot < 0 ) {
+        int slot = __atomic_fetch_add( &nextReaderSlot, 1, __ATOMIC_RELAXED );
+        readerSlot = slot % CONCURRENT_SET_READER_SLOTS;
+    }
+
+    return readerSlot;
+}
+
+/*
+ * Announces that the calling thread is about to read the current version. Until the matching call
+ * to exitReader, no version that was current after this call returns will be freed.
+ *
+ * Arguments:
+ * set -- The set being read
+ *
+ * Returns:
+ * The epoch the reader was counted in, which must be passed to exitReader
+ */
+int enterReader( ConcurrentSet *set ) {
+    int epoch = __atomic_load_n( &set->epoch, __ATOMIC_RELAXED );
+    ReaderSlot *slot = &set->readers[ currentReaderSlot() ];
+
+    // The increment must be visible before the current version is loaded, or a writer could free
+    // the version without having seen this reader
+    __atomic_add_fetch( &slot->active[epoch], 1, __ATOMIC_SEQ_CST );
+    return epoch;
+}
+
+/*
+ * Announces that the calling thread has finished reading.
+ *
+ * Arguments:
+ * set   -- The set that was being read
+ * epoch -- The epoch returned by enterReader
+ */
+void exitReader( ConcurrentSet *set, int epoch ) {
+    ReaderSlot *slot = &set->readers[ currentReaderSlot() ];
+    __atomic_sub_fetch( &slot->active[epoch], 1, __ATOMIC_RELEASE );
+}
+
+/*
+ * Adds an element to the set if no equivalent element is present. This may be called concurrently
+ * with any other operation except freeing the set.
+ *
+ * Arguments:
+ * set     -- The set to add the element to
+ * element -- The element to add. NULL elements are not added.
+ *
+ * Returns:
+ * True if the element was added, false otherwise. If the element was not added, the caller still
+ * owns it.
+ */
+bool concurrentSetAdd( ConcurrentSet *set, void *element ) {
+    if( element == NULL ) {
+        debug( E_WARNING, "Cannot add a NULL element to a concurrent set!\n" );
+        return false;
+    }
+
+    pthread_mutex_lock( &set->writeLock );
+
+    PersistentBST *current = set->current;
+    PersistentBST *next = persistentBSTInsert( current, element );
+    bool added = next->size > current->size;
+
+    if( added ) {
+        publishVersion( set, next, NULL );
+    } else {
+        persistentBSTFreeStructure( next );
+    }
+
+    pthread_mutex_unlock( &set->writeLock );
+    return added;
+}
+
+/*
+ * Removes the element equivalent to the supplied one from the set. The removed element is freed
+ * once no reader can still be looking at it. This may be called concurrently with any other
+ * operation except freeing the set.
+ *
+ * Arguments:
+ * set     -- The set to remove the element from
+ * element -- The element to remove
+ *
+ * Returns:
+ * True if an element was removed, false if there was no equivalent element
+ */
+bool concurrentSetRemove( ConcurrentSet *set, void *element ) {
+    pthread_mutex_lock( &set->writeLock );
+
+    void *removed = NULL;
+    PersistentBST *next = persistentBSTRemove( set->current, element, &removed );
+
+    if( removed ) {
+        publishVersion( set, next, removed );
+    } else {
+        persistentBSTFreeStructure( next );
+    }
+
+    pthread_mutex_unlock( &set->writeLock );
+    return removed != NULL;
+}
+
+/*
+ * Makes a version current and retires the version it replaces. Once enough versions have been
+ * retired, the writer waits for the readers that might still be using them and frees them. The
+ * caller must hold the write lock.
+ *
+ * Arguments:
+ * set     -- The set being updated
+ * next    -- The version that becomes current
+ * removed -- The element that was removed to make the version, or NULL
+ */
+void publishVersion( ConcurrentSet *set, PersistentBST *next, void *removed ) {
+    RetiredVersion *retired = malloc( sizeof(RetiredVersion) );
+    retired->version = set->current;
+    retired->element = removed;
+    retired->next = set->retired;
+
+    __atomic_store_n( &set->current, next, __ATOMIC_SEQ_CST );
+
+    set->retired = retired;
+    set->numRetired += 1;
+
+    if( set->numRetired >= CONCURRENT_SET_RETIRE_BATCH ) {
+        waitForReaders( set );
+        reclaimRetired( set );
+    }
+}
+
+/*
+ * Waits until every reader that might have loaded a retired version has finished. The epoch is
+ * flipped and the old epoch's counters are drained twice, since a reader may have read the epoch
+ * just before a flip and only been counted in it afterwards.
+ *
+ * Arguments:
+ * set -- The set whose readers are being waited for
+ */
+void waitForReaders( ConcurrentSet *set ) {
+    for( int phase = 0; phase < 2; phase++ ) {
+        int epoch = __atomic_load_n( &set->epoch, __ATOMIC_RELAXED );
+        __atomic_store_n( &set->epoch, epoch ^ 1, __ATOMIC_SEQ_CST );
+
+        for( int i = 0; i < CONCURRENT_SET_READER_SLOTS; i++ ) {
+            while( __atomic_load_n( &set->readers[i].active[epoch], __ATOMIC_SEQ_CST ) != 0 ) {
+                sched_yield();
+            }
+        }
+    }
+}
+
+/*
+ * Frees every retired version along with the elements that were removed from them. The caller must
+ * hold the write lock and have waited for the readers.
+ *
+ * Arguments:
+ * set -- The set whose retired versions are being freed
+ */
+void reclaimRetired( ConcurrentSet *set ) {
+    RetiredVersion *retired = set->retired;
+
+    while( retired != NULL ) {
+        RetiredVersion *next = retired->next;
+
+        persistentBSTFreeStructure( retired->version );
+        free( retired->element );
+        free( retired );
+
+        retired = next;
+    }
+
+    set->retired = NULL;
+    set->numRetired = 0;
+}
+
+/*
+ * Determines whether an element is in the set without taking any locks. This may be called
+ * concurrently with any other operation except freeing the set.
+ *
+ * Arguments:
+ * set     -- The set to search through
+ * element -- The element to check the set for
+ *
+ * Returns:
+ * True if the element is in the set, false otherwise
+ */
+bool concurrentSetContains( ConcurrentSet *set, void *element ) {
+    int epoch = enterReader( set );
+
+    PersistentBST *current = __atomic_load_n( &set->current, __ATOMIC_SEQ_CST );
+    bool found = persistentBSTFind( current, element ) != NULL;
+
+    exitReader( set, epoch );
+    return found;
+}
+
+/*
+ * Finds the number of elements in the set.
+ *
+ * Arguments:
+ * set -- The set whose size is being found
+ *
+ * Returns:
+ * The number of elements in the most recently published version of the set
+ */
+int concurrentSetSize( ConcurrentSet *set ) {
+    int epoch = enterReader( set );
+
+    PersistentBST *current = __atomic_load_n( &set->current, __ATOMIC_SEQ_CST );
+    int size = current->size;
+
+    exitReader( set, epoch );
+    return size;
+}
+
+/*
+ * Frees the set along with the elements within it. No other thread may be using the set.
+ *
+ * Arguments:
+ * set -- The set that is being freed
+ */
+void concurrentSetFree( ConcurrentSet *set ) {
+    reclaimRetired( set );
+    persistentBSTFree( set->current );
+
+    pthread_mutex_destroy( &set->writeLock );
+    free( set->readers );
+    free( set );
+}
+
+/*
+ * Frees the structural memory of the set without freeing the elements within it. Elements that were
+ * removed from the set are still freed. No other thread may be using the set.
+ *
+ * Arguments:
+ * set -- The set whose structural memory is being freed
+ */
+void concurrentSetFreeStructure( ConcurrentSet *set ) {
+    reclaimRetired( set );
+    persistentBSTFreeStructure( set->current );
+
+    pthread_mutex_destroy( &set->writeLock );
+    free( set->readers );
+    free( set );
+}
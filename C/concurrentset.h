@@ -0,0 +1,141 @@
+#ifndef CONCURRENTSET_H
+#define CONCURRENTSET_H
+
+#include <pthread.h>
+#include <stdbool.h>
+
+#include "functions.h"
+#include "persistentbst.h"
+#include "utils.h"
+
+/* The number of counters that readers are spread across */
+#define CONCURRENT_SET_READER_SLOTS 64
+
+/* The number of replaced versions that are kept before waiting for readers and freeing them */
+#define CONCURRENT_SET_RETIRE_BATCH 64
+
+/*
+ * The number of readers using a slot in each of the two reader epochs. Every slot is on its own
+ * cache line, so readers on different slots never write to the same line.
+ */
+typedef struct ReaderSlot {
+    long active[2];
+    char padding[CACHE_LINE_SIZE - 2 * sizeof(long)];
+} ReaderSlot;
+
+/*
+ * A version that has been replaced, along with the element it was replaced to remove. Readers that
+ * started before the replacement may still be using either, so both are kept until those readers
+ * have finished.
+ */
+typedef struct RetiredVersion {
+    PersistentBST *version;
+    void *element;
+    struct RetiredVersion *next;
+} RetiredVersion;
+
+/*
+ * A set that any number of threads may search while other threads add and remove elements. The
+ * elements are held in a persistent tree, whose nodes never change once they have been published.
+ * A writer builds the next version of the tree and publishes it with a single atomic store of the
+ * current version, so readers never take a lock and never see a partial update.
+ *
+ * Writers are serialized by a mutex. Replaced versions are reclaimed in the style of read-copy
+ * update: a reader announces itself in a slot for the current epoch before loading the current
+ * version, and a writer frees replaced versions once it has flipped the epoch twice and seen every
+ * slot of the old epoch drain each time.
+ */
+typedef struct ConcurrentSet {
+    PersistentBST *current;
+    int epoch;
+    ReaderSlot *readers;
+
+    /* Only used by writers, which hold the lock */
+    char padding[CACHE_LINE_SIZE];
+    pthread_mutex_t writeLock;
+    RetiredVersion *retired;
+    int numRetired;
+} ConcurrentSet;
+
+/*
+ * Creates a new, empty concurrent set.
+ *
+ * Arguments:
+ * comparisonFunction -- A function that will compare elements to determine equality and prevent
+ *                       duplicates from being added.
+ *
+ * Returns:
+ * An empty set, or NULL if the comparison function is NULL
+ */
+extern ConcurrentSet *newConcurrentSet( ComparisonFunction comparisonFunction );
+
+/*
+ * Adds an element to the set if no equivalent element is present. This may be called concurrently
+ * with any other operation except freeing the set.
+ *
+ * Arguments:
+ * set     -- The set to add the element to
+ * element -- The element to add. NULL elements are not added.
+ *
+ * Returns:
+ * True if the element was added, false otherwise. If the element was not added, the caller still
+ * owns it.
+ */
+extern bool concurrentSetAdd( ConcurrentSet *set, void *element );
+
+/*
+ * Removes the element equivalent to the supplied one from the set. The removed element is freed
+ * once no reader can still be looking at it. This may be called concurrently with any other
+ * operation except freeing the set.
+ *
+ * Arguments:
+ * set     -- The set to remove the element from
+ * element -- The element to remove
+ *
+ * Returns:
+ * True if an element was removed, false if there was no equivalent element
+ */
+extern bool concurrentSetRemove( ConcurrentSet *set, void *element );
+
+/*
+ * Determines whether an element is in the set without taking any locks. This may be called
+ * concurrently with any other operation except freeing the set.
+ *
+ * Arguments:
+ * set     -- The set to search through
+ * element -- The element to check the set for
+ *
+ * Returns:
+ * True if the element is in the set, false otherwise
+ */
+extern bool concurrentSetContains( ConcurrentSet *set, void *element );
+
+/*
+ * Finds the number of elements in the set.
+ *
+ * Arguments:
+ * set -- The set whose size is being found
+ *
+ * Returns:
+ * The number of elements in the most recently published version of the set
+ */
+extern int concurrentSetSize( ConcurrentSet *set );
+
+/*
+ * Frees the set along with the elements within it. No other thread may be using the set.
+ *
+ * Arguments:
+ * set -- The set that is being freed
+ */
+extern void concurrentSetFree( ConcurrentSet *set );
+
+/*
+ * Frees the structural memory of the set without freeing the elements within it. Elements that were
+ * removed from the set are still freed. No other thread may be using the set.
+ *
+ * Arguments:
+ * set -- The set whose structural memory is being freed
+ */
+extern void concurrentSetFreeStructure( ConcurrentSet *set );
+
+#endif
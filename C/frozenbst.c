@@ -0,0 +1,133 @@
+#include <stdlib.h>
+
+#include "frozenbst.h"
+#include "utils.h"
+
+/* The number of levels ahead of a search that frozenBSTFind prefetches */
+#define PREFETCH_LEVELS 4
+
+/* Implementation specific helper functions */
+void fillEytzinger( FrozenBST *frozen, void **sorted, int *next, int index );
+
+/*
+ * Creates a frozen search array holding the elements of a tree. The tree is not modified and the
+ * array shares its elements with the tree.
+ *
+ * Arguments:
+ * bst -- The tree whose elements are being frozen
+ *
+ * Returns:
+ * A frozen search array holding every element in the tree
+ */
+FrozenBST *bstFreeze( BST *bst ) {
+    void **sorted = bstElements( bst );
+    FrozenBST *frozen = newFrozenBST( bst->comparisonFunction, sorted, bstSize( bst ) );
+    free( sorted );
+
+    return frozen;
+}
+
+/*
+ * Creates a frozen search array from elements that are already sorted. The array shares its
+ * elements with the one supplied, which is not modified.
+ *
+ * Arguments:
+ * comparisonFunction -- The function the elements are ordered by
+ * sorted             -- The distinct elements, in order
+ * numElements        -- The number of elements
+ *
+ * Returns:
+ * A frozen search array holding every supplied element
+ */
+FrozenBST *newFrozenBST( ComparisonFunction comparisonFunction, void **sorted, int numElements ) {
+    FrozenBST *frozen = malloc( sizeof(FrozenBST) );
+    frozen->size = numElements;
+    frozen->comparisonFunction = comparisonFunction;
+    frozen->elements = malloc( sizeof(void *) * (numElements + 1) );
+    frozen->elements[0] = NULL;
+
+    int next = 0;
+    fillEytzinger( frozen, sorted, &next, 1 );
+
+    return frozen;
+}
+
+/*
+ * Places sorted elements into their Eytzinger positions with an in-order walk of the implicit tree.
+ *
+ * Arguments:
+ * frozen -- The frozen array being filled
+ * sorted -- The elements of the tree, in order
+ * next   -- The index of the next sorted element to place
+ * index  -- The position in the frozen array being visited
+ */
+void fillEytzinger( FrozenBST *frozen, void **sorted, int *next, int index ) {
+    if( index <= frozen->size ) {
+        fillEytzinger( frozen, sorted, next, 2 * index );
+        frozen->elements[index] = sorted[ *next ];
+        *next += 1;
+        fillEytzinger( frozen, sorted, next, 2 * index + 1 );
+    }
+}
+
+/*
+ * Searches a frozen array for an element. The descent does not branch on the result of each
+ * comparison, and the elements four levels further down are prefetched at every step.
+ *
+ * Arguments:
+ * frozen  -- The frozen array to search
+ * element -- The element that is being searched for
+ *
+ * Returns:
+ * The element in the array equivalent to the one searched for, or NULL if there is none
+ */
+void *frozenBSTFind( FrozenBST *frozen, void *element ) {
+    void **elements = frozen->elements;
+    ComparisonFunction compare = frozen->comparisonFunction;
+    unsigned long size = frozen->size;
+    unsigned long index = 1;
+
+    // Go right whenever the current element is smaller, so the search ends past a leaf
+    while( index <= size ) {
+        PREFETCH( elements + (index << PREFETCH_LEVELS) );
+        index = 2 * index + (compare( elements[index], element ) < 0);
+    }
+
+    // The last left turn was at the smallest element that isn't less than the one searched for.
+    // Undo the trailing right turns and then that left turn.
+    while( index & 1 ) {
+        index >>= 1;
+    }
+    index >>= 1;
+
+    if( index != 0 && compare( elements[index], element ) == 0 ) {
+        return elements[index];
+    }
+
+    return NULL;
+}
+
+/*
+ * Frees the frozen array and the elements within it.
+ *
+ * Arguments:
+ * frozen -- The frozen array that is being freed
+ */
+void frozenBSTFree( FrozenBST *frozen ) {
+    for( int i = 1; i <= frozen->size; i++ ) {
+        free( frozen->elements[i] );
+    }
+
+    frozenBSTFreeStructure( frozen );
+}
+
+/*
+ * Frees the frozen array without freeing the elements within it.
+ *
+ * Arguments:
+ * frozen -- The frozen array whose structural memory is being freed
+ */
+void frozenBSTFreeStructure( FrozenBST *frozen ) {
+    free( frozen->elements );
+    free( frozen );
+}
@@ -0,0 +1,76 @@
+#ifndef FROZENBST_H
+#define FROZENBST_H
+
+#include "bst.h"
+#include "functions.h"
+
+/*
+ * An immutable search array holding the elements of a binary search tree in Eytzinger order: the
+ * root is at index 1 and the children of the element at index i are at indices 2i and 2i + 1. This
+ * is the order of a breadth first traversal of a complete tree, so the first levels of every search
+ * share a few cache lines and the positions a search may visit next are adjacent, which makes them
+ * easy to prefetch. Index 0 is unused.
+ */
+typedef struct FrozenBST {
+    void **elements;
+    int size;
+    ComparisonFunction comparisonFunction;
+} FrozenBST;
+
+/*
+ * Creates a frozen search array holding the elements of a tree. The tree is not modified and the
+ * array shares its elements with the tree.
+ *
+ * Arguments:
+ * bst -- The tree whose elements are being frozen
+ *
+ * Returns:
+ * A frozen search array holding every element in the tree
+ */
+extern FrozenBST *bstFreeze( BST *bst );
+
+/*
+ * Creates a frozen search array from elements that are already sorted. The array shares its
+ * elements with the one supplied, which is not modified.
+ *
+ * Arguments:
+ * comparisonFunction -- The function the elements are ordered by
+ * sorted             -- The distinct elements, in order
+ * numElements        -- The number of elements
+ *
+ * Returns:
+ * A frozen search array holding every supplied element
+ */
+extern FrozenBST *newFrozenBST( ComparisonFunction comparisonFunction, void **sorted,
+        int numElements );
+
+/*
+ * Searches a frozen array for an element. The descent does not branch on the result of each
+ * comparison, and the elements four levels further down are prefetched at every step.
+ *
+ * Arguments:
+ * frozen  -- The frozen array to search
+ * element -- The element that is being searched for
+ *
+ * Returns:
+ * The element in the array equivalent to the one searched for, or NULL if there is none
+ */
+extern void *frozenBSTFind( FrozenBST *frozen, void *element );
+
+/*
+ * Frees the frozen array and the elements within it.
+ *
+ * Arguments:
+ * frozen -- The frozen array that is being freed
+ */
+extern void frozenBSTFree( FrozenBST *frozen );
+
+/*
+ * Frees the frozen array without freeing the elements within it.
+ *
+ * Arguments:
+ * frozen -- The frozen array whose structural memory is being freed
+ */
+extern void frozenBSTFreeStructure( FrozenBST *frozen );
+
+#endif
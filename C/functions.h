@@ -23,4 +23,10 @@ typedef void (*ElementConsumer)(void *);
  */
 typedef void *(*MapFunction)(void *);
 
+/*
+ * A hash function takes a pointer to data and reduces it to an integer. Elements that a comparison
+ * function considers equal must hash to the same value.
+ */
+typedef unsigned long (*HashFunction)(void *);
+
 #endif
@@ -0,0 +1,281 @@
+#include <stdlib.h>
+
+#include "intbst.h"
+#include "utils.h"
+
+/* Implementation specific helper functions */
+IntBSTNode *findIntNode( IntBST *bst, int64_t key );
+IntBSTNode *intSuccessor( IntBSTNode *node );
+void replaceIntNode( IntBST *bst, IntBSTNode *node, IntBSTNode *replacement );
+void freeIntNodes( IntBST *bst, bool freeValues );
+
+/*
+ * Creates a new, empty integer keyed tree.
+ *
+ * Returns:
+ * An empty tree
+ */
+IntBST *newIntBST() {
+    IntBST *bst = malloc( sizeof(IntBST) );
+    bst->root = NULL;
+    bst->size = 0;
+
+    return bst;
+}
+
+/*
+ * Inserts a key and its value into the tree. If the key is already present, the tree is unchanged.
+ *
+ * Arguments:
+ * bst   -- The tree to insert the key into
+ * key   -- The key to insert
+ * value -- The value associated with the key, which may be NULL
+ *
+ * Returns:
+ * True if the key was inserted, false if it was already present
+ */
+bool intBSTInsert( IntBST *bst, int64_t key, void *value ) {
+    IntBSTNode *parent = NULL;
+    IntBSTNode **link = &bst->root;
+
+    while( *link != NULL ) {
+        parent = *link;
+
+        if( key == parent->key ) {
+            return false;
+        }
+
+        link = key < parent->key ? &parent->left : &parent->right;
+    }
+
+    IntBSTNode *node = malloc( sizeof(IntBSTNode) );
+    node->key = key;
+    node->value = value;
+    node->parent = parent;
+    node->left = NULL;
+    node->right = NULL;
+
+    *link = node;
+    bst->size += 1;
+
+    return true;
+}
+
+/*
+ * Finds the node holding a key.
+ *
+ * Arguments:
+ * bst -- The tree to search through
+ * key -- The key that is being searched for
+ *
+ * Returns:
+ * The node holding the key, or NULL if the key is not in the tree
+ */
+IntBSTNode *findIntNode( IntBST *bst, int64_t key ) {
+    IntBSTNode *current = bst->root;
+
+    while( current != NULL && current->key != key ) {
+        current = key < current->key ? current->left : current->right;
+    }
+
+    return current;
+}
+
+/*
+ * Searches the tree for a key.
+ *
+ * Arguments:
+ * bst   -- The tree to search through
+ * key   -- The key that is being searched for
+ * value -- If this is not NULL and the key is found, the key's value is written here
+ *
+ * Returns:
+ * True if the key is in the tree, false otherwise
+ */
+bool intBSTFind( IntBST *bst, int64_t key, void **value ) {
+    IntBSTNode *node = findIntNode( bst, key );
+
+    if( node == NULL ) {
+        return false;
+    }
+
+    if( value != NULL ) {
+        *value = node->value;
+    }
+
+    return true;
+}
+
+/*
+ * Removes a key from the tree. A node with two children takes its successor's key and value, and
+ * the successor's node is removed instead.
+ *
+ * Arguments:
+ * bst   -- The tree to remove the key from
+ * key   -- The key to remove
+ * value -- If this is not NULL and the key is removed, the key's value is written here
+ *
+ * Returns:
+ * True if the key was removed, false if it was not in the tree
+ */
+bool intBSTRemove( IntBST *bst, int64_t key, void **value ) {
+    IntBSTNode *node = findIntNode( bst, key );
+
+    if( node == NULL ) {
+        return false;
+    }
+
+    if( value != NULL ) {
+        *value = node->value;
+    }
+
+    if( node->left != NULL && node->right != NULL ) {
+        IntBSTNode *next = intSuccessor( node );
+        node->key = next->key;
+        node->value = next->value;
+        node = next;
+    }
+
+    replaceIntNode( bst, node, node->left != NULL ? node->left : node->right );
+    bst->size -= 1;
+
+    return true;
+}
+
+/*
+ * Finds the ordinal successor of a node.
+ *
+ * Arguments:
+ * node -- The node whose successor is being found
+ *
+ * Returns:
+ * The node holding the next largest key, or NULL if this node holds the largest key
+ */
+IntBSTNode *intSuccessor( IntBSTNode *node ) {
+    if( node->right != NULL ) {
+        node = node->right;
+
+        while( node->left != NULL ) {
+            node = node->left;
+        }
+
+        return node;
+    }
+
+    while( node->parent != NULL && node == node->parent->right ) {
+        node = node->parent;
+    }
+
+    return node->parent;
+}
+
+/*
+ * Replaces a node that has at most one child with that child, then frees the node.
+ *
+ * Arguments:
+ * bst         -- The tree containing the node
+ * node        -- The node that is being replaced
+ * replacement -- The node's only child, or NULL
+ */
+void replaceIntNode( IntBST *bst, IntBSTNode *node, IntBSTNode *replacement ) {
+    IntBSTNode *parent = node->parent;
+
+    if( parent == NULL ) {
+        bst->root = replacement;
+    } else if( parent->left == node ) {
+        parent->left = replacement;
+    } else {
+        parent->right = replacement;
+    }
+
+    if( replacement != NULL ) {
+        replacement->parent = parent;
+    }
+
+    free( node );
+}
+
+/*
+ * Creates an array of the keys in the tree, in ascending order.
+ *
+ * Arguments:
+ * bst -- The tree whose keys are being copied into an array
+ *
+ * Returns:
+ * An array containing the tree's keys
+ */
+int64_t *intBSTKeys( IntBST *bst ) {
+    int64_t *keys = malloc( sizeof(int64_t) * (bst->size > 0 ? bst->size : 1) );
+    IntBSTNode *node = bst->root;
+    int count = 0;
+
+    while( node != NULL && node->left != NULL ) {
+        node = node->left;
+    }
+
+    for( ; node != NULL; node = intSuccessor( node ) ) {
+        keys[ count++ ] = node->key;
+    }
+
+    return keys;
+}
+
+/*
+ * Frees every node in the tree. The nodes are freed from the leaves up by following parent
+ * pointers, so no stack is needed however deep the tree is.
+ *
+ * Arguments:
+ * bst        -- The tree whose nodes are being freed
+ * freeValues -- Whether the values held by the nodes should also be freed
+ */
+void freeIntNodes( IntBST *bst, bool freeValues ) {
+    IntBSTNode *node = bst->root;
+
+    while( node != NULL ) {
+        if( node->left != NULL ) {
+            node = node->left;
+        } else if( node->right != NULL ) {
+            node = node->right;
+        } else {
+            IntBSTNode *parent = node->parent;
+
+            if( parent != NULL && parent->left == node ) {
+                parent->left = NULL;
+            } else if( parent != NULL ) {
+                parent->right = NULL;
+            }
+
+            if( freeValues ) {
+                free( node->value );
+            }
+
+            free( node );
+            node = parent;
+        }
+    }
+
+    bst->root = NULL;
+    bst->size = 0;
+}
+
+/*
+ * Frees the tree and the values within it.
+ *
+ * Arguments:
+ * bst -- The tree that is being freed
+ */
+void intBSTFree( IntBST *bst ) {
+    freeIntNodes( bst, true );
+    free( bst );
+}
+
+/*
+ * Frees the structural memory of the tree without freeing the values within it.
+ *
+ * Arguments:
+ * bst -- The tree whose structural memory is being freed
+ */
+void intBSTFreeStructure( IntBST *bst ) {
+    freeIntNodes( bst, false );
+    free( bst );
+}
@@ -0,0 +1,102 @@
+#ifndef INTBST_H
+#define INTBST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * A node of an integer keyed tree. The key is stored inline, so searching never leaves the node
+ * and never calls through a comparison function.
+ */
+typedef struct IntBSTNode {
+    int64_t key;
+    void *value;
+    struct IntBSTNode *parent;
+    struct IntBSTNode *left;
+    struct IntBSTNode *right;
+} IntBSTNode;
+
+/*
+ * A binary search tree keyed by 64-bit integers, each of which maps to an optional value. With NULL
+ * values, it serves as a set of integers that needs no allocation per key.
+ */
+typedef struct IntBST {
+    IntBSTNode *root;
+    int size;
+} IntBST;
+
+/*
+ * Creates a new, empty integer keyed tree.
+ *
+ * Returns:
+ * An empty tree
+ */
+extern IntBST *newIntBST();
+
+/*
+ * Inserts a key and its value into the tree. If the key is already present, the tree is unchanged.
+ *
+ * Arguments:
+ * bst   -- The tree to insert the key into
+ * key   -- The key to insert
+ * value -- The value associated with the key, which may be NULL
+ *
+ * Returns:
+ * True if the key was inserted, false if it was already present
+ */
+extern bool intBSTInsert( IntBST *bst, int64_t key, void *value );
+
+/*
+ * Searches the tree for a key.
+ *
+ * Arguments:
+ * bst   -- The tree to search through
+ * key   -- The key that is being searched for
+ * value -- If this is not NULL and the key is found, the key's value is written here
+ *
+ * Returns:
+ * True if the key is in the tree, false otherwise
+ */
+extern bool intBSTFind( IntBST *bst, int64_t key, void **value );
+
+/*
+ * Removes a key from the tree.
+ *
+ * Arguments:
+ * bst   -- The tree to remove the key from
+ * key   -- The key to remove
+ * value -- If this is not NULL and the key is removed, the key's value is written here
+ *
+ * Returns:
+ * True if the key was removed, false if it was not in the tree
+ */
+extern bool intBSTRemove( IntBST *bst, int64_t key, void **value );
+
+/*
+ * Creates an array of the keys in the tree, in ascending order.
+ *
+ * Arguments:
+ * bst -- The tree whose keys are being copied into an array
+ *
+ * Returns:
+ * An array containing the tree's keys
+ */
+extern int64_t *intBSTKeys( IntBST *bst );
+
+/*
+ * Frees the tree and the values within it.
+ *
+ * Arguments:
+ * bst -- The tree that is being freed
+ */
+extern void intBSTFree( IntBST *bst );
+
+/*
+ * Frees the structural memory of the tree without freeing the values within it.
+ *
+ * Arguments:
+ * bst -- The tree whose structural memory is being freed
+ */
+extern void intBSTFreeStructure( IntBST *bst );
+
+#endif
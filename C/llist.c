@@ -4,6 +4,12 @@
 #include "llist.h"
 #include "utils.h"
 
+/* Implementation specific helper functions */
+ListNode *searchStart( LList *list, void *data );
+ListNode *findNode( LList *list, void *data );
+void linkBefore( LList *list, ListNode *node, ListNode *newNode );
+void *unlinkNode( LList *list, ListNode *node );
+
 /*
  * Creates a new linked list node.
  *
@@ -18,6 +24,7 @@ ListNode *newListNode( void* data, ListNode *next ) {
     ListNode *node = malloc( sizeof(ListNode) );
     node->data = data;
     node->next = next;
+    node->prev = NULL;
 
     return node;
 }
@@ -25,23 +32,144 @@ ListNode *newListNode( void* data, ListNode *next ) {
 /*
  * Creates a list that starts with a NULL node.
  *
+ * Arguments:
+ * comparisonFunction -- The function used to keep the list sorted. If this is NULL, the list will
+ *                       be unsorted.
+ *
  * Returns:
  * The newly allocated linked list
  */
 LList *newList( ComparisonFunction comparisonFunction ) {
     LList *list = malloc( sizeof(LList) );
     list->size = 0;
-    list->head = newListNode(NULL, NULL);
+    list->tail = newListNode(NULL, NULL);
+    list->head = list->tail;
+    list->finger = NULL;
+    list->comparisonFunction = comparisonFunction;
+
+    return list;
+}
+
+/*
+ * Determines the node that a search for the supplied data should begin at. If the finger holds data
+ * that is not larger than the data being searched for, the search can resume from the finger.
+ * Otherwise, it has to start over from the head of the list.
+ *
+ * Arguments:
+ * list -- The list that is being searched
+ * data -- The data that is being searched for
+ *
+ * Returns:
+ * The node that the search should start from
+ */
+ListNode *searchStart( LList *list, void *data ) {
+    ListNode *finger = list->finger;
 
-    if( comparisonFunction != NULL ) {
-        list->comparisonFunction = comparisonFunction;
+    // The terminating NULL node can't be compared against, so it is never a valid starting point
+    if( finger != NULL && finger->data != NULL && list->comparisonFunction(finger->data, data) <= 0 ) {
+        return finger;
     }
 
-    return list;
+    return list->head;
 }
 
 /*
- * Inserts the element into the list.
+ * Finds the node containing the supplied data. Sorted lists are searched from the finger where
+ * possible, while unsorted lists are scanned from the head for a node holding the same pointer.
+ *
+ * Arguments:
+ * list -- The list that is being searched
+ * data -- The data that is being searched for
+ *
+ * Returns:
+ * The node containing the data, or NULL if it can't be found
+ */
+ListNode *findNode( LList *list, void *data ) {
+    ComparisonFunction compare = list->comparisonFunction;
+
+    if( compare == NULL ) {
+        for( ListNode *current = list->head; current != list->tail; current = current->next ) {
+            if( current->data == data ) {
+                return current;
+            }
+        }
+
+        return NULL;
+    }
+
+    ListNode *current = searchStart( list, data );
+
+    // The list is sorted, so the search can stop at the first node that isn't smaller than the data
+    while( current != list->tail && compare( current->data, data ) < 0 ) {
+        current = current->next;
+    }
+
+    list->finger = current;
+
+    // If the data in current isn't equal to the data we're trying to find, return NULL
+    if( current == list->tail || compare( current->data, data ) != 0 ) {
+        return NULL;
+    } else {
+        return current;
+    }
+}
+
+/*
+ * Links a new node into the list directly before an existing node.
+ *
+ * Arguments:
+ * list    -- The list that the node is being linked into
+ * node    -- The node that the new node will precede
+ * newNode -- The node that is being linked into the list
+ */
+void linkBefore( LList *list, ListNode *node, ListNode *newNode ) {
+    newNode->next = node;
+    newNode->prev = node->prev;
+
+    if( node->prev != NULL ) {
+        node->prev->next = newNode;
+    } else {
+        list->head = newNode;
+    }
+
+    node->prev = newNode;
+    list->size += 1;
+}
+
+/*
+ * Unlinks a node from the list and frees it. The terminating NULL node cannot be unlinked.
+ *
+ * Arguments:
+ * list -- The list that the node is being unlinked from
+ * node -- The node that is being unlinked
+ *
+ * Returns:
+ * The data that was contained in the node
+ */
+void *unlinkNode( LList *list, ListNode *node ) {
+    void *data = node->data;
+
+    if( node->prev != NULL ) {
+        node->prev->next = node->next;
+    } else {
+        list->head = node->next;
+    }
+
+    node->next->prev = node->prev;
+
+    // The predecessor is never larger than anything after the removed node
+    if( list->finger == node ) {
+        list->finger = node->prev;
+    }
+
+    free( node );
+    list->size -= 1;
+    return data;
+}
+
+/*
+ * Inserts the element into the list. Sorted lists insert the element in its ordinal position, while
+ * unsorted lists append it to the back of the list.
  *
  * Arguments:
  * list -- The to add the element into
@@ -53,19 +181,24 @@ void listInsert( LList *list, void *data ) {
         return;
     }
 
-    ListNode *current = list->head;
     ComparisonFunction compare = list->comparisonFunction;
 
+    if( compare == NULL ) {
+        listPushBack( list, data );
+        return;
+    }
+
+    ListNode *current = searchStart( list, data );
+
     // Determine where the data will be inserted
-    while( current->next != NULL && compare(current->data, data) < 0 ) {
+    while( current != list->tail && compare(current->data, data) < 0 ) {
         current = current->next;
     }
 
     // Insert the element
-    ListNode *tempNode = newListNode( current->data, current->next );
-    current->data = data;
-    current->next = tempNode;
-    list->size += 1;
+    ListNode *newNode = newListNode( data, NULL );
+    linkBefore( list, current, newNode );
+    list->finger = newNode;
 }
 
 /*
@@ -76,7 +209,7 @@ void listInsert( LList *list, void *data ) {
  * data -- The data to remove from the list
  *
  * Returns:
- * The element that was removed from the list
+ * The element that was removed from the list, or NULL if it couldn't be found
  */
 void *listRemove( LList *list, void *data ) {
     // You cannot remove NULL from the list
@@ -84,24 +217,14 @@ void *listRemove( LList *list, void *data ) {
         return NULL;
     }
 
-    ListNode *current = list->head;
-    ComparisonFunction compare = list->comparisonFunction;
+    ListNode *node = findNode( list, data );
 
-    // Determine where the data will be inserted
-    while( current->next != NULL && compare(current->data, data) != 0 ) {
-        current = current->next;
+    // The data isn't present in the list
+    if( node == NULL ) {
+        return NULL;
     }
 
-    // Remove the element
-    void *elementRemoved = current->data;
-    ListNode *temp = current->next;
-    current->data = temp->data;
-    current->next = temp->next;
-
-    free( temp );
-
-    list->size -= 1;
-    return elementRemoved;
+    return unlinkNode( list, node );
 }
 
 /*
@@ -115,19 +238,79 @@ void *listRemove( LList *list, void *data ) {
  * The Node containing the desired data, or NULL if it can't be found
  */
 ListNode *listFind( LList *list, void *data ) {
-    ListNode *current = list->head;
-    ComparisonFunction compare = list->comparisonFunction;
+    return findNode( list, data );
+}
 
-    while( current->next != NULL && compare( current->data, data ) != 0 ) {
-        current = current->next;
+/*
+ * Adds the element to the back of the list in O(1) time. This ignores the ordering of sorted lists,
+ * so it should only be used on unsorted lists.
+ *
+ * Arguments:
+ * list -- The list to add the element to
+ * data -- The data to add to the list
+ */
+void listPushBack( LList *list, void *data ) {
+    if( data != NULL ) {
+        linkBefore( list, list->tail, newListNode(data, NULL) );
     }
+}
 
-    // If the data in current isn't equal to the data we're trying to find, return NULL
-    if( compare( current->data, data ) != 0 ) {
+/*
+ * Adds the element to the front of the list in O(1) time. This ignores the ordering of sorted
+ * lists, so it should only be used on unsorted lists.
+ *
+ * Arguments:
+ * list -- The list to add the element to
+ * data -- The data to add to the list
+ */
+void listPushFront( LList *list, void *data ) {
+    if( data != NULL ) {
+        linkBefore( list, list->head, newListNode(data, NULL) );
+    }
+}
+
+/*
+ * Removes the first element in the list in O(1) time.
+ *
+ * Arguments:
+ * list -- The list to remove the element from
+ *
+ * Returns:
+ * The element that was at the front of the list, or NULL if the list is empty
+ */
+void *listPopFront( LList *list ) {
+    return listRemoveNode( list, list->head );
+}
+
+/*
+ * Removes the last element in the list in O(1) time.
+ *
+ * Arguments:
+ * list -- The list to remove the element from
+ *
+ * Returns:
+ * The element that was at the back of the list, or NULL if the list is empty
+ */
+void *listPopBack( LList *list ) {
+    return listRemoveNode( list, list->tail->prev );
+}
+
+/*
+ * Removes the supplied node from the list in O(1) time and frees it.
+ *
+ * Arguments:
+ * list -- The list that contains the node
+ * node -- The node to remove from the list
+ *
+ * Returns:
+ * The element that was contained in the node, or NULL if the node is NULL or the list's tail
+ */
+void *listRemoveNode( LList *list, ListNode *node ) {
+    if( node == NULL || node == list->tail ) {
         return NULL;
-    } else {
-        return current;
     }
+
+    return unlinkNode( list, node );
 }
 
 /*
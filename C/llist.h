@@ -1,15 +1,30 @@
 #ifndef LLIST_H
 #define LLIST_H
 
-typedef int (*ComparisonFunction)(void *, void *);
+#include "functions.h"
 
 typedef struct ListNode {
     void *data;
     struct ListNode *next;
+    struct ListNode *prev;
 } ListNode;
 
+/*
+ * A doubly linked list that always ends with a terminating NULL node, which is also the list's
+ * tail. The head is the first node in the list, and is the tail when the list is empty.
+ *
+ * A list created with a comparison function is kept sorted. The finger is the node most recently
+ * visited by an insertion, removal, or search. Searches for data that is not smaller than the
+ * finger's data resume from the finger rather than from the head, which makes ascending streams of
+ * operations amortized O(1) each.
+ *
+ * A list created without a comparison function is unsorted. Insertions append to the back of the
+ * list and elements are found and removed by pointer equality, which makes it usable as a queue.
+ */
 typedef struct LList {
     ListNode *head;
+    ListNode *tail;
+    ListNode *finger;
     int size;
     ComparisonFunction comparisonFunction;
 } LList;
@@ -30,13 +45,18 @@ extern ListNode *newListNode( void* data, ListNode *next );
 /*
  * Creates a list that starts with a NULL node.
  *
+ * Arguments:
+ * comparisonFunction -- The function used to keep the list sorted. If this is NULL, the list will
+ *                       be unsorted.
+ *
  * Returns:
  * The newly allocated linked list
  */
-extern LList *newList();
+extern LList *newList( ComparisonFunction comparisonFunction );
 
 /*
- * Inserts the element into the list.
+ * Inserts the element into the list. Sorted lists insert the element in its ordinal position, while
+ * unsorted lists append it to the back of the list.
  *
  * Arguments:
  * list -- The to add the element into
@@ -52,7 +72,7 @@ extern void listInsert( LList *list, void *data );
  * data -- The data to remove from the list
  *
  * Returns:
- * The element that was removed from the list
+ * The element that was removed from the list, or NULL if it couldn't be found
  */
 extern void *listRemove( LList *list, void *data );
 
@@ -68,6 +88,60 @@ extern void *listRemove( LList *list, void *data );
  */
 extern ListNode *listFind( LList *list, void *data );
 
+/*
+ * Adds the element to the back of the list in O(1) time. This ignores the ordering of sorted lists,
+ * so it should only be used on unsorted lists.
+ *
+ * Arguments:
+ * list -- The list to add the element to
+ * data -- The data to add to the list
+ */
+extern void listPushBack( LList *list, void *data );
+
+/*
+ * Adds the element to the front of the list in O(1) time. This ignores the ordering of sorted
+ * lists, so it should only be used on unsorted lists.
+ *
+ * Arguments:
+ * list -- The list to add the element to
+ * data -- The data to add to the list
+ */
+extern void listPushFront( LList *list, void *data );
+
+/*
+ * Removes the first element in the list in O(1) time.
+ *
+ * Arguments:
+ * list -- The list to remove the element from
+ *
+ * Returns:
+ * The element that was at the front of the list, or NULL if the list is empty
+ */
+extern void *listPopFront( LList *list );
+
+/*
+ * Removes the last element in the list in O(1) time.
+ *
+ * Arguments:
+ * list -- The list to remove the element from
+ *
+ * Returns:
+ * The element that was at the back of the list, or NULL if the list is empty
+ */
+extern void *listPopBack( LList *list );
+
+/*
+ * Removes the supplied node from the list in O(1) time and frees it.
+ *
+ * Arguments:
+ * list -- The list that contains the node
+ * node -- The node to remove from the list
+ *
+ * Returns:
+ * The element that was contained in the node, or NULL if the node is NULL or the list's tail
+ */
+extern void *listRemoveNode( LList *list, ListNode *node );
+
 /*
  * Frees the list and the nodes in the list
  *
@@ -0,0 +1,399 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "persistentbst.h"
+#include "utils.h"
+
+/* Implementation specific helper functions */
+PersistentBST *newVersion( PersistentBST *version, PersistentNode *root, int size );
+PersistentNode *newPersistentNode( void *data, PersistentNode *left, PersistentNode *right );
+PersistentNode *retainNode( PersistentNode *node );
+void releaseNode( PersistentNode *node );
+uint64_t elementPriority( void *data );
+PersistentNode *insertNode( PersistentNode *node, void *element, ComparisonFunction compare );
+PersistentNode *removeNode( PersistentNode *node, void *element, ComparisonFunction compare );
+PersistentNode *mergeNodes( PersistentNode *less, PersistentNode *greater );
+void persistentElementsHelper( PersistentNode *node, void **elements, int *index );
+
+/*
+ * Creates a new, empty persistent tree.
+ *
+ * Arguments:
+ * comparisonFunction -- A function that will be used to order the inserted elements
+ *
+ * Returns:
+ * An empty version, or NULL if the comparison function is NULL
+ */
+PersistentBST *newPersistentBST( ComparisonFunction comparisonFunction ) {
+    if( comparisonFunction == NULL ) {
+        return NULL;
+    }
+
+    PersistentBST *version = malloc( sizeof(PersistentBST) );
+    version->root = NULL;
+    version->comparisonFunction = comparisonFunction;
+    version->size = 0;
+
+    return version;
+}
+
+/*
+ * Creates a version handle for a root. The handle takes over the caller's reference to the root.
+ *
+ * Arguments:
+ * version -- The version the new one is derived from
+ * root    -- The root of the new version
+ * size    -- The number of elements in the new version
+ *
+ * Returns:
+ * The new version
+ */
+PersistentBST *newVersion( PersistentBST *version, PersistentNode *root, int size ) {
+    PersistentBST *next = malloc( sizeof(PersistentBST) );
+    next->root = root;
+    next->comparisonFunction = version->comparisonFunction;
+    next->size = size;
+
+    return next;
+}
+
+/*
+ * Allocates a node. The node takes over the caller's references to its children.
+ *
+ * Arguments:
+ * data  -- The element held by the node
+ * left  -- The node's left child
+ * right -- The node's right child
+ *
+ * Returns:
+ * A node with a reference count of one
+ */
+PersistentNode *newPersistentNode( void *data, PersistentNode *left, PersistentNode *right ) {
+    PersistentNode *node = malloc( sizeof(PersistentNode) );
+    node->data = data;
+    node->left = left;
+    node->right = right;
+    node->refCount = 1;
+
+    return node;
+}
+
+/*
+ * Adds a reference to a node.
+ *
+ * Arguments:
+ * node -- The node being referenced, which may be NULL
+ *
+ * Returns:
+ * The node
+ */
+PersistentNode *retainNode( PersistentNode *node ) {
+    if( node != NULL ) {
+        __atomic_add_fetch( &node->refCount, 1, __ATOMIC_RELAXED );
+    }
+
+    return node;
+}
+
+/*
+ * Drops a reference to a node, freeing it and any of its descendants that are no longer
+ * referenced. Nodes waiting to be freed are chained through their data fields, which are no longer
+ * needed, so no recursion or extra memory is needed however many nodes are freed.
+ *
+ * Arguments:
+ * node -- The node whose reference is being dropped, which may be NULL
+ */
+void releaseNode( PersistentNode *node ) {
+    if( node == NULL || __atomic_sub_fetch( &node->refCount, 1, __ATOMIC_ACQ_REL ) != 0 ) {
+        return;
+    }
+
+    node->data = NULL;
+    PersistentNode *pending = node;
+
+    while( pending != NULL ) {
+        PersistentNode *current = pending;
+        pending = current->data;
+
+        PersistentNode *children[] = { current->left, current->right };
+        for( int i = 0; i < 2; i++ ) {
+            PersistentNode *child = children[i];
+
+            if( child && __atomic_sub_fetch( &child->refCount, 1, __ATOMIC_ACQ_REL ) == 0 ) {
+                child->data = pending;
+                pending = child;
+            }
+        }
+
+        free( current );
+    }
+}
+
+/*
+ * Derives an element's treap priority by mixing the bits of its address. Every copy of a node
+ * holds the same element, so copies always share a priority.
+ *
+ * Arguments:
+ * data -- The element whose priority is being computed
+ *
+ * Returns:
+ * The element's priority
+ */
+uint64_t elementPriority( void *data ) {
+    return mixHash( (uint64_t) (uintptr_t) data );
+}
+
+/*
+ * Takes a snapshot of a version in O(1) time. The snapshot shares the whole tree with the version
+ * and must be released separately.
+ *
+ * Arguments:
+ * version -- The version being snapshotted
+ *
+ * Returns:
+ * A new version with the same elements
+ */
+PersistentBST *persistentBSTSnapshot( PersistentBST *version ) {
+    return newVersion( version, retainNode( version->root ), version->size );
+}
+
+/*
+ * Creates a version with an element added. The supplied version is unchanged. If an equivalent
+ * element is already present, the new version is a snapshot of the supplied one.
+ *
+ * Arguments:
+ * version -- The version the element is being added to
+ * element -- The element to add. NULL elements are not added.
+ *
+ * Returns:
+ * A new version containing the element
+ */
+PersistentBST *persistentBSTInsert( PersistentBST *version, void *element ) {
+    if( element == NULL ) {
+        debug( E_WARNING, "Cannot add a NULL element to the persistent tree!\n" );
+        return persistentBSTSnapshot( version );
+    }
+
+    if( persistentBSTFind( version, element ) ) {
+        return persistentBSTSnapshot( version );
+    }
+
+    PersistentNode *root = insertNode( version->root, element, version->comparisonFunction );
+    return newVersion( version, root, version->size + 1 );
+}
+
+/*
+ * Copies the path from a subtree's root down to where a new element belongs, and hangs a new leaf
+ * holding the element at the end of it. On the way back up, the new node is rotated above any
+ * copied parent with a lower priority. Only freshly copied nodes are ever rotated or modified.
+ *
+ * Arguments:
+ * node    -- The root of the subtree, which must not contain an equivalent element
+ * element -- The element being added
+ * compare -- The function used to order the elements
+ *
+ * Returns:
+ * The root of the new subtree, which the caller holds the only reference to
+ */
+PersistentNode *insertNode( PersistentNode *node, void *element, ComparisonFunction compare ) {
+    if( node == NULL ) {
+        return newPersistentNode( element, NULL, NULL );
+    }
+
+    if( compare( element, node->data ) < 0 ) {
+        PersistentNode *left = insertNode( node->left, element, compare );
+        PersistentNode *copy = newPersistentNode( node->data, left, retainNode( node->right ) );
+
+        if( elementPriority( left->data ) > elementPriority( copy->data ) ) {
+            copy->left = left->right;
+            left->right = copy;
+            return left;
+        }
+
+        return copy;
+    } else {
+        PersistentNode *right = insertNode( node->right, element, compare );
+        PersistentNode *copy = newPersistentNode( node->data, retainNode( node->left ), right );
+
+        if( elementPriority( right->data ) > elementPriority( copy->data ) ) {
+            copy->right = right->left;
+            right->left = copy;
+            return right;
+        }
+
+        return copy;
+    }
+}
+
+/*
+ * Creates a version with an element removed. The supplied version is unchanged and still contains
+ * the element, so the element is not freed.
+ *
+ * Arguments:
+ * version -- The version the element is being removed from
+ * element -- The element to remove
+ * removed -- If this is not NULL, the removed element is written here, or NULL if there was no
+ *            equivalent element
+ *
+ * Returns:
+ * A new version without the element
+ */
+PersistentBST *persistentBSTRemove( PersistentBST *version, void *element, void **removed ) {
+    void *found = persistentBSTFind( version, element );
+
+    if( removed != NULL ) {
+        *removed = found;
+    }
+
+    if( found == NULL ) {
+        return persistentBSTSnapshot( version );
+    }
+
+    PersistentNode *root = removeNode( version->root, element, version->comparisonFunction );
+    return newVersion( version, root, version->size - 1 );
+}
+
+/*
+ * Copies the path from a subtree's root down to an element, and replaces the element's node with
+ * the merge of its children.
+ *
+ * Arguments:
+ * node    -- The root of the subtree, which must contain an equivalent element
+ * element -- The element being removed
+ * compare -- The function used to order the elements
+ *
+ * Returns:
+ * The root of the new subtree, which the caller holds a reference to
+ */
+PersistentNode *removeNode( PersistentNode *node, void *element, ComparisonFunction compare ) {
+    int comparisonResult = compare( element, node->data );
+
+    if( comparisonResult == 0 ) {
+        return mergeNodes( node->left, node->right );
+    } else if( comparisonResult < 0 ) {
+        return newPersistentNode( node->data, removeNode( node->left, element, compare ),
+                retainNode( node->right ) );
+    } else {
+        return newPersistentNode( node->data, retainNode( node->left ),
+                removeNode( node->right, element, compare ) );
+    }
+}
+
+/*
+ * Merges two subtrees where every element of the first is less than every element of the second.
+ * The nodes along the facing spines are copied and interleaved by priority.
+ *
+ * Arguments:
+ * less    -- The subtree holding the lesser elements
+ * greater -- The subtree holding the greater elements
+ *
+ * Returns:
+ * The root of the merged subtree, which the caller holds a reference to
+ */
+PersistentNode *mergeNodes( PersistentNode *less, PersistentNode *greater ) {
+    if( less == NULL ) {
+        return retainNode( greater );
+    } else if( greater == NULL ) {
+        return retainNode( less );
+    }
+
+    if( elementPriority( less->data ) > elementPriority( greater->data ) ) {
+        return newPersistentNode( less->data, retainNode( less->left ),
+                mergeNodes( less->right, greater ) );
+    } else {
+        return newPersistentNode( greater->data, mergeNodes( less, greater->left ),
+                retainNode( greater->right ) );
+    }
+}
+
+/*
+ * Searches a version for an element.
+ *
+ * Arguments:
+ * version -- The version to search through
+ * element -- The element that is being searched for
+ *
+ * Returns:
+ * The element in the version equivalent to the one searched for, or NULL if there is none
+ */
+void *persistentBSTFind( PersistentBST *version, void *element ) {
+    PersistentNode *current = version->root;
+    ComparisonFunction compare = version->comparisonFunction;
+
+    while( current != NULL ) {
+        int comparisonResult = compare( element, current->data );
+
+        if( comparisonResult == 0 ) {
+            return current->data;
+        }
+
+        current = comparisonResult < 0 ? current->left : current->right;
+    }
+
+    return NULL;
+}
+
+/*
+ * Creates an array of the elements in a version, in order.
+ *
+ * Arguments:
+ * version -- The version whose elements are being copied into an array
+ *
+ * Returns:
+ * An array containing the version's elements
+ */
+void **persistentBSTElements( PersistentBST *version ) {
+    void **elements = malloc( sizeof(void *) * (version->size > 0 ? version->size : 1) );
+    int index = 0;
+
+    persistentElementsHelper( version->root, elements, &index );
+    return elements;
+}
+
+/*
+ * Copies the elements of a subtree into an array with an in-order walk. The treap keeps the depth
+ * logarithmic in expectation, so the recursion stays shallow.
+ *
+ * Arguments:
+ * node     -- The root of the subtree
+ * elements -- The array the elements are copied into
+ * index    -- The position in the array that the next element is copied to
+ */
+void persistentElementsHelper( PersistentNode *node, void **elements, int *index ) {
+    if( node != NULL ) {
+        persistentElementsHelper( node->left, elements, index );
+        elements[ (*index)++ ] = node->data;
+        persistentElementsHelper( node->right, elements, index );
+    }
+}
+
+/*
+ * Frees a version along with its elements. Nodes that are still shared with other versions are
+ * kept. This should only be used on the last version holding the elements, since any other
+ * version sharing an element would be left pointing at freed memory.
+ *
+ * Arguments:
+ * version -- The version that is being freed
+ */
+void persistentBSTFree( PersistentBST *version ) {
+    void **elements = persistentBSTElements( version );
+
+    for( int i = 0; i < version->size; i++ ) {
+        free( elements[i] );
+    }
+
+    free( elements );
+    persistentBSTFreeStructure( version );
+}
+
+/*
+ * Releases a version without freeing its elements. Nodes that are no longer part of any version
+ * are freed.
+ *
+ * Arguments:
+ * version -- The version that is being released
+ */
+void persistentBSTFreeStructure( PersistentBST *version ) {
+    releaseNode( version->root );
+    free( version );
+}
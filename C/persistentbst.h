@@ -0,0 +1,127 @@
+#ifndef PERSISTENTBST_H
+#define PERSISTENTBST_H
+
+#include "functions.h"
+
+/*
+ * A node of a persistent tree. Nodes are never modified once a version that contains them has been
+ * returned, so they can be shared by any number of versions. The reference count is the number of
+ * versions and parent nodes that point at the node, and is updated atomically. Because a node can
+ * have many parents, there is no parent pointer.
+ */
+typedef struct PersistentNode {
+    void *data;
+    struct PersistentNode *left;
+    struct PersistentNode *right;
+    int refCount;
+} PersistentNode;
+
+/*
+ * One version of a persistent binary search tree. Updates never change an existing version: they
+ * copy the nodes on the path to the change and return a new version that shares every other node
+ * with the old one. The tree is kept balanced as a treap whose priorities are derived from the
+ * elements' addresses, so an update allocates O(log n) nodes in expectation.
+ *
+ * Versions are immutable, so any number of threads may read, snapshot, update, and release them at
+ * the same time. The elements are shared between versions, and are only freed by persistentBSTFree.
+ */
+typedef struct PersistentBST {
+    PersistentNode *root;
+    ComparisonFunction comparisonFunction;
+    int size;
+} PersistentBST;
+
+/*
+ * Creates a new, empty persistent tree.
+ *
+ * Arguments:
+ * comparisonFunction -- A function that will be used to order the inserted elements
+ *
+ * Returns:
+ * An empty version, or NULL if the comparison function is NULL
+ */
+extern PersistentBST *newPersistentBST( ComparisonFunction comparisonFunction );
+
+/*
+ * Takes a snapshot of a version in O(1) time. The snapshot shares the whole tree with the version
+ * and must be released separately.
+ *
+ * Arguments:
+ * version -- The version being snapshotted
+ *
+ * Returns:
+ * A new version with the same elements
+ */
+extern PersistentBST *persistentBSTSnapshot( PersistentBST *version );
+
+/*
+ * Creates a version with an element added. The supplied version is unchanged. If an equivalent
+ * element is already present, the new version is a snapshot of the supplied one.
+ *
+ * Arguments:
+ * version -- The version the element is being added to
+ * element -- The element to add. NULL elements are not added.
+ *
+ * Returns:
+ * A new version containing the element
+ */
+extern PersistentBST *persistentBSTInsert( PersistentBST *version, void *element );
+
+/*
+ * Creates a version with an element removed. The supplied version is unchanged and still contains
+ * the element, so the element is not freed.
+ *
+ * Arguments:
+ * version -- The version the element is being removed from
+ * element -- The element to remove
+ * removed -- If this is not NULL, the removed element is written here, or NULL if there was no
+ *            equivalent element
+ *
+ * Returns:
+ * A new version without the element
+ */
+extern PersistentBST *persistentBSTRemove( PersistentBST *version, void *element, void **removed );
+
+/*
+ * Searches a version for an element.
+ *
+ * Arguments:
+ * version -- The version to search through
+ * element -- The element that is being searched for
+ *
+ * Returns:
+ * The element in the version equivalent to the one searched for, or NULL if there is none
+ */
+extern void *persistentBSTFind( PersistentBST *version, void *element );
+
+/*
+ * Creates an array of the elements in a version, in order.
+ *
+ * Arguments:
+ * version -- The version whose elements are being copied into an array
+ *
+ * Returns:
+ * An array containing the version's elements
+ */
+extern void **persistentBSTElements( PersistentBST *version );
+
+/*
+ * Frees a version along with its elements. Nodes that are still shared with other versions are
+ * kept. This should only be used on the last version holding the elements, since any other
+ * version sharing an element would be left pointing at freed memory.
+ *
+ * Arguments:
+ * version -- The version that is being freed
+ */
+extern void persistentBSTFree( PersistentBST *version );
+
+/*
+ * Releases a version without freeing its elements. Nodes that are no longer part of any version
+ * are freed.
+ *
+ * Arguments:
+ * version -- The version that is being released
+ */
+extern void persistentBSTFreeStructure( PersistentBST *version );
+
+#endif
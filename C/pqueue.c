@@ -0,0 +1,333 @@
+#include <stdlib.h>
+
+#include "pqueue.h"
+#include "utils.h"
+
+#define PQ_INITIAL_CAPACITY 16
+
+/* Implementation specific helper functions */
+void placeHandle( PriorityQueue *pq, PQHandle *handle, int index );
+void siftUp( PriorityQueue *pq, int index );
+void siftDown( PriorityQueue *pq, int index );
+
+/*
+ * Creates a new, empty priority queue with the default arity.
+ *
+ * Arguments:
+ * comparisonFunction -- The function used to order elements within the queue
+ *
+ * Returns:
+ * An empty priority queue, or NULL if the comparison function is NULL
+ */
+PriorityQueue *newPriorityQueue( ComparisonFunction comparisonFunction ) {
+    return newPriorityQueueWithArity( comparisonFunction, PQ_DEFAULT_ARITY );
+}
+
+/*
+ * Creates a new, empty priority queue where every node in the heap has the supplied number of
+ * children.
+ *
+ * Arguments:
+ * comparisonFunction -- The function used to order elements within the queue
+ * arity              -- The number of children per heap node. This must be at least 2.
+ *
+ * Returns:
+ * An empty priority queue, or NULL if the comparison function is NULL or the arity is invalid
+ */
+PriorityQueue *newPriorityQueueWithArity( ComparisonFunction comparisonFunction, int arity ) {
+    if( comparisonFunction == NULL || arity < 2 ) {
+        return NULL;
+    }
+
+    PriorityQueue *pq = malloc( sizeof(PriorityQueue) );
+    pq->heap = newVector( PQ_INITIAL_CAPACITY );
+    pq->arity = arity;
+    pq->comparisonFunction = comparisonFunction;
+
+    return pq;
+}
+
+/*
+ * Creates a priority queue containing every element in the supplied vector. The heap is built
+ * bottom-up in O(n) time. The vector itself is not modified.
+ *
+ * Arguments:
+ * vector             -- The vector whose elements will be placed in the queue
+ * comparisonFunction -- The function used to order elements within the queue
+ * arity              -- The number of children per heap node. This must be at least 2.
+ *
+ * Returns:
+ * A priority queue containing the vector's elements, or NULL if the arguments are invalid
+ */
+PriorityQueue *newPriorityQueueFromVector( Vector *vector,
+        ComparisonFunction comparisonFunction, int arity ) {
+    PriorityQueue *pq = newPriorityQueueWithArity( comparisonFunction, arity );
+
+    if( pq == NULL || vector == NULL ) {
+        return pq;
+    }
+
+    // Removals can leave holes in a vector, so every slot has to be checked
+    for( int i = 0; i < vector->capacity; i++ ) {
+        void *element = vector->elements[i];
+
+        if( element != NULL ) {
+            PQHandle *handle = malloc( sizeof(PQHandle) );
+            handle->data = element;
+            handle->index = pq->heap->size;
+            vectorAdd( pq->heap, handle );
+        }
+    }
+
+    // Sift down every internal node, starting from the last one
+    int size = pq->heap->size;
+    for( int i = (size - 2) / arity; size > 1 && i >= 0; i-- ) {
+        siftDown( pq, i );
+    }
+
+    return pq;
+}
+
+/*
+ * Stores a handle at an index in the heap and records that index in the handle.
+ *
+ * Arguments:
+ * pq     -- The queue whose heap is being modified
+ * handle -- The handle being stored
+ * index  -- The position the handle is being stored at
+ */
+void placeHandle( PriorityQueue *pq, PQHandle *handle, int index ) {
+    pq->heap->elements[index] = handle;
+    handle->index = index;
+}
+
+/*
+ * Moves the handle at the supplied index towards the root until its parent is not larger than it.
+ *
+ * Arguments:
+ * pq    -- The queue whose heap is being ordered
+ * index -- The index of the handle to move
+ */
+void siftUp( PriorityQueue *pq, int index ) {
+    void **elements = pq->heap->elements;
+    PQHandle *handle = elements[index];
+    ComparisonFunction compare = pq->comparisonFunction;
+
+    // Shift parents down into the hole rather than swapping at every level
+    while( index > 0 ) {
+        int parentIndex = (index - 1) / pq->arity;
+        PQHandle *parent = elements[parentIndex];
+
+        if( compare( handle->data, parent->data ) >= 0 ) {
+            break;
+        }
+
+        placeHandle( pq, parent, index );
+        index = parentIndex;
+    }
+
+    placeHandle( pq, handle, index );
+}
+
+/*
+ * Moves the handle at the supplied index towards the leaves until none of its children are smaller
+ * than it.
+ *
+ * Arguments:
+ * pq    -- The queue whose heap is being ordered
+ * index -- The index of the handle to move
+ */
+void siftDown( PriorityQueue *pq, int index ) {
+    void **elements = pq->heap->elements;
+    int size = pq->heap->size;
+    PQHandle *handle = elements[index];
+    ComparisonFunction compare = pq->comparisonFunction;
+
+    while( 1 ) {
+        int firstChild = index * pq->arity + 1;
+
+        if( firstChild >= size ) {
+            break;
+        }
+
+        // Find the smallest of the children, which are stored contiguously
+        int lastChild = firstChild + pq->arity;
+        if( lastChild > size ) {
+            lastChild = size;
+        }
+
+        int smallestIndex = firstChild;
+        PQHandle *smallest = elements[firstChild];
+        for( int i = firstChild + 1; i < lastChild; i++ ) {
+            PQHandle *child = elements[i];
+
+            if( compare( child->data, smallest->data ) < 0 ) {
+                smallest = child;
+                smallestIndex = i;
+            }
+        }
+
+        if( compare( smallest->data, handle->data ) >= 0 ) {
+            break;
+        }
+
+        placeHandle( pq, smallest, index );
+        index = smallestIndex;
+    }
+
+    placeHandle( pq, handle, index );
+}
+
+/*
+ * Adds an element to the queue in O(log n) time.
+ *
+ * Arguments:
+ * pq   -- The queue to add the element to
+ * data -- The element to add. NULL elements are not added.
+ *
+ * Returns:
+ * A handle to the element that can be used with pqDecreaseKey and pqRemove, or NULL if the element
+ * was not added
+ */
+PQHandle *pqPush( PriorityQueue *pq, void *data ) {
+    if( data == NULL ) {
+        debug( E_WARNING, "Cannot add a NULL element to the priority queue!\n" );
+        return NULL;
+    }
+
+    PQHandle *handle = malloc( sizeof(PQHandle) );
+    handle->data = data;
+    handle->index = pq->heap->size;
+
+    vectorAdd( pq->heap, handle );
+    siftUp( pq, handle->index );
+
+    return handle;
+}
+
+/*
+ * Returns the smallest element in the queue in O(1) time without removing it.
+ *
+ * Arguments:
+ * pq -- The queue to examine
+ *
+ * Returns:
+ * The smallest element in the queue, or NULL if the queue is empty
+ */
+void *pqPeek( PriorityQueue *pq ) {
+    if( pqIsEmpty( pq ) ) {
+        return NULL;
+    }
+
+    PQHandle *root = pq->heap->elements[0];
+    return root->data;
+}
+
+/*
+ * Removes the smallest element from the queue in O(log n) time.
+ *
+ * Arguments:
+ * pq -- The queue to remove the element from
+ *
+ * Returns:
+ * The smallest element in the queue, or NULL if the queue is empty
+ */
+void *pqPop( PriorityQueue *pq ) {
+    if( pqIsEmpty( pq ) ) {
+        return NULL;
+    }
+
+    return pqRemove( pq, pq->heap->elements[0] );
+}
+
+/*
+ * Restores the heap ordering after the element referred to by the handle has been modified so that
+ * it compares as smaller than it previously did.
+ *
+ * Arguments:
+ * pq     -- The queue containing the handle
+ * handle -- The handle whose element has decreased
+ */
+void pqDecreaseKey( PriorityQueue *pq, PQHandle *handle ) {
+    siftUp( pq, handle->index );
+}
+
+/*
+ * Removes the element referred to by the handle from the queue in O(log n) time. The handle is no
+ * longer valid after this call.
+ *
+ * Arguments:
+ * pq     -- The queue containing the handle
+ * handle -- The handle whose element should be removed
+ *
+ * Returns:
+ * The element that was removed
+ */
+void *pqRemove( PriorityQueue *pq, PQHandle *handle ) {
+    int index = handle->index;
+    void *data = handle->data;
+    PQHandle *last = vectorRemove( pq->heap, pq->heap->size - 1 );
+
+    // Move the last handle into the hole and restore the ordering in whichever direction it needs
+    if( last != handle ) {
+        placeHandle( pq, last, index );
+        siftDown( pq, index );
+        siftUp( pq, last->index );
+    }
+
+    free( handle );
+    return data;
+}
+
+/*
+ * Returns the number of elements in the queue.
+ *
+ * Arguments:
+ * pq -- The queue whose size is being retrieved
+ *
+ * Returns:
+ * The number of elements in the queue
+ */
+int pqSize( PriorityQueue *pq ) {
+    return pq->heap->size;
+}
+
+/*
+ * Returns whether or not the queue is empty.
+ *
+ * Arguments:
+ * pq -- The queue to check for emptiness
+ *
+ * Returns:
+ * 1 in the case that the queue is empty, 0 otherwise.
+ */
+int pqIsEmpty( PriorityQueue *pq ) {
+    return vectorIsEmpty( pq->heap );
+}
+
+/*
+ * Frees the queue, its handles, and the elements within it.
+ *
+ * Arguments:
+ * pq -- The queue that is being freed
+ */
+void pqFree( PriorityQueue *pq ) {
+    for( int i = 0; i < pq->heap->size; i++ ) {
+        PQHandle *handle = pq->heap->elements[i];
+        free( handle->data );
+    }
+
+    pqFreeStructure( pq );
+}
+
+/*
+ * Frees the structural memory of the queue without freeing the elements within it.
+ *
+ * Arguments:
+ * pq -- The queue whose structural memory is being freed
+ */
+void pqFreeStructure( PriorityQueue *pq ) {
+    // The handles are owned by the queue, so the vector's free can release them
+    freeVector( pq->heap );
+    free( pq );
+}
@@ -0,0 +1,167 @@
+#ifndef PQUEUE_H
+#define PQUEUE_H
+
+#include "functions.h"
+#include "vector.h"
+
+/* Four children per node keeps siblings within a single cache line */
+#define PQ_DEFAULT_ARITY 4
+
+/*
+ * A handle refers to an element inside of a priority queue. Handles are returned when elements are
+ * pushed and remain valid until the element is popped or removed from the queue.
+ *
+ * data  -- The element referred to by this handle
+ * index -- The current position of the handle within the heap
+ */
+typedef struct PQHandle {
+    void *data;
+    int index;
+} PQHandle;
+
+/*
+ * A priority queue is a d-ary min-heap of handles stored in a vector. The element that compares as
+ * the smallest according to the comparison function is at the front of the queue.
+ */
+typedef struct PriorityQueue {
+    Vector *heap;
+    int arity;
+    ComparisonFunction comparisonFunction;
+} PriorityQueue;
+
+/*
+ * Creates a new, empty priority queue with the default arity.
+ *
+ * Arguments:
+ * comparisonFunction -- The function used to order elements within the queue
+ *
+ * Returns:
+ * An empty priority queue, or NULL if the comparison function is NULL
+ */
+extern PriorityQueue *newPriorityQueue( ComparisonFunction comparisonFunction );
+
+/*
+ * Creates a new, empty priority queue where every node in the heap has the supplied number of
+ * children.
+ *
+ * Arguments:
+ * comparisonFunction -- The function used to order elements within the queue
+ * arity              -- The number of children per heap node. This must be at least 2.
+ *
+ * Returns:
+ * An empty priority queue, or NULL if the comparison function is NULL or the arity is invalid
+ */
+extern PriorityQueue *newPriorityQueueWithArity( ComparisonFunction comparisonFunction, int arity );
+
+/*
+ * Creates a priority queue containing every element in the supplied vector. The heap is built
+ * bottom-up in O(n) time. The vector itself is not modified.
+ *
+ * Arguments:
+ * vector             -- The vector whose elements will be placed in the queue
+ * comparisonFunction -- The function used to order elements within the queue
+ * arity              -- The number of children per heap node. This must be at least 2.
+ *
+ * Returns:
+ * A priority queue containing the vector's elements, or NULL if the arguments are invalid
+ */
+extern PriorityQueue *newPriorityQueueFromVector( Vector *vector,
+        ComparisonFunction comparisonFunction, int arity );
+
+/*
+ * Adds an element to the queue in O(log n) time.
+ *
+ * Arguments:
+ * pq   -- The queue to add the element to
+ * data -- The element to add. NULL elements are not added.
+ *
+ * Returns:
+ * A handle to the element that can be used with pqDecreaseKey and pqRemove, or NULL if the element
+ * was not added
+ */
+extern PQHandle *pqPush( PriorityQueue *pq, void *data );
+
+/*
+ * Returns the smallest element in the queue in O(1) time without removing it.
+ *
+ * Arguments:
+ * pq -- The queue to examine
+ *
+ * Returns:
+ * The smallest element in the queue, or NULL if the queue is empty
+ */
+extern void *pqPeek( PriorityQueue *pq );
+
+/*
+ * Removes the smallest element from the queue in O(log n) time.
+ *
+ * Arguments:
+ * pq -- The queue to remove the element from
+ *
+ * Returns:
+ * The smallest element in the queue, or NULL if the queue is empty
+ */
+extern void *pqPop( PriorityQueue *pq );
+
+/*
+ * Restores the heap ordering after the element referred to by the handle has been modified so that
+ * it compares as smaller than it previously did.
+ *
+ * Arguments:
+ * pq     -- The queue containing the handle
+ * handle -- The handle whose element has decreased
+ */
+extern void pqDecreaseKey( PriorityQueue *pq, PQHandle *handle );
+
+/*
+ * Removes the element referred to by the handle from the queue in O(log n) time. The handle is no
+ * longer valid after this call.
+ *
+ * Arguments:
+ * pq     -- The queue containing the handle
+ * handle -- The handle whose element should be removed
+ *
+ * Returns:
+ * The element that was removed
+ */
+extern void *pqRemove( PriorityQueue *pq, PQHandle *handle );
+
+/*
+ * Returns the number of elements in the queue.
+ *
+ * Arguments:
+ * pq -- The queue whose size is being retrieved
+ *
+ * Returns:
+ * The number of elements in the queue
+ */
+extern int pqSize( PriorityQueue *pq );
+
+/*
+ * Returns whether or not the queue is empty.
+ *
+ * Arguments:
+ * pq -- The queue to check for emptiness
+ *
+ * Returns:
+ * 1 in the case that the queue is empty, 0 otherwise.
+ */
+extern int pqIsEmpty( PriorityQueue *pq );
+
+/*
+ * Frees the queue, its handles, and the elements within it.
+ *
+ * Arguments:
+ * pq -- The queue that is being freed
+ */
+extern void pqFree( PriorityQueue *pq );
+
+/*
+ * Frees the structural memory of the queue without freeing the elements within it.
+ *
+ * Arguments:
+ * pq -- The queue whose structural memory is being freed
+ */
+extern void pqFreeStructure( PriorityQueue *pq );
+
+#endif
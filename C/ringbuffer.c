@@ -0,0 +1,348 @@
+#include <stdlib.h>
+
+#include "ringbuffer.h"
+#include "utils.h"
+
+/* Implementation specific helper functions */
+int spscEnqueueBatch( RingBuffer *ringBuffer, void **elements, int count );
+int spscDequeueBatch( RingBuffer *ringBuffer, void **elements, int maxCount );
+int mpmcEnqueue( RingBuffer *ringBuffer, void *element );
+void *mpmcDequeue( RingBuffer *ringBuffer );
+
+/*
+ * Creates a new, empty ring buffer.
+ *
+ * Arguments:
+ * capacity -- The minimum number of elements the buffer can hold. This is rounded up to the next
+ *             power of two.
+ * mode     -- Whether the buffer is single-producer/single-consumer or multi-producer/multi-consumer
+ *
+ * Returns:
+ * A newly allocated ring buffer, or NULL if the capacity is not positive
+ */
+RingBuffer *newRingBuffer( int capacity, RingBufferMode mode ) {
+    if( capacity <= 0 ) {
+        return NULL;
+    }
+
+    unsigned long roundedCapacity = 1;
+    while( roundedCapacity < (unsigned long) capacity ) {
+        roundedCapacity <<= 1;
+    }
+
+    RingBuffer *ringBuffer = malloc( sizeof(RingBuffer) );
+    ringBuffer->mode = mode;
+    ringBuffer->capacity = roundedCapacity;
+    ringBuffer->mask = roundedCapacity - 1;
+    ringBuffer->slots = malloc( sizeof(RingBufferSlot) * roundedCapacity );
+    ringBuffer->head = 0;
+    ringBuffer->cachedTail = 0;
+    ringBuffer->tail = 0;
+    ringBuffer->cachedHead = 0;
+
+    // A slot is ready to be written at position p when its sequence number is p
+    for( unsigned long i = 0; i < roundedCapacity; i++ ) {
+        ringBuffer->slots[i].sequence = i;
+        ringBuffer->slots[i].element = NULL;
+    }
+
+    return ringBuffer;
+}
+
+/*
+ * Attempts to add an element to the back of the buffer.
+ *
+ * Arguments:
+ * ringBuffer -- The buffer to add the element to
+ * element    -- The element to add. NULL elements cannot be added.
+ *
+ * Returns:
+ * 1 if the element was added, 0 if the buffer was full or the element was NULL
+ */
+int ringBufferEnqueue( RingBuffer *ringBuffer, void *element ) {
+    if( element == NULL ) {
+        debug( E_WARNING, "Cannot add a NULL element to the ring buffer!\n" );
+        return 0;
+    }
+
+    if( ringBuffer->mode == RING_BUFFER_SPSC ) {
+        return spscEnqueueBatch( ringBuffer, &element, 1 );
+    } else {
+        return mpmcEnqueue( ringBuffer, element );
+    }
+}
+
+/*
+ * Attempts to remove the element at the front of the buffer.
+ *
+ * Arguments:
+ * ringBuffer -- The buffer to remove the element from
+ *
+ * Returns:
+ * The element at the front of the buffer, or NULL if the buffer was empty
+ */
+void *ringBufferDequeue( RingBuffer *ringBuffer ) {
+    if( ringBuffer->mode == RING_BUFFER_SPSC ) {
+        void *element = NULL;
+        spscDequeueBatch( ringBuffer, &element, 1 );
+        return element;
+    } else {
+        return mpmcDequeue( ringBuffer );
+    }
+}
+
+/*
+ * Adds as many of the supplied elements to the buffer as will fit, in order. In RING_BUFFER_SPSC mode
+ * the whole batch is published with a single store. In RING_BUFFER_MPMC mode the elements are
+ * enqueued one at a time, so other producers' elements may be interleaved with the batch.
+ *
+ * Arguments:
+ * ringBuffer -- The buffer to add the elements to
+ * elements   -- The elements to add. None of them may be NULL.
+ * count      -- The number of elements to add. Nothing is added if this is not positive.
+ *
+ * Returns:
+ * The number of elements that were added, which is a prefix of the supplied elements
+ */
+int ringBufferEnqueueBatch( RingBuffer *ringBuffer, void **elements, int count ) {
+    // The single producer path compares the count against unsigned positions
+    if( count <= 0 ) {
+        return 0;
+    }
+
+    if( ringBuffer->mode == RING_BUFFER_SPSC ) {
+        return spscEnqueueBatch( ringBuffer, elements, count );
+    }
+
+    int added = 0;
+    while( added < count && mpmcEnqueue( ringBuffer, elements[added] ) ) {
+        added++;
+    }
+
+    return added;
+}
+
+/*
+ * Removes up to the supplied number of elements from the front of the buffer.
+ *
+ * Arguments:
+ * ringBuffer -- The buffer to remove the elements from
+ * elements   -- An array that the removed elements are written to
+ * maxCount   -- The maximum number of elements to remove. Nothing is removed if this is not
+ *               positive.
+ *
+ * Returns:
+ * The number of elements that were removed
+ */
+int ringBufferDequeueBatch( RingBuffer *ringBuffer, void **elements, int maxCount ) {
+    if( maxCount <= 0 ) {
+        return 0;
+    }
+
+    if( ringBuffer->mode == RING_BUFFER_SPSC ) {
+        return spscDequeueBatch( ringBuffer, elements, maxCount );
+    }
+
+    int removed = 0;
+    while( removed < maxCount && (elements[removed] = mpmcDequeue( ringBuffer )) != NULL ) {
+        removed++;
+    }
+
+    return removed;
+}
+
+/*
+ * Single producer enqueue. Only the producer writes the tail, so it can be read without
+ * synchronization. The head is only reloaded from the consumer when the cached copy says the buffer
+ * is full.
+ *
+ * Arguments:
+ * ringBuffer -- The buffer to add the elements to
+ * elements   -- The elements to add
+ * count      -- The number of elements to add
+ *
+ * Returns:
+ * The number of elements that were added
+ */
+int spscEnqueueBatch( RingBuffer *ringBuffer, void **elements, int count ) {
+    unsigned long tail = ringBuffer->tail;
+    unsigned long space = ringBuffer->capacity - (tail - ringBuffer->cachedHead);
+
+    if( space < (unsigned long) count ) {
+        ringBuffer->cachedHead = __atomic_load_n( &ringBuffer->head, __ATOMIC_ACQUIRE );
+        space = ringBuffer->capacity - (tail - ringBuffer->cachedHead);
+    }
+
+    unsigned long added = (unsigned long) count < space ? (unsigned long) count : space;
+    for( unsigned long i = 0; i < added; i++ ) {
+        ringBuffer->slots[ (tail + i) & ringBuffer->mask ].element = elements[i];
+    }
+
+    // Publishing the new tail makes every element written above visible to the consumer
+    __atomic_store_n( &ringBuffer->tail, tail + added, __ATOMIC_RELEASE );
+    return (int) added;
+}
+
+/*
+ * Single consumer dequeue. Only the consumer writes the head, so it can be read without
+ * synchronization. The tail is only reloaded from the producer when the cached copy says the buffer
+ * is empty.
+ *
+ * Arguments:
+ * ringBuffer -- The buffer to remove the elements from
+ * elements   -- An array that the removed elements are written to
+ * maxCount   -- The maximum number of elements to remove
+ *
+ * Returns:
+ * The number of elements that were removed
+ */
+int spscDequeueBatch( RingBuffer *ringBuffer, void **elements, int maxCount ) {
+    unsigned long head = ringBuffer->head;
+    unsigned long available = ringBuffer->cachedTail - head;
+
+    if( available < (unsigned long) maxCount ) {
+        ringBuffer->cachedTail = __atomic_load_n( &ringBuffer->tail, __ATOMIC_ACQUIRE );
+        available = ringBuffer->cachedTail - head;
+    }
+
+    unsigned long removed = (unsigned long) maxCount < available ?
+        (unsigned long) maxCount : available;
+    for( unsigned long i = 0; i < removed; i++ ) {
+        elements[i] = ringBuffer->slots[ (head + i) & ringBuffer->mask ].element;
+    }
+
+    // Publishing the new head hands the slots back to the producer
+    __atomic_store_n( &ringBuffer->head, head + removed, __ATOMIC_RELEASE );
+    return (int) removed;
+}
+
+/*
+ * Multi producer enqueue. A producer claims the tail position by advancing it with a
+ * compare-and-swap, but only once the slot's sequence number shows that consumers have finished with
+ * it. Storing a sequence number of position + 1 hands the slot to consumers.
+ *
+ * Arguments:
+ * ringBuffer -- The buffer to add the element to
+ * element    -- The element to add
+ *
+ * Returns:
+ * 1 if the element was added, 0 if the buffer was full
+ */
+int mpmcEnqueue( RingBuffer *ringBuffer, void *element ) {
+    unsigned long position = __atomic_load_n( &ringBuffer->tail, __ATOMIC_RELAXED );
+    RingBufferSlot *slot;
+
+    while( 1 ) {
+        slot = &ringBuffer->slots[ position & ringBuffer->mask ];
+        unsigned long sequence = __atomic_load_n( &slot->sequence, __ATOMIC_ACQUIRE );
+        long difference = (long) sequence - (long) position;
+
+        if( difference == 0 ) {
+            // The slot is free, so try to claim the position. On failure position is reloaded.
+            if( __atomic_compare_exchange_n( &ringBuffer->tail, &position, position + 1, 1,
+                        __ATOMIC_RELAXED, __ATOMIC_RELAXED ) ) {
+                break;
+            }
+        } else if( difference < 0 ) {
+            // The slot still holds an element from the previous lap, so the buffer is full
+            return 0;
+        } else {
+            // Another producer claimed this position first
+            position = __atomic_load_n( &ringBuffer->tail, __ATOMIC_RELAXED );
+        }
+    }
+
+    slot->element = element;
+    __atomic_store_n( &slot->sequence, position + 1, __ATOMIC_RELEASE );
+    return 1;
+}
+
+/*
+ * Multi consumer dequeue. A consumer claims the head position by advancing it with a
+ * compare-and-swap, but only once the slot's sequence number shows that a producer has filled it.
+ * Storing a sequence number of position + capacity hands the slot to the producers of the next lap.
+ *
+ * Arguments:
+ * ringBuffer -- The buffer to remove the element from
+ *
+ * Returns:
+ * The element at the front of the buffer, or NULL if the buffer was empty
+ */
+void *mpmcDequeue( RingBuffer *ringBuffer ) {
+    unsigned long position = __atomic_load_n( &ringBuffer->head, __ATOMIC_RELAXED );
+    RingBufferSlot *slot;
+
+    while( 1 ) {
+        slot = &ringBuffer->slots[ position & ringBuffer->mask ];
+        unsigned long sequence = __atomic_load_n( &slot->sequence, __ATOMIC_ACQUIRE );
+        long difference = (long) sequence - (long) (position + 1);
+
+        if( difference == 0 ) {
+            // The slot is filled, so try to claim the position. On failure position is reloaded.
+            if( __atomic_compare_exchange_n( &ringBuffer->head, &position, position + 1, 1,
+                        __ATOMIC_RELAXED, __ATOMIC_RELAXED ) ) {
+                break;
+            }
+        } else if( difference < 0 ) {
+            // No producer has filled this slot yet, so the buffer is empty
+            return NULL;
+        } else {
+            // Another consumer claimed this position first
+            position = __atomic_load_n( &ringBuffer->head, __ATOMIC_RELAXED );
+        }
+    }
+
+    void *element = slot->element;
+    __atomic_store_n( &slot->sequence, position + ringBuffer->capacity, __ATOMIC_RELEASE );
+    return element;
+}
+
+/*
+ * Returns the number of elements in the buffer. While other threads are using the buffer, this is
+ * only a snapshot.
+ *
+ * Arguments:
+ * ringBuffer -- The buffer whose size is being retrieved
+ *
+ * Returns:
+ * The number of elements in the buffer
+ */
+int ringBufferSize( RingBuffer *ringBuffer ) {
+    unsigned long head = __atomic_load_n( &ringBuffer->head, __ATOMIC_ACQUIRE );
+    unsigned long tail = __atomic_load_n( &ringBuffer->tail, __ATOMIC_ACQUIRE );
+
+    // Claimed positions can briefly run ahead of each other in MPMC mode
+    if( tail <= head ) {
+        return 0;
+    } else if( tail - head > ringBuffer->capacity ) {
+        return (int) ringBuffer->capacity;
+    }
+
+    return (int)(tail - head);
+}
+
+/*
+ * Frees the buffer and the elements within it. No other threads may be using the buffer.
+ *
+ * Arguments:
+ * ringBuffer -- The buffer that is being freed
+ */
+void ringBufferFree( RingBuffer *ringBuffer ) {
+    for( unsigned long position = ringBuffer->head; position != ringBuffer->tail; position++ ) {
+        free( ringBuffer->slots[ position & ringBuffer->mask ].element );
+    }
+
+    ringBufferFreeStructure( ringBuffer );
+}
+
+/*
+ * Frees the structural memory of the buffer without freeing the elements within it. No other threads
+ * may be using the buffer.
+ *
+ * Arguments:
+ * ringBuffer -- The buffer whose structural memory is being freed
+ */
+void ringBufferFreeStructure( RingBuffer *ringBuffer ) {
+    free( ringBuffer->slots );
+    free( ringBuffer );
+}
@@ -0,0 +1,147 @@
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include "utils.h"
+
+/*
+ * The concurrency guarantees of a ring buffer.
+ *
+ * RING_BUFFER_SPSC -- Exactly one thread enqueues and exactly one thread dequeues. Every operation
+ *                     is wait-free.
+ * RING_BUFFER_MPMC -- Any number of threads may enqueue and dequeue concurrently. Each slot carries
+ *                     a sequence number that tells threads whether it is ready to be written or read.
+ */
+typedef enum RingBufferMode {
+    RING_BUFFER_SPSC,
+    RING_BUFFER_MPMC
+} RingBufferMode;
+
+/*
+ * A slot in a ring buffer. The sequence number is only used by RING_BUFFER_MPMC buffers.
+ */
+typedef struct RingBufferSlot {
+    unsigned long sequence;
+    void *element;
+} RingBufferSlot;
+
+/*
+ * A fixed-capacity, lock-free FIFO queue of pointers. The capacity is always a power of two so that
+ * positions can be mapped to slots with a mask. The head is the next position to dequeue from and the
+ * tail is the next position to enqueue into; both only ever increase.
+ *
+ * In RING_BUFFER_SPSC mode, each side also caches the last index it read from the other side so that
+ * it only touches the other side's cache line when the buffer looks full or empty.
+ */
+typedef struct RingBuffer {
+    RingBufferMode mode;
+    unsigned long capacity;
+    unsigned long mask;
+    RingBufferSlot *slots;
+
+    /* Written by consumers */
+    char consumerPadding[CACHE_LINE_SIZE];
+    unsigned long head;
+    unsigned long cachedTail;
+
+    /* Written by producers */
+    char producerPadding[CACHE_LINE_SIZE - 2 * sizeof(unsigned long)];
+    unsigned long tail;
+    unsigned long cachedHead;
+    char endPadding[CACHE_LINE_SIZE - 2 * sizeof(unsigned long)];
+} RingBuffer;
+
+/*
+ * Creates a new, empty ring buffer.
+ *
+ * Arguments:
+ * capacity -- The minimum number of elements the buffer can hold. This is rounded up to the next
+ *             power of two.
+ * mode     -- Whether the buffer is single-producer/single-consumer or multi-producer/multi-consumer
+ *
+ * Returns:
+ * A newly allocated ring buffer, or NULL if the capacity is not positive
+ */
+extern RingBuffer *newRingBuffer( int capacity, RingBufferMode mode );
+
+/*
+ * Attempts to add an element to the back of the buffer.
+ *
+ * Arguments:
+ * ringBuffer -- The buffer to add the element to
+ * element    -- The element to add. NULL elements cannot be added.
+ *
+ * Returns:
+ * 1 if the element was added, 0 if the buffer was full or the element was NULL
+ */
+extern int ringBufferEnqueue( RingBuffer *ringBuffer, void *element );
+
+/*
+ * Attempts to remove the element at the front of the buffer.
+ *
+ * Arguments:
+ * ringBuffer -- The buffer to remove the element from
+ *
+ * Returns:
+ * The element at the front of the buffer, or NULL if the buffer was empty
+ */
+extern void *ringBufferDequeue( RingBuffer *ringBuffer );
+
+/*
+ * Adds as many of the supplied elements to the buffer as will fit, in order. In RING_BUFFER_SPSC mode
+ * the whole batch is published with a single store. In RING_BUFFER_MPMC mode the elements are
+ * enqueued one at a time, so other producers' elements may be interleaved with the batch.
+ *
+ * Arguments:
+ * ringBuffer -- The buffer to add the elements to
+ * elements   -- The elements to add. None of them may be NULL.
+ * count      -- The number of elements to add. Nothing is added if this is not positive.
+ *
+ * Returns:
+ * The number of elements that were added, which is a prefix of the supplied elements
+ */
+extern int ringBufferEnqueueBatch( RingBuffer *ringBuffer, void **elements, int count );
+
+/*
+ * Removes up to the supplied number of elements from the front of the buffer.
+ *
+ * Arguments:
+ * ringBuffer -- The buffer to remove the elements from
+ * elements   -- An array that the removed elements are written to
+ * maxCount   -- The maximum number of elements to remove. Nothing is removed if this is not
+ *               positive.
+ *
+ * Returns:
+ * The number of elements that were removed
+ */
+extern int ringBufferDequeueBatch( RingBuffer *ringBuffer, void **elements, int maxCount );
+
+/*
+ * Returns the number of elements in the buffer. While other threads are using the buffer, this is
+ * only a snapshot.
+ *
+ * Arguments:
+ * ringBuffer -- The buffer whose size is being retrieved
+ *
+ * Returns:
+ * The number of elements in the buffer
+ */
+extern int ringBufferSize( RingBuffer *ringBuffer );
+
+/*
+ * Frees the buffer and the elements within it. No other threads may be using the buffer.
+ *
+ * Arguments:
+ * ringBuffer -- The buffer that is being freed
+ */
+extern void ringBufferFree( RingBuffer *ringBuffer );
+
+/*
+ * Frees the structural memory of the buffer without freeing the elements within it. No other threads
+ * may be using the buffer.
+ *
+ * Arguments:
+ * ringBuffer -- The buffer whose structural memory is being freed
+ */
+extern void ringBufferFreeStructure( RingBuffer *ringBuffer );
+
+#endif
@@ -1,6 +1,48 @@
 #include <stdlib.h>
 
 #include "set.h"
+#include "threadpool.h"
+#include "utils.h"
+
+/*
+ * The state shared by the pieces of a setParallelForEach or setParallelMap. The mapped array is
+ * only used when mapping.
+ */
+typedef struct ParallelApply {
+    void **elements;
+    void **mapped;
+    ElementConsumer consumer;
+    MapFunction function;
+} ParallelApply;
+
+/*
+ * One of the sets being merged by setUnionMany, along with the next element its iterator will
+ * return. The index of the set breaks ties so that the earliest set's element is kept.
+ */
+typedef struct MergeSource {
+    SetIterator iterator;
+    void *next;
+    int index;
+} MergeSource;
+
+/* Filters are never sized for fewer than this many elements */
+#define MIN_FILTER_CAPACITY 64
+
+/* Implementation specific helper functions */
+void forEachRange( int start, int end, void *context );
+void mapRange( int start, int end, void *context );
+Set *wrapTree( BST *tree );
+Set *setFromSortedArray( ComparisonFunction comparisonFunction, SetBackend backend,
+        void **elements, int numElements );
+void **setElements( Set *set );
+BST *takeSetTree( Set *set );
+BSTNode *firstNode( BST *bst );
+int mergeElements( Set *setA, Set *setB, bool keepOnlyA, bool keepOnlyB, void **output );
+void rebuildBloomFilter( Set *set );
+unsigned long fingerprintOf( Set *set, void *element );
+bool mergeSourceBefore( MergeSource *a, MergeSource *b, ComparisonFunction comparisonFunction );
+void siftMergeSource( MergeSource **heap, int heapSize, int position,
+        ComparisonFunction comparisonFunction );
 
 /*
  * Creates a new set that uses a binary search tree as its backing element representation. A set
@@ -14,10 +56,43 @@
  * An empty set
  */
 Set *newSet( ComparisonFunction comparisonFunction ) {
+    return newSetWithBackend( comparisonFunction, SET_BACKEND_BST );
+}
+
+/*
+ * Creates a new set that stores its elements in the supplied backend.
+ *
+ * Arguments:
+ * comparisonFunction -- A function that will compare elements to determine equality and prevent
+ *                       duplicates from being added.
+ * backend            -- The data structure that will hold the elements
+ *
+ * Returns:
+ * An empty set
+ */
+Set *newSetWithBackend( ComparisonFunction comparisonFunction, SetBackend backend ) {
     Set *set = malloc( sizeof(Set) );
-    set->elements = newBST(comparisonFunction);
+    set->backend = backend;
+    set->comparisonFunction = comparisonFunction;
+    set->elements = NULL;
+    set->btree = NULL;
     set->size = 0;
 
+    if( backend == SET_BACKEND_BTREE ) {
+        set->btree = newBTree( comparisonFunction );
+    } else if( backend == SET_BACKEND_SPLAY ) {
+        set->elements = newSplayTree( comparisonFunction );
+    } else {
+        set->elements = newBST( comparisonFunction );
+    }
+
+    set->hashFunction = NULL;
+    set->filter = NULL;
+    set->removalsSinceRebuild = 0;
+    set->fingerprintFunction = NULL;
+    set->fingerprint = 0;
+    set->frozen = NULL;
+
     return set;
 }
 
@@ -30,14 +105,157 @@ Set *newSet( ComparisonFunction comparisonFunction ) {
  * element -- The element to add to the set
  */
 void setAdd( Set *set, void *element ) {
+    if( set->frozen ) {
+        debug( E_WARNING, "Cannot add elements to a frozen set!\n" );
+        return;
+    }
+
     if( element ) {
-        if( ! bstFind(set->elements, element) ) {
+        unsigned long hash = 0;
+        bool mightContain = true;
+
+        if( set->filter ) {
+            hash = set->hashFunction( element );
+            mightContain = bloomMightContain( set->filter, hash );
+        }
+
+        bool added = false;
+
+        if( set->backend == SET_BACKEND_BTREE ) {
+            added = btreeInsert( set->btree, element );
+        } else if( ! mightContain || ! bstFind(set->elements, element) ) {
+            // A definite miss in the filter means the tree doesn't need to be searched first
             bstInsert( set->elements, element );
+            added = true;
+        }
+
+        if( added ) {
             set->size += 1;
+
+            if( set->filter ) {
+                bloomAdd( set->filter, hash );
+            }
+
+            if( set->fingerprintFunction ) {
+                set->fingerprint += fingerprintOf( set, element );
+            }
         }
     }
 }
 
+/*
+ * Attaches a bloom filter to the set so that lookups for elements that aren't in the set can
+ * usually be answered from a single cache line instead of a walk down the tree. The filter is kept
+ * up to date by setAdd. Removed elements stay in the filter until it is rebuilt, which happens
+ * lazily during a lookup once enough elements have been removed or the set has outgrown the filter.
+ *
+ * Arguments:
+ * set          -- The set to attach the filter to
+ * hashFunction -- A hash function that agrees with the set's comparison function
+ */
+void setEnableBloomFilter( Set *set, HashFunction hashFunction ) {
+    set->hashFunction = hashFunction;
+    rebuildBloomFilter( set );
+}
+
+/*
+ * Starts maintaining a fingerprint of the set: an order-independent hash of its elements that is
+ * updated in constant time by setAdd and setRemove. Equal sets whose fingerprints use the same hash
+ * function always have equal fingerprints, so setEquals can reject most unequal sets without
+ * walking them, and a changed fingerprint shows that the set has changed. Sets created by the set
+ * operations do not keep a fingerprint until it is enabled on them.
+ *
+ * Arguments:
+ * set          -- The set to fingerprint
+ * hashFunction -- A hash function that agrees with the set's comparison function
+ */
+void setEnableFingerprint( Set *set, HashFunction hashFunction ) {
+    set->fingerprintFunction = hashFunction;
+    set->fingerprint = 0;
+
+    SetIterator iterator;
+    void *element;
+
+    setIteratorInit( &iterator, set );
+    while( (element = setIteratorNext( &iterator )) != NULL ) {
+        set->fingerprint += fingerprintOf( set, element );
+    }
+}
+
+/*
+ * Gets the set's fingerprint. Different sets can share a fingerprint, so matching fingerprints only
+ * suggest that two sets are equal, while different fingerprints prove that they are not.
+ *
+ * Arguments:
+ * set -- The set whose fingerprint is returned
+ *
+ * Returns:
+ * The fingerprint of the set's current elements, or 0 if fingerprinting hasn't been enabled
+ */
+unsigned long setFingerprint( Set *set ) {
+    return set->fingerprint;
+}
+
+/*
+ * Calculates an element's contribution to the set's fingerprint. The element's hash is mixed before
+ * it is summed, since summing raw hashes would give many different sets the same fingerprint.
+ *
+ * Arguments:
+ * set     -- The set whose fingerprint the element belongs to
+ * element -- The element being hashed
+ *
+ * Returns:
+ * The amount the element adds to the fingerprint
+ */
+unsigned long fingerprintOf( Set *set, void *element ) {
+    return (unsigned long) mixHash( set->fingerprintFunction( element ) );
+}
+
+/*
+ * Replaces the set's bloom filter with one sized for twice the current number of elements, which
+ * holds exactly the elements currently in the set.
+ *
+ * Arguments:
+ * set -- The set whose filter is being rebuilt
+ */
+void rebuildBloomFilter( Set *set ) {
+    int capacity = set->size * 2;
+    if( capacity < MIN_FILTER_CAPACITY ) {
+        capacity = MIN_FILTER_CAPACITY;
+    }
+
+    if( set->filter ) {
+        bloomFree( set->filter );
+    }
+
+    set->filter = newBloomFilter( capacity );
+    set->removalsSinceRebuild = 0;
+
+    SetIterator iterator;
+    void *element;
+
+    setIteratorInit( &iterator, set );
+    while( (element = setIteratorNext( &iterator )) != NULL ) {
+        bloomAdd( set->filter, set->hashFunction( element ) );
+    }
+}
+
+/*
+ * Makes the set read-only. Lookups are answered from a frozen Eytzinger array built from the set's
+ * tree, which is kept for iteration and the other set operations. Adding or removing elements
+ * afterwards has no effect.
+ *
+ * Arguments:
+ * set -- The set to freeze
+ */
+void setFreeze( Set *set ) {
+    if( ! set->frozen ) {
+        void **elements = setElements( set );
+        set->frozen = newFrozenBST( set->comparisonFunction, elements, set->size );
+        free( elements );
+    }
+}
+
 /*
  * Attempts to remove the element from the set.
  *
@@ -46,10 +264,27 @@ void setAdd( Set *set, void *element ) {
  * element -- The element to remove from the set
  */
 void setRemove( Set *set, void *element ) {
-    void *removed = bstRemove( set->elements, element );
+    if( set->frozen ) {
+        debug( E_WARNING, "Cannot remove elements from a frozen set!\n" );
+        return;
+    }
+
+    void *removed = NULL;
+
+    if( set->backend == SET_BACKEND_BTREE ) {
+        removed = btreeRemove( set->btree, element );
+    } else {
+        removed = bstRemove( set->elements, element );
+    }
+
     if( removed ) {
+        if( set->fingerprintFunction ) {
+            set->fingerprint -= fingerprintOf( set, removed );
+        }
+
         free( removed );
         set->size -= 1;
+        set->removalsSinceRebuild += 1;
     }
 }
 
@@ -64,6 +299,29 @@ void setRemove( Set *set, void *element ) {
  * True if the element is in the set, false otherwise
  */
 bool isInSet( Set *set, void *element ) {
+    if( set->filter ) {
+        // Stale bits from removals and an overfull filter only cost false positives, so the
+        // rebuild can wait until one of them is bad enough to matter
+        bool tooManyRemovals = set->removalsSinceRebuild > set->size / 4;
+        bool overfull = set->filter->size > set->filter->capacity;
+
+        if( tooManyRemovals || overfull ) {
+            rebuildBloomFilter( set );
+        }
+
+        if( ! bloomMightContain( set->filter, set->hashFunction( element ) ) ) {
+            return false;
+        }
+    }
+
+    if( set->frozen ) {
+        return frozenBSTFind( set->frozen, element ) != NULL;
+    }
+
+    if( set->backend == SET_BACKEND_BTREE ) {
+        return btreeFind( set->btree, element ) != NULL;
+    }
+
     return bstFind( set->elements, element ) != NULL;
 }
 
@@ -85,13 +343,13 @@ bool isInSet( Set *set, void *element ) {
 Set *setUnion( Set *setA, Set *setB, ComparisonFunction comparisonFunction ) {
     // Ensure that the proper comparison function gets used
     if( ! comparisonFunction ) {
-        comparisonFunction = setA->elements->comparisonFunction;
+        comparisonFunction = setA->comparisonFunction;
     }
 
     // Get the elements from A & B, create a new Set
-    void **elementsA = bstElements( setA->elements );
-    void **elementsB = bstElements( setB->elements );
-    Set *unionResult = newSet( comparisonFunction );
+    void **elementsA = setElements( setA );
+    void **elementsB = setElements( setB );
+    Set *unionResult = newSetWithBackend( comparisonFunction, setA->backend );
 
     // Insert the elements from A into the set
     for( int i = 0; i < setA->size; i++ ) {
@@ -110,6 +368,77 @@ Set *setUnion( Set *setA, Set *setB, ComparisonFunction comparisonFunction ) {
     return unionResult;
 }
 
+/*
+ * Calculates the union of many sets at once. The sets' in-order iterators are merged through a
+ * min-heap and the result is built once from the merged elements, so unioning N elements from k
+ * sets takes O(N log k) time rather than re-copying the accumulated result for every set. The sets
+ * should contain the same type of elements and have functionally equivalent comparison functions.
+ *
+ * Arguments:
+ * sets    -- The sets to union
+ * numSets -- The number of sets in the array
+ *
+ * Returns:
+ * A set containing all non-equivalent elements from the sets, using the first set's comparison
+ * function and backend. Equivalent elements are taken from the earliest set that holds them. If
+ * there are no sets, NULL is returned.
+ */
+Set *setUnionMany( Set **sets, int numSets ) {
+    if( sets == NULL || numSets <= 0 ) {
+        return NULL;
+    }
+
+    ComparisonFunction comparisonFunction = sets[0]->comparisonFunction;
+    MergeSource *sources = malloc( numSets * sizeof(MergeSource) );
+    MergeSource **heap = malloc( numSets * sizeof(MergeSource *) );
+    int heapSize = 0;
+    long totalElements = 0;
+
+    // Every non-empty set contributes its smallest element to the heap
+    for( int i = 0; i < numSets; i++ ) {
+        setIteratorInit( &sources[i].iterator, sets[i] );
+        sources[i].next = setIteratorNext( &sources[i].iterator );
+        sources[i].index = i;
+        totalElements += sets[i]->size;
+
+        if( sources[i].next != NULL ) {
+            heap[heapSize++] = &sources[i];
+        }
+    }
+
+    for( int i = heapSize / 2 - 1; i >= 0; i-- ) {
+        siftMergeSource( heap, heapSize, i, comparisonFunction );
+    }
+
+    void **elements = malloc( (totalElements > 0 ? totalElements : 1) * sizeof(void *) );
+    int numElements = 0;
+
+    while( heapSize > 0 ) {
+        MergeSource *smallest = heap[0];
+
+        // Equivalent elements arrive consecutively, so only the first one is kept
+        if( numElements == 0 ||
+                comparisonFunction( elements[numElements - 1], smallest->next ) != 0 ) {
+            elements[numElements++] = smallest->next;
+        }
+
+        smallest->next = setIteratorNext( &smallest->iterator );
+        if( smallest->next == NULL ) {
+            heap[0] = heap[--heapSize];
+        }
+
+        siftMergeSource( heap, heapSize, 0, comparisonFunction );
+    }
+
+    Set *result = setFromSortedArray( comparisonFunction, sets[0]->backend, elements, numElements );
+
+    free( elements );
+    free( heap );
+    free( sources );
+
+    return result;
+}
+
 /*
  * Calculates the set theoretic intersection of two sets. An intersection creates a set whose
  * elements are present in setA AND present in setB. For this to work, the two sets should
@@ -128,14 +457,14 @@ Set *setUnion( Set *setA, Set *setB, ComparisonFunction comparisonFunction ) {
 Set *setIntersect( Set *setA, Set *setB, ComparisonFunction comparisonFunction ) {
     // Ensure that the proper comparison function gets used
     if( ! comparisonFunction ) {
-        comparisonFunction = setA->elements->comparisonFunction;
+        comparisonFunction = setA->comparisonFunction;
     }
 
-    Set *intersectionResult = newSet( comparisonFunction );
+    Set *intersectionResult = newSetWithBackend( comparisonFunction, setA->backend );
 
     // Iterate over the smaller set
     if( setA->size <= setB->size ) {
-        void **elements = bstElements( setA->elements );
+        void **elements = setElements( setA );
 
         for( int i = 0; i < setA->size; i++ ) {
             void *element = elements[i];
@@ -148,7 +477,7 @@ Set *setIntersect( Set *setA, Set *setB, ComparisonFunction comparisonFunction )
 
         free( elements );
     } else {
-        void **elements = bstElements( setB->elements );
+        void **elements = setElements( setB );
 
         for( int i = 0; i < setB->size; i++ ) {
             void *element = elements[i];
@@ -165,6 +494,228 @@ Set *setIntersect( Set *setA, Set *setB, ComparisonFunction comparisonFunction )
     return intersectionResult;
 }
 
+/*
+ * Calculates the set theoretic difference of two sets, which contains the elements of setA that are
+ * not present in setB. Both sets are walked in order at the same time, so this takes linear time.
+ *
+ * Arguments:
+ * setA -- The set whose elements are kept
+ * setB -- The set whose elements are removed
+ * comparisonfunction -- A function to compare the elements in the difference. If this is NULL, the
+ *                       comparison function from setA will be used.
+ *
+ * Returns:
+ * A set containing the elements of setA that are not in setB.
+ */
+Set *setDifference( Set *setA, Set *setB, ComparisonFunction comparisonFunction ) {
+    if( ! comparisonFunction ) {
+        comparisonFunction = setA->comparisonFunction;
+    }
+
+    void **elements = malloc( sizeof(void *) * (setA->size > 0 ? setA->size : 1) );
+    int numElements = mergeElements( setA, setB, true, false, elements );
+    Set *result = setFromSortedArray( comparisonFunction, setA->backend, elements, numElements );
+
+    free( elements );
+    return result;
+}
+
+/*
+ * Calculates the symmetric difference of two sets, which contains the elements that are present in
+ * exactly one of the two sets. Both sets are walked in order at the same time, so this takes linear
+ * time.
+ *
+ * Arguments:
+ * setA -- The first set in the pair of sets
+ * setB -- The second set in the pair of sets
+ * comparisonfunction -- A function to compare the elements in the result. If this is NULL, the
+ *                       comparison function from setA will be used.
+ *
+ * Returns:
+ * A set containing the elements that are in setA or setB, but not both.
+ */
+Set *setSymmetricDifference( Set *setA, Set *setB, ComparisonFunction comparisonFunction ) {
+    if( ! comparisonFunction ) {
+        comparisonFunction = setA->comparisonFunction;
+    }
+
+    int maxSize = setA->size + setB->size;
+    void **elements = malloc( sizeof(void *) * (maxSize > 0 ? maxSize : 1) );
+    int numElements = mergeElements( setA, setB, true, true, elements );
+    Set *result = setFromSortedArray( comparisonFunction, setA->backend, elements, numElements );
+
+    free( elements );
+    return result;
+}
+
+/*
+ * Determines whether every element of one set is present in another. A subset larger than the
+ * superset is rejected immediately. Otherwise both sets are walked in order, stopping at the first
+ * element that is missing from the superset.
+ *
+ * Arguments:
+ * subset   -- The set whose elements are being looked for
+ * superset -- The set that is being searched
+ *
+ * Returns:
+ * True if every element of subset is in superset, false otherwise
+ */
+bool setIsSubset( Set *subset, Set *superset ) {
+    if( subset->size > superset->size ) {
+        return false;
+    }
+
+    ComparisonFunction compare = subset->comparisonFunction;
+    SetIterator subsetIterator;
+    SetIterator supersetIterator;
+    setIteratorInit( &subsetIterator, subset );
+    setIteratorInit( &supersetIterator, superset );
+
+    void *current = setIteratorNext( &subsetIterator );
+    void *candidate = setIteratorNext( &supersetIterator );
+
+    while( current != NULL ) {
+        // Skip the superset's elements that are smaller than the one being looked for
+        int comparisonResult = -1;
+        while( candidate != NULL ) {
+            comparisonResult = compare( candidate, current );
+
+            if( comparisonResult >= 0 ) {
+                break;
+            }
+
+            candidate = setIteratorNext( &supersetIterator );
+        }
+
+        if( comparisonResult != 0 ) {
+            return false;
+        }
+
+        current = setIteratorNext( &subsetIterator );
+        candidate = setIteratorNext( &supersetIterator );
+    }
+
+    return true;
+}
+
+/*
+ * Determines whether two sets contain equivalent elements. Sets of different sizes, and sets whose
+ * fingerprints were computed with the same hash function but differ, are rejected immediately.
+ * Otherwise both sets are walked in order, stopping at the first difference.
+ *
+ * Arguments:
+ * setA -- The first set to compare
+ * setB -- The second set to compare
+ *
+ * Returns:
+ * True if the sets contain the same elements, false otherwise
+ */
+bool setEquals( Set *setA, Set *setB ) {
+    if( setA->size != setB->size ) {
+        return false;
+    }
+
+    bool comparableFingerprints = setA->fingerprintFunction != NULL &&
+        setA->fingerprintFunction == setB->fingerprintFunction;
+
+    if( comparableFingerprints && setA->fingerprint != setB->fingerprint ) {
+        return false;
+    }
+
+    ComparisonFunction compare = setA->comparisonFunction;
+    SetIterator iteratorA;
+    SetIterator iteratorB;
+    setIteratorInit( &iteratorA, setA );
+    setIteratorInit( &iteratorB, setB );
+
+    // Sets of equal size are equal exactly when their in-order elements match pairwise
+    void *elementA;
+    while( (elementA = setIteratorNext( &iteratorA )) != NULL ) {
+        if( compare( elementA, setIteratorNext( &iteratorB ) ) != 0 ) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Finds the node holding the smallest element of a tree.
+ *
+ * Arguments:
+ * bst -- The tree to search
+ *
+ * Returns:
+ * The leftmost node of the tree, or NULL if the tree is empty
+ */
+BSTNode *firstNode( BST *bst ) {
+    BSTNode *node = bst->root;
+
+    while( node != NULL && node->left != NULL ) {
+        node = node->left;
+    }
+
+    return node;
+}
+
+/*
+ * Walks two sets in order at the same time and copies the elements that are only in one of them to
+ * an array. The output is in sorted order, so it can be used to build a tree directly.
+ *
+ * Arguments:
+ * setA      -- The first set
+ * setB      -- The second set
+ * keepOnlyA -- Whether elements only present in setA are copied
+ * keepOnlyB -- Whether elements only present in setB are copied
+ * output    -- The array that the elements are copied to
+ *
+ * Returns:
+ * The number of elements copied to the array
+ */
+int mergeElements( Set *setA, Set *setB, bool keepOnlyA, bool keepOnlyB, void **output ) {
+    ComparisonFunction compare = setA->comparisonFunction;
+    SetIterator iteratorA;
+    SetIterator iteratorB;
+    setIteratorInit( &iteratorA, setA );
+    setIteratorInit( &iteratorB, setB );
+
+    void *elementA = setIteratorNext( &iteratorA );
+    void *elementB = setIteratorNext( &iteratorB );
+    int count = 0;
+
+    while( elementA != NULL && elementB != NULL ) {
+        int comparisonResult = compare( elementA, elementB );
+
+        if( comparisonResult < 0 ) {
+            if( keepOnlyA ) {
+                output[ count++ ] = elementA;
+            }
+
+            elementA = setIteratorNext( &iteratorA );
+        } else if( comparisonResult > 0 ) {
+            if( keepOnlyB ) {
+                output[ count++ ] = elementB;
+            }
+
+            elementB = setIteratorNext( &iteratorB );
+        } else {
+            elementA = setIteratorNext( &iteratorA );
+            elementB = setIteratorNext( &iteratorB );
+        }
+    }
+
+    // Whatever is left in either set has no counterpart in the other
+    for( ; keepOnlyA && elementA != NULL; elementA = setIteratorNext( &iteratorA ) ) {
+        output[ count++ ] = elementA;
+    }
+
+    for( ; keepOnlyB && elementB != NULL; elementB = setIteratorNext( &iteratorB ) ) {
+        output[ count++ ] = elementB;
+    }
+
+    return count;
+}
+
 /*
  * Applies the consumer function to every element within the set.
  *
@@ -173,7 +724,7 @@ Set *setIntersect( Set *setA, Set *setB, ComparisonFunction comparisonFunction )
  * consumer -- The function that will be applied to every element within the set.
  */
 void setForEach( Set *set, ElementConsumer consumer ) {
-    void **elements = bstElements( set->elements );
+    void **elements = setElements( set );
 
     for( int i = 0; i < set->size; i++ ) {
         consumer( elements[i] );
@@ -203,12 +754,12 @@ void setForEach( Set *set, ElementConsumer consumer ) {
  */
 Set *setMap( Set *set, MapFunction function, ComparisonFunction comparisonFunction) {
     if( ! comparisonFunction ) {
-        comparisonFunction = set->elements->comparisonFunction;
+        comparisonFunction = set->comparisonFunction;
     }
 
     // Create the new set and get the elements from the old set
-    Set *result = newSet( comparisonFunction );
-    void **elements = bstElements( set->elements );
+    Set *result = newSetWithBackend( comparisonFunction, set->backend );
+    void **elements = setElements( set );
 
     // Apply the function to each element in the old set, then add it to the new set
     for( int i = 0; i < set->size; i++ ) {
@@ -220,6 +771,377 @@ Set *setMap( Set *set, MapFunction function, ComparisonFunction comparisonFuncti
     return result;
 }
 
+/*
+ * Calculates the union of two sets with the join-based parallel algorithm on the default thread
+ * pool. Both sets are consumed: the result is assembled from the nodes of their trees, so nothing
+ * is copied and neither set may be used afterwards. Sets backed by binary search trees are treaps,
+ * and combining them takes O(m log(n/m + 1)) expected work, where m is the size of the smaller set.
+ * Splay-backed sets are first rebuilt into treaps and B-tree backed sets are first moved into one,
+ * which takes O(n) time. The two sets must be distinct and use functionally equivalent comparison
+ * functions, which the result also uses. Where both sets hold equivalent elements, the one from
+ * setA is kept and the other is not freed.
+ *
+ * Arguments:
+ * setA -- The first set in the pair of sets to union
+ * setB -- The second set in the pair of sets to union
+ *
+ * Returns:
+ * A set containing all non-equivalent elements from setA and setB.
+ */
+Set *setParallelUnion( Set *setA, Set *setB ) {
+    BST *tree = bstUnion( takeSetTree( setA ), takeSetTree( setB ), defaultThreadPool() );
+    return wrapTree( tree );
+}
+
+/*
+ * Calculates the intersection of two sets with the join-based parallel algorithm on the default
+ * thread pool. Both sets are consumed, and the work is bounded as in setParallelUnion. Elements
+ * that are not kept are not freed.
+ *
+ * Arguments:
+ * setA -- The first set in the pair of sets to intersect
+ * setB -- The second set in the pair of sets to intersect
+ *
+ * Returns:
+ * A set containing the elements of setA that are also present in setB.
+ */
+Set *setParallelIntersect( Set *setA, Set *setB ) {
+    BST *tree = bstIntersect( takeSetTree( setA ), takeSetTree( setB ), defaultThreadPool() );
+    return wrapTree( tree );
+}
+
+/*
+ * Calculates the difference of two sets with the join-based parallel algorithm on the default
+ * thread pool. Both sets are consumed, and the work is bounded as in setParallelUnion. Elements
+ * that are not kept are not freed.
+ *
+ * Arguments:
+ * setA -- The set whose elements are kept
+ * setB -- The set whose elements are removed
+ *
+ * Returns:
+ * A set containing the elements of setA that are not present in setB.
+ */
+Set *setParallelDifference( Set *setA, Set *setB ) {
+    BST *tree = bstDifference( takeSetTree( setA ), takeSetTree( setB ), defaultThreadPool() );
+    return wrapTree( tree );
+}
+
+/*
+ * Creates a set that takes ownership of an existing tree.
+ *
+ * Arguments:
+ * tree -- The tree holding the set's elements
+ *
+ * Returns:
+ * A set backed by the tree
+ */
+Set *wrapTree( BST *tree ) {
+    Set *set = malloc( sizeof(Set) );
+    set->backend = tree->splay ? SET_BACKEND_SPLAY : SET_BACKEND_BST;
+    set->comparisonFunction = tree->comparisonFunction;
+    set->elements = tree;
+    set->btree = NULL;
+    set->size = bstSize( tree );
+    set->hashFunction = NULL;
+    set->filter = NULL;
+    set->removalsSinceRebuild = 0;
+    set->fingerprintFunction = NULL;
+    set->fingerprint = 0;
+    set->frozen = NULL;
+
+    return set;
+}
+
+/*
+ * Creates a set from an array of sorted, distinct elements. Binary search trees are built directly
+ * from the array and rebuilt into treaps in linear time, while other backends insert the elements
+ * one at a time.
+ *
+ * Arguments:
+ * comparisonFunction -- The function used to order the elements
+ * backend            -- The data structure that will hold the elements
+ * elements           -- The sorted elements
+ * numElements        -- The number of elements in the array
+ *
+ * Returns:
+ * A set containing the elements
+ */
+Set *setFromSortedArray( ComparisonFunction comparisonFunction, SetBackend backend,
+        void **elements, int numElements ) {
+    if( backend != SET_BACKEND_BTREE ) {
+        BST *tree = bstFromSortedArray( comparisonFunction, elements, numElements );
+        tree->splay = backend == SET_BACKEND_SPLAY;
+
+        // Tree-backed sets are kept as treaps, which the parallel operations rely on
+        if( ! tree->splay ) {
+            bstMakeTreap( tree );
+        }
+
+        return wrapTree( tree );
+    }
+
+    Set *set = newSetWithBackend( comparisonFunction, backend );
+    for( int i = 0; i < numElements; i++ ) {
+        setAdd( set, elements[i] );
+    }
+
+    return set;
+}
+
+/*
+ * Determines whether one merge source's next element comes before another's. Equivalent elements
+ * are ordered by the position of their sets.
+ *
+ * Arguments:
+ * a                  -- The first merge source
+ * b                  -- The second merge source
+ * comparisonFunction -- The function used to order the elements
+ *
+ * Returns:
+ * True if a's next element should be merged before b's, false otherwise
+ */
+bool mergeSourceBefore( MergeSource *a, MergeSource *b, ComparisonFunction comparisonFunction ) {
+    int comparisonResult = comparisonFunction( a->next, b->next );
+
+    return comparisonResult < 0 || (comparisonResult == 0 && a->index < b->index);
+}
+
+/*
+ * Moves a merge source down a heap until neither of its children comes before it.
+ *
+ * Arguments:
+ * heap               -- The heap, ordered by mergeSourceBefore
+ * heapSize           -- The number of sources in the heap
+ * position           -- The position of the source being moved
+ * comparisonFunction -- The function used to order the elements
+ */
+void siftMergeSource( MergeSource **heap, int heapSize, int position,
+        ComparisonFunction comparisonFunction ) {
+    while( true ) {
+        int smallest = position;
+        int left = 2 * position + 1;
+        int right = left + 1;
+
+        if( left < heapSize && mergeSourceBefore( heap[left], heap[smallest],
+                    comparisonFunction ) ) {
+            smallest = left;
+        }
+
+        if( right < heapSize && mergeSourceBefore( heap[right], heap[smallest],
+                    comparisonFunction ) ) {
+            smallest = right;
+        }
+
+        if( smallest == position ) {
+            return;
+        }
+
+        MergeSource *temp = heap[position];
+        heap[position] = heap[smallest];
+        heap[smallest] = temp;
+        position = smallest;
+    }
+}
+
+/*
+ * Creates an array of the set's elements, in order.
+ *
+ * Arguments:
+ * set -- The set whose elements are being copied into an array
+ *
+ * Returns:
+ * An array containing the set's elements
+ */
+void **setElements( Set *set ) {
+    if( set->backend == SET_BACKEND_BTREE ) {
+        return btreeElements( set->btree );
+    }
+
+    return bstElements( set->elements );
+}
+
+/*
+ * Takes a set's elements as a binary search tree for the join-based operations, and frees the rest
+ * of the set. A tree-backed set hands over its own tree, while a B-tree's elements are built into a
+ * new tree in O(n) time.
+ *
+ * Arguments:
+ * set -- The set whose elements are being taken, which is freed
+ *
+ * Returns:
+ * A binary search tree holding the set's elements
+ */
+BST *takeSetTree( Set *set ) {
+    BST *tree = set->elements;
+
+    if( set->backend == SET_BACKEND_BTREE ) {
+        void **elements = setElements( set );
+        tree = bstFromSortedArray( set->comparisonFunction, elements, set->size );
+        free( elements );
+        btreeFreeStructure( set->btree );
+    }
+
+    if( set->filter ) {
+        bloomFree( set->filter );
+    }
+
+    if( set->frozen ) {
+        frozenBSTFreeStructure( set->frozen );
+    }
+
+    free( set );
+    return tree;
+}
+
+/*
+ * Positions an iterator before the smallest element of a set. The iterator is invalidated if the
+ * set is modified before it has returned every element.
+ *
+ * Arguments:
+ * iterator -- The iterator to initialize
+ * set      -- The set that will be walked
+ */
+void setIteratorInit( SetIterator *iterator, Set *set ) {
+    iterator->backend = set->backend;
+
+    if( set->backend == SET_BACKEND_BTREE ) {
+        btreeIteratorInit( &iterator->btreeIterator, set->btree );
+    } else {
+        iterator->node = firstNode( set->elements );
+    }
+}
+
+/*
+ * Advances an iterator to the next element of its set.
+ *
+ * Arguments:
+ * iterator -- The iterator to advance
+ *
+ * Returns:
+ * The next element in order, or NULL once every element has been returned
+ */
+void *setIteratorNext( SetIterator *iterator ) {
+    if( iterator->backend == SET_BACKEND_BTREE ) {
+        return btreeIteratorNext( &iterator->btreeIterator );
+    }
+
+    if( iterator->node == NULL ) {
+        return NULL;
+    }
+
+    void *element = iterator->node->data;
+    iterator->node = successor( iterator->node );
+    return element;
+}
+
+/*
+ * Applies the consumer function to every element within the set, with the elements partitioned
+ * across the workers of the default thread pool. The consumer is called concurrently from several
+ * threads, so it must be safe to do so, and the order in which elements are visited is unspecified.
+ *
+ * Arguments:
+ * set      -- The set that will have the function applied
+ * consumer -- The function that will be applied to every element within the set.
+ */
+void setParallelForEach( Set *set, ElementConsumer consumer ) {
+    ParallelApply apply = { setElements( set ), NULL, consumer, NULL };
+
+    parallelFor( defaultThreadPool(), 0, set->size, 0, forEachRange, &apply );
+
+    free( apply.elements );
+}
+
+/*
+ * Applies a setParallelForEach consumer to one piece of the element array.
+ *
+ * Arguments:
+ * start   -- The first index in the piece
+ * end     -- One past the last index in the piece
+ * context -- The ParallelApply describing the operation
+ */
+void forEachRange( int start, int end, void *context ) {
+    ParallelApply *apply = context;
+
+    for( int i = start; i < end; i++ ) {
+        apply->consumer( apply->elements[i] );
+    }
+}
+
+/*
+ * Creates a new set by applying the map function to every element of the set in parallel, using the
+ * default thread pool. The mapped elements are sorted in parallel and the result set is built from
+ * them in a single pass, rather than by adding each element individually. Mapped elements that are
+ * equivalent to an earlier mapped element are freed.
+ *
+ * Arguments:
+ * set                -- The set whose elements will be mapped over
+ * function           -- The function that will be applied to every element in the set. This
+ *                       function is called concurrently from several threads and should allocate
+ *                       new space for its result.
+ * comparisonfunction -- A function that can be used to compare elements in the codomain of the
+ *                       mapping function. If this is NULL, the comparison function of the original
+ *                       set will be used, as in setMap.
+ *
+ * Returns:
+ * A new set containing every element within the original set after the function has been applied.
+ */
+Set *setParallelMap( Set *set, MapFunction function, ComparisonFunction comparisonFunction ) {
+    if( ! comparisonFunction ) {
+        comparisonFunction = set->comparisonFunction;
+    }
+
+    ThreadPool *pool = defaultThreadPool();
+    ParallelApply apply = { setElements( set ), NULL, NULL, function };
+    apply.mapped = malloc( sizeof(void *) * (set->size > 0 ? set->size : 1) );
+
+    parallelFor( pool, 0, set->size, 0, mapRange, &apply );
+
+    // Drop NULL results, which setAdd would also have ignored
+    int numMapped = 0;
+    for( int i = 0; i < set->size; i++ ) {
+        if( apply.mapped[i] ) {
+            apply.mapped[ numMapped++ ] = apply.mapped[i];
+        }
+    }
+
+    parallelSort( pool, apply.mapped, numMapped, comparisonFunction );
+
+    // Equivalent elements are now adjacent, so keep the first of each run
+    int numUnique = 0;
+    for( int i = 0; i < numMapped; i++ ) {
+        void *element = apply.mapped[i];
+
+        if( numUnique > 0 && comparisonFunction( apply.mapped[ numUnique - 1 ], element ) == 0 ) {
+            free( element );
+        } else {
+            apply.mapped[ numUnique++ ] = element;
+        }
+    }
+
+    Set *result = setFromSortedArray( comparisonFunction, set->backend, apply.mapped, numUnique );
+
+    free( apply.elements );
+    free( apply.mapped );
+    return result;
+}
+
+/*
+ * Applies a setParallelMap function to one piece of the element array.
+ *
+ * Arguments:
+ * start   -- The first index in the piece
+ * end     -- One past the last index in the piece
+ * context -- The ParallelApply describing the operation
+ */
+void mapRange( int start, int end, void *context ) {
+    ParallelApply *apply = context;
+
+    for( int i = start; i < end; i++ ) {
+        apply->mapped[i] = apply->function( apply->elements[i] );
+    }
+}
+
 /*
  * Frees the memory used by this set.
  *
@@ -227,7 +1149,20 @@ Set *setMap( Set *set, MapFunction function, ComparisonFunction comparisonFuncti
  * set -- The set whose you would like to free
  */
 void setFree( Set *set ) {
-    bstFree( set->elements );
+    if( set->filter ) {
+        bloomFree( set->filter );
+    }
+
+    // The tree owns the elements, so the frozen array never frees them
+    if( set->frozen ) {
+        frozenBSTFreeStructure( set->frozen );
+    }
+
+    if( set->backend == SET_BACKEND_BTREE ) {
+        btreeFree( set->btree );
+    } else {
+        bstFree( set->elements );
+    }
     free(set);
 }
 
@@ -240,6 +1175,19 @@ void setFree( Set *set ) {
  * set -- The set whose structure you would like to free.
  */
 void setFreeStructure( Set *set ) {
-    bstFreeStructure( set->elements );
+    if( set->filter ) {
+        bloomFree( set->filter );
+    }
+
+    // The tree owns the elements, so the frozen array never frees them
+    if( set->frozen ) {
+        frozenBSTFreeStructure( set->frozen );
+    }
+
+    if( set->backend == SET_BACKEND_BTREE ) {
+        btreeFreeStructure( set->btree );
+    } else {
+        bstFreeStructure( set->elements );
+    }
     free( set );
 }
@@ -3,14 +3,58 @@
 
 #include <stdbool.h>
 
+#include "bloom.h"
 #include "bst.h"
+#include "btree.h"
+#include "frozenbst.h"
 #include "functions.h"
 
+/*
+ * The data structures that can hold the elements of a set.
+ *
+ * SET_BACKEND_BST   -- A binary search tree. This supports every set operation directly.
+ * SET_BACKEND_BTREE -- A B-tree, which needs fewer cache misses per lookup in large sets.
+ * SET_BACKEND_SPLAY -- A splay tree, which keeps frequently used elements near the root when a few
+ *                      elements receive most of the lookups. Lookups modify the tree.
+ */
+typedef enum SetBackend {
+    SET_BACKEND_BST,
+    SET_BACKEND_BTREE,
+    SET_BACKEND_SPLAY
+} SetBackend;
+
 typedef struct Set {
-    BST *elements;
+    SetBackend backend;
+    ComparisonFunction comparisonFunction;
     int size;
+
+    /* The tree holding the elements. Only the one matching the backend is used. */
+    BST *elements;
+    BTree *btree;
+
+    /* An optional filter that answers most lookups for missing elements without a tree walk */
+    HashFunction hashFunction;
+    BloomFilter *filter;
+    int removalsSinceRebuild;
+
+    /* An optional order-independent hash of the elements, kept current by setAdd and setRemove */
+    HashFunction fingerprintFunction;
+    unsigned long fingerprint;
+
+    /* A search array used for lookups once the set has been made read-only */
+    FrozenBST *frozen;
 } Set;
 
+/*
+ * An in-order iterator over the elements of a set of any backend. Iterators are usually declared on
+ * the stack and set up with setIteratorInit, so walking a set allocates nothing.
+ */
+typedef struct SetIterator {
+    BSTNode *node;
+    BTreeIterator btreeIterator;
+    SetBackend backend;
+} SetIterator;
+
 /*
  * Creates a new set that uses a binary search tree as its backing element representation. A set
  * will prevent the addition of duplicate items.
@@ -24,6 +68,19 @@ typedef struct Set {
  */
 extern Set *newSet( ComparisonFunction comparisonFunction );
 
+/*
+ * Creates a new set that stores its elements in the supplied backend.
+ *
+ * Arguments:
+ * comparisonFunction -- A function that will compare elements to determine equality and prevent
+ *                       duplicates from being added.
+ * backend            -- The data structure that will hold the elements
+ *
+ * Returns:
+ * An empty set
+ */
+extern Set *newSetWithBackend( ComparisonFunction comparisonFunction, SetBackend backend );
+
 /*
  * Attempts to add the element to the set. If the element is already present in the set, then it is
  * not added. If the element was added, then the size of the set will be incremented by 1.
@@ -34,6 +91,53 @@ extern Set *newSet( ComparisonFunction comparisonFunction );
  */
 extern void setAdd( Set *set, void *element );
 
+/*
+ * Attaches a bloom filter to the set so that lookups for elements that aren't in the set can
+ * usually be answered from a single cache line instead of a walk down the tree. The filter is kept
+ * up to date by setAdd. Removed elements stay in the filter until it is rebuilt, which happens
+ * lazily during a lookup once enough elements have been removed or the set has outgrown the filter.
+ *
+ * Arguments:
+ * set          -- The set to attach the filter to
+ * hashFunction -- A hash function that agrees with the set's comparison function
+ */
+extern void setEnableBloomFilter( Set *set, HashFunction hashFunction );
+
+/*
+ * Starts maintaining a fingerprint of the set: an order-independent hash of its elements that is
+ * updated in constant time by setAdd and setRemove. Equal sets whose fingerprints use the same hash
+ * function always have equal fingerprints, so setEquals can reject most unequal sets without
+ * walking them, and a changed fingerprint shows that the set has changed. Sets created by the set
+ * operations do not keep a fingerprint until it is enabled on them.
+ *
+ * Arguments:
+ * set          -- The set to fingerprint
+ * hashFunction -- A hash function that agrees with the set's comparison function
+ */
+extern void setEnableFingerprint( Set *set, HashFunction hashFunction );
+
+/*
+ * Gets the set's fingerprint. Different sets can share a fingerprint, so matching fingerprints only
+ * suggest that two sets are equal, while different fingerprints prove that they are not.
+ *
+ * Arguments:
+ * set -- The set whose fingerprint is returned
+ *
+ * Returns:
+ * The fingerprint of the set's current elements, or 0 if fingerprinting hasn't been enabled
+ */
+extern unsigned long setFingerprint( Set *set );
+
+/*
+ * Makes the set read-only. Lookups are answered from a frozen Eytzinger array built from the set's
+ * tree, which is kept for iteration and the other set operations. Adding or removing elements
+ * afterwards has no effect.
+ *
+ * Arguments:
+ * set -- The set to freeze
+ */
+extern void setFreeze( Set *set );
+
 /*
  * Attempts to remove the element from the set.
  *
@@ -72,6 +176,23 @@ extern bool isInSet( Set *set, void *element );
  */
 extern Set *setUnion( Set *setA, Set *setB, ComparisonFunction comparisonFunction );
 
+/*
+ * Calculates the union of many sets at once. The sets' in-order iterators are merged through a
+ * min-heap and the result is built once from the merged elements, so unioning N elements from k
+ * sets takes O(N log k) time rather than re-copying the accumulated result for every set. The sets
+ * should contain the same type of elements and have functionally equivalent comparison functions.
+ *
+ * Arguments:
+ * sets    -- The sets to union
+ * numSets -- The number of sets in the array
+ *
+ * Returns:
+ * A set containing all non-equivalent elements from the sets, using the first set's comparison
+ * function and backend. Equivalent elements are taken from the earliest set that holds them. If
+ * there are no sets, NULL is returned.
+ */
+extern Set *setUnionMany( Set **sets, int numSets );
+
 /*
  * Calculates the set theoretic intersection of two sets. An intersection creates a set whose
  * elements are present in setA AND present in setB. For this to work, the two sets should
@@ -89,6 +210,65 @@ extern Set *setUnion( Set *setA, Set *setB, ComparisonFunction comparisonFunctio
  */
 extern Set *setIntersect( Set *setA, Set *setB, ComparisonFunction comparisonFunction );
 
+/*
+ * Calculates the set theoretic difference of two sets, which contains the elements of setA that are
+ * not present in setB. Both sets are walked in order at the same time, so this takes linear time.
+ *
+ * Arguments:
+ * setA -- The set whose elements are kept
+ * setB -- The set whose elements are removed
+ * comparisonfunction -- A function to compare the elements in the difference. If this is NULL, the
+ *                       comparison function from setA will be used.
+ *
+ * Returns:
+ * A set containing the elements of setA that are not in setB.
+ */
+extern Set *setDifference( Set *setA, Set *setB, ComparisonFunction comparisonFunction );
+
+/*
+ * Calculates the symmetric difference of two sets, which contains the elements that are present in
+ * exactly one of the two sets. Both sets are walked in order at the same time, so this takes linear
+ * time.
+ *
+ * Arguments:
+ * setA -- The first set in the pair of sets
+ * setB -- The second set in the pair of sets
+ * comparisonfunction -- A function to compare the elements in the result. If this is NULL, the
+ *                       comparison function from setA will be used.
+ *
+ * Returns:
+ * A set containing the elements that are in setA or setB, but not both.
+ */
+extern Set *setSymmetricDifference( Set *setA, Set *setB, ComparisonFunction comparisonFunction );
+
+/*
+ * Determines whether every element of one set is present in another. A subset larger than the
+ * superset is rejected immediately. Otherwise both sets are walked in order, stopping at the first
+ * element that is missing from the superset.
+ *
+ * Arguments:
+ * subset   -- The set whose elements are being looked for
+ * superset -- The set that is being searched
+ *
+ * Returns:
+ * True if every element of subset is in superset, false otherwise
+ */
+extern bool setIsSubset( Set *subset, Set *superset );
+
+/*
+ * Determines whether two sets contain equivalent elements. Sets of different sizes, and sets whose
+ * fingerprints were computed with the same hash function but differ, are rejected immediately.
+ * Otherwise both sets are walked in order, stopping at the first difference.
+ *
+ * Arguments:
+ * setA -- The first set to compare
+ * setB -- The second set to compare
+ *
+ * Returns:
+ * True if the sets contain the same elements, false otherwise
+ */
+extern bool setEquals( Set *setA, Set *setB );
+
 /*
  * Applies the consumer function to every element within the set.
  *
@@ -98,6 +278,27 @@ extern Set *setIntersect( Set *setA, Set *setB, ComparisonFunction comparisonFun
  */
 extern void setForEach( Set *set, ElementConsumer consumer );
 
+/*
+ * Positions an iterator before the smallest element of a set. The iterator is invalidated if the
+ * set is modified before it has returned every element.
+ *
+ * Arguments:
+ * iterator -- The iterator to initialize
+ * set      -- The set that will be walked
+ */
+extern void setIteratorInit( SetIterator *iterator, Set *set );
+
+/*
+ * Advances an iterator to the next element of its set.
+ *
+ * Arguments:
+ * iterator -- The iterator to advance
+ *
+ * Returns:
+ * The next element in order, or NULL once every element has been returned
+ */
+extern void *setIteratorNext( SetIterator *iterator );
+
 /*
  * Creates a new set where the elements in the set derived by applying the map function to every
  * element in the set passed to the function
@@ -117,6 +318,84 @@ extern void setForEach( Set *set, ElementConsumer consumer );
  */
 extern Set *setMap( Set *set, MapFunction function, ComparisonFunction comparisonFunction);
 
+/*
+ * Calculates the union of two sets with the join-based parallel algorithm on the default thread
+ * pool. Both sets are consumed: the result is assembled from the nodes of their trees, so nothing
+ * is copied and neither set may be used afterwards. Sets backed by binary search trees are treaps,
+ * and combining them takes O(m log(n/m + 1)) expected work, where m is the size of the smaller set.
+ * Splay-backed sets are first rebuilt into treaps and B-tree backed sets are first moved into one,
+ * which takes O(n) time. The two sets must be distinct and use functionally equivalent comparison
+ * functions, which the result also uses. Where both sets hold equivalent elements, the one from
+ * setA is kept and the other is not freed.
+ *
+ * Arguments:
+ * setA -- The first set in the pair of sets to union
+ * setB -- The second set in the pair of sets to union
+ *
+ * Returns:
+ * A set containing all non-equivalent elements from setA and setB.
+ */
+extern Set *setParallelUnion( Set *setA, Set *setB );
+
+/*
+ * Calculates the intersection of two sets with the join-based parallel algorithm on the default
+ * thread pool. Both sets are consumed, and the work is bounded as in setParallelUnion. Elements
+ * that are not kept are not freed.
+ *
+ * Arguments:
+ * setA -- The first set in the pair of sets to intersect
+ * setB -- The second set in the pair of sets to intersect
+ *
+ * Returns:
+ * A set containing the elements of setA that are also present in setB.
+ */
+extern Set *setParallelIntersect( Set *setA, Set *setB );
+
+/*
+ * Calculates the difference of two sets with the join-based parallel algorithm on the default
+ * thread pool. Both sets are consumed, and the work is bounded as in setParallelUnion. Elements
+ * that are not kept are not freed.
+ *
+ * Arguments:
+ * setA -- The set whose elements are kept
+ * setB -- The set whose elements are removed
+ *
+ * Returns:
+ * A set containing the elements of setA that are not present in setB.
+ */
+extern Set *setParallelDifference( Set *setA, Set *setB );
+
+/*
+ * Applies the consumer function to every element within the set, with the elements partitioned
+ * across the workers of the default thread pool. The consumer is called concurrently from several
+ * threads, so it must be safe to do so, and the order in which elements are visited is unspecified.
+ *
+ * Arguments:
+ * set      -- The set that will have the function applied
+ * consumer -- The function that will be applied to every element within the set.
+ */
+extern void setParallelForEach( Set *set, ElementConsumer consumer );
+
+/*
+ * Creates a new set by applying the map function to every element of the set in parallel, using the
+ * default thread pool. The mapped elements are sorted in parallel and the result set is built from
+ * them in a single pass, rather than by adding each element individually. Mapped elements that are
+ * equivalent to an earlier mapped element are freed.
+ *
+ * Arguments:
+ * set                -- The set whose elements will be mapped over
+ * function           -- The function that will be applied to every element in the set. This
+ *                       function is called concurrently from several threads and should allocate
+ *                       new space for its result.
+ * comparisonfunction -- A function that can be used to compare elements in the codomain of the
+ *                       mapping function. If this is NULL, the comparison function of the original
+ *                       set will be used, as in setMap.
+ *
+ * Returns:
+ * A new set containing every element within the original set after the function has been applied.
+ */
+extern Set *setParallelMap( Set *set, MapFunction function, ComparisonFunction comparisonFunction );
+
 /*
  * Frees the memory used by this set.
  *
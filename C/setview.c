@@ -0,0 +1,373 @@
+#include <stdlib.h>
+
+#include "utils.h"
+#include "setview.h"
+
+/* Implementation specific helper functions */
+SetView *combineViews( SetViewOperation operation, SetView *left, SetView *right );
+int initViewCursor( SetViewIterator *iterator, SetView *view );
+void *nextViewCursor( SetViewIterator *iterator, int index );
+void *nextUnion( SetViewIterator *iterator, SetViewCursor *cursor );
+void *nextIntersection( SetViewIterator *iterator, SetViewCursor *cursor );
+void *nextDifference( SetViewIterator *iterator, SetViewCursor *cursor );
+
+/*
+ * Creates a view of a single set.
+ *
+ * Arguments:
+ * set -- The set that the view shows
+ *
+ * Returns:
+ * A view containing exactly the set's elements
+ */
+SetView *newSetView( Set *set ) {
+    SetView *view = malloc( sizeof(SetView) );
+    view->operation = SET_VIEW_SET;
+    view->comparisonFunction = set->comparisonFunction;
+    view->set = set;
+    view->left = NULL;
+    view->right = NULL;
+    view->nodes = 1;
+
+    return view;
+}
+
+/*
+ * Creates a view that combines two views, which it takes ownership of. The combined view orders its
+ * elements with the first view's comparison function.
+ *
+ * Arguments:
+ * operation -- How the views are combined
+ * left      -- The first view
+ * right     -- The second view
+ *
+ * Returns:
+ * The combined view, or NULL if it would have more than SET_VIEW_MAX_NODES nodes
+ */
+SetView *combineViews( SetViewOperation operation, SetView *left, SetView *right ) {
+    if( left->nodes + right->nodes + 1 > SET_VIEW_MAX_NODES ) {
+        debug( E_ERROR, "A view can have at most %d nodes\n", SET_VIEW_MAX_NODES );
+        return NULL;
+    }
+
+    SetView *view = malloc( sizeof(SetView) );
+    view->operation = operation;
+    view->comparisonFunction = left->comparisonFunction;
+    view->set = NULL;
+    view->left = left;
+    view->right = right;
+    view->nodes = left->nodes + right->nodes + 1;
+
+    return view;
+}
+
+/*
+ * Creates a view of the union of two views, which it takes ownership of. The two views should use
+ * functionally equivalent comparison functions.
+ *
+ * Arguments:
+ * left  -- The first view in the union
+ * right -- The second view in the union
+ *
+ * Returns:
+ * A view containing the elements of either view. Equivalent elements are only returned once, from
+ * the first view. NULL if the combined view would have more than SET_VIEW_MAX_NODES nodes, in which
+ * case the caller keeps both views.
+ */
+SetView *setViewUnion( SetView *left, SetView *right ) {
+    return combineViews( SET_VIEW_UNION, left, right );
+}
+
+/*
+ * Creates a view of the intersection of two views, which it takes ownership of.
+ *
+ * Arguments:
+ * left  -- The view whose elements are kept
+ * right -- The view the elements must also be in
+ *
+ * Returns:
+ * A view containing the elements of the first view that are also in the second. NULL if the
+ * combined view would have more than SET_VIEW_MAX_NODES nodes, in which case the caller keeps both
+ * views.
+ */
+SetView *setViewIntersect( SetView *left, SetView *right ) {
+    return combineViews( SET_VIEW_INTERSECTION, left, right );
+}
+
+/*
+ * Creates a view of the difference of two views, which it takes ownership of.
+ *
+ * Arguments:
+ * left  -- The view whose elements are kept
+ * right -- The view whose elements are excluded
+ *
+ * Returns:
+ * A view containing the elements of the first view that are not in the second. NULL if the combined
+ * view would have more than SET_VIEW_MAX_NODES nodes, in which case the caller keeps both views.
+ */
+SetView *setViewDifference( SetView *left, SetView *right ) {
+    return combineViews( SET_VIEW_DIFFERENCE, left, right );
+}
+
+/*
+ * Determines whether an element is in a view by testing the underlying sets, without iterating.
+ *
+ * Arguments:
+ * view    -- The view to search through
+ * element -- The element to check the view for
+ *
+ * Returns:
+ * True if the element is in the view, false otherwise
+ */
+bool setViewContains( SetView *view, void *element ) {
+    if( view->operation == SET_VIEW_UNION ) {
+        return setViewContains( view->left, element ) || setViewContains( view->right, element );
+    } else if( view->operation == SET_VIEW_INTERSECTION ) {
+        return setViewContains( view->left, element ) && setViewContains( view->right, element );
+    } else if( view->operation == SET_VIEW_DIFFERENCE ) {
+        return setViewContains( view->left, element ) &&
+            ! setViewContains( view->right, element );
+    }
+
+    return isInSet( view->set, element );
+}
+
+/*
+ * Positions an iterator before the smallest element of a view. The iterator needs no freeing.
+ *
+ * Arguments:
+ * iterator -- The iterator that is being set up
+ * view     -- The view that will be walked
+ */
+void setViewIteratorInit( SetViewIterator *iterator, SetView *view ) {
+    iterator->cursors = 0;
+    initViewCursor( iterator, view );
+}
+
+/*
+ * Claims the next free cursor of an iterator for a node of the view, along with cursors for the
+ * node's operands. The recursion is bounded by the number of nodes in the view.
+ *
+ * Arguments:
+ * iterator -- The iterator that the cursors belong to
+ * view     -- The node of the view that the cursor walks
+ *
+ * Returns:
+ * The index of the node's cursor
+ */
+int initViewCursor( SetViewIterator *iterator, SetView *view ) {
+    int index = iterator->cursors++;
+    SetViewCursor *cursor = &iterator->cursor[ index ];
+
+    cursor->view = view;
+    cursor->left = -1;
+    cursor->right = -1;
+    cursor->leftNext = NULL;
+    cursor->rightNext = NULL;
+
+    if( view->operation == SET_VIEW_SET ) {
+        setIteratorInit( &cursor->setIterator, view->set );
+    } else {
+        // Each operand's smallest element is read ahead so the two can be compared
+        cursor->left = initViewCursor( iterator, view->left );
+        cursor->right = initViewCursor( iterator, view->right );
+        cursor->leftNext = nextViewCursor( iterator, cursor->left );
+        cursor->rightNext = nextViewCursor( iterator, cursor->right );
+    }
+
+    return index;
+}
+
+/*
+ * Advances an iterator to the next element of its view.
+ *
+ * Arguments:
+ * iterator -- The iterator to advance
+ *
+ * Returns:
+ * The next element in order, or NULL once every element has been returned
+ */
+void *setViewIteratorNext( SetViewIterator *iterator ) {
+    return nextViewCursor( iterator, 0 );
+}
+
+/*
+ * Advances one cursor of an iterator to the next element of its node of the view.
+ *
+ * Arguments:
+ * iterator -- The iterator that the cursor belongs to
+ * index    -- The index of the cursor to advance
+ *
+ * Returns:
+ * The node's next element in order, or NULL once every element has been returned
+ */
+void *nextViewCursor( SetViewIterator *iterator, int index ) {
+    SetViewCursor *cursor = &iterator->cursor[ index ];
+    SetViewOperation operation = cursor->view->operation;
+
+    if( operation == SET_VIEW_UNION ) {
+        return nextUnion( iterator, cursor );
+    } else if( operation == SET_VIEW_INTERSECTION ) {
+        return nextIntersection( iterator, cursor );
+    } else if( operation == SET_VIEW_DIFFERENCE ) {
+        return nextDifference( iterator, cursor );
+    }
+
+    return setIteratorNext( &cursor->setIterator );
+}
+
+/*
+ * Returns the smaller of the two operands' next elements, advancing past it in every operand that
+ * holds it.
+ *
+ * Arguments:
+ * iterator -- The iterator that the cursor belongs to
+ * cursor   -- The cursor over a union view
+ *
+ * Returns:
+ * The next element of the union, or NULL if both operands are exhausted
+ */
+void *nextUnion( SetViewIterator *iterator, SetViewCursor *cursor ) {
+    void *left = cursor->leftNext;
+    void *right = cursor->rightNext;
+
+    if( left == NULL && right == NULL ) {
+        return NULL;
+    }
+
+    int comparisonResult = 0;
+    if( left == NULL ) {
+        comparisonResult = 1;
+    } else if( right == NULL ) {
+        comparisonResult = -1;
+    } else {
+        comparisonResult = cursor->view->comparisonFunction( left, right );
+    }
+
+    if( comparisonResult <= 0 ) {
+        cursor->leftNext = nextViewCursor( iterator, cursor->left );
+    }
+
+    if( comparisonResult >= 0 ) {
+        cursor->rightNext = nextViewCursor( iterator, cursor->right );
+    }
+
+    return comparisonResult <= 0 ? left : right;
+}
+
+/*
+ * Advances whichever operand is behind until both operands hold equivalent elements.
+ *
+ * Arguments:
+ * iterator -- The iterator that the cursor belongs to
+ * cursor   -- The cursor over an intersection view
+ *
+ * Returns:
+ * The next element of the intersection, or NULL if either operand is exhausted
+ */
+void *nextIntersection( SetViewIterator *iterator, SetViewCursor *cursor ) {
+    ComparisonFunction compare = cursor->view->comparisonFunction;
+
+    while( cursor->leftNext != NULL && cursor->rightNext != NULL ) {
+        int comparisonResult = compare( cursor->leftNext, cursor->rightNext );
+
+        if( comparisonResult < 0 ) {
+            cursor->leftNext = nextViewCursor( iterator, cursor->left );
+        } else if( comparisonResult > 0 ) {
+            cursor->rightNext = nextViewCursor( iterator, cursor->right );
+        } else {
+            void *element = cursor->leftNext;
+            cursor->leftNext = nextViewCursor( iterator, cursor->left );
+            cursor->rightNext = nextViewCursor( iterator, cursor->right );
+
+            return element;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Advances the first operand past every element that the second operand also holds.
+ *
+ * Arguments:
+ * iterator -- The iterator that the cursor belongs to
+ * cursor   -- The cursor over a difference view
+ *
+ * Returns:
+ * The next element of the difference, or NULL if the first operand is exhausted
+ */
+void *nextDifference( SetViewIterator *iterator, SetViewCursor *cursor ) {
+    ComparisonFunction compare = cursor->view->comparisonFunction;
+
+    while( cursor->leftNext != NULL ) {
+        void *element = cursor->leftNext;
+        int comparisonResult = -1;
+
+        while( cursor->rightNext != NULL &&
+                (comparisonResult = compare( element, cursor->rightNext )) > 0 ) {
+            cursor->rightNext = nextViewCursor( iterator, cursor->right );
+        }
+
+        cursor->leftNext = nextViewCursor( iterator, cursor->left );
+
+        if( cursor->rightNext == NULL || comparisonResult < 0 ) {
+            return element;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Applies the consumer function to every element of a view, in order.
+ *
+ * Arguments:
+ * view     -- The view whose elements will be consumed
+ * consumer -- The function that will be applied to every element of the view
+ */
+void setViewForEach( SetView *view, ElementConsumer consumer ) {
+    SetViewIterator iterator;
+    void *element;
+
+    setViewIteratorInit( &iterator, view );
+    while( (element = setViewIteratorNext( &iterator )) != NULL ) {
+        consumer( element );
+    }
+}
+
+/*
+ * Counts the elements of a view. This walks the whole view.
+ *
+ * Arguments:
+ * view -- The view whose elements are being counted
+ *
+ * Returns:
+ * The number of elements in the view
+ */
+int setViewCount( SetView *view ) {
+    SetViewIterator iterator;
+    int count = 0;
+
+    setViewIteratorInit( &iterator, view );
+    while( setViewIteratorNext( &iterator ) != NULL ) {
+        count++;
+    }
+
+    return count;
+}
+
+/*
+ * Frees a view along with the views it combines. The underlying sets are not freed.
+ *
+ * Arguments:
+ * view -- The view that is being freed
+ */
+void setViewFree( SetView *view ) {
+    if( view->left != NULL ) {
+        setViewFree( view->left );
+        setViewFree( view->right );
+    }
+
+    free( view );
+}
@@ -0,0 +1,183 @@
+#ifndef SETVIEW_H
+#define SETVIEW_H
+
+#include <stdbool.h>
+
+#include "functions.h"
+#include "set.h"
+
+/* The most nodes a view can have, which bounds the number of cursors its iterators hold */
+#define SET_VIEW_MAX_NODES 32
+
+/*
+ * The operations that a set view can represent.
+ *
+ * SET_VIEW_SET          -- The elements of a single set
+ * SET_VIEW_UNION        -- The elements of either operand
+ * SET_VIEW_INTERSECTION -- The elements of the first operand that are also in the second
+ * SET_VIEW_DIFFERENCE   -- The elements of the first operand that are not in the second
+ */
+typedef enum SetViewOperation {
+    SET_VIEW_SET,
+    SET_VIEW_UNION,
+    SET_VIEW_INTERSECTION,
+    SET_VIEW_DIFFERENCE
+} SetViewOperation;
+
+/*
+ * A lazy description of a combination of sets. A view never copies any elements: membership tests
+ * are answered by testing the underlying sets, and iteration merges the underlying sets' in-order
+ * iterators as it goes. Views can be combined into larger views, so a pipeline that combines
+ * several sets only allocates one small node per operation, however many elements are involved.
+ *
+ * A view borrows its sets, which must outlive it and must not be modified while the view is being
+ * iterated. A view that combines other views owns them. A view has at most SET_VIEW_MAX_NODES
+ * nodes, so it can combine up to half that many sets.
+ */
+typedef struct SetView {
+    SetViewOperation operation;
+    ComparisonFunction comparisonFunction;
+    Set *set;
+    struct SetView *left;
+    struct SetView *right;
+    int nodes;
+} SetView;
+
+/*
+ * The position of an iterator within one node of a view. A cursor over a set walks the set, while
+ * a combining cursor holds the next element of both of its operands and the indices of their
+ * cursors.
+ */
+typedef struct SetViewCursor {
+    SetView *view;
+    SetIterator setIterator;
+    int left;
+    int right;
+    void *leftNext;
+    void *rightNext;
+} SetViewCursor;
+
+/*
+ * An in-order iterator over a view. The iterator keeps one cursor for every node of the view in a
+ * fixed size array, with the view's root first. Iterators are usually declared on the stack and set
+ * up with setViewIteratorInit, so walking a view allocates nothing.
+ */
+typedef struct SetViewIterator {
+    int cursors;
+    SetViewCursor cursor[ SET_VIEW_MAX_NODES ];
+} SetViewIterator;
+
+/*
+ * Creates a view of a single set.
+ *
+ * Arguments:
+ * set -- The set that the view shows
+ *
+ * Returns:
+ * A view containing exactly the set's elements
+ */
+extern SetView *newSetView( Set *set );
+
+/*
+ * Creates a view of the union of two views, which it takes ownership of. The two views should use
+ * functionally equivalent comparison functions.
+ *
+ * Arguments:
+ * left  -- The first view in the union
+ * right -- The second view in the union
+ *
+ * Returns:
+ * A view containing the elements of either view. Equivalent elements are only returned once, from
+ * the first view. NULL if the combined view would have more than SET_VIEW_MAX_NODES nodes, in which
+ * case the caller keeps both views.
+ */
+extern SetView *setViewUnion( SetView *left, SetView *right );
+
+/*
+ * Creates a view of the intersection of two views, which it takes ownership of.
+ *
+ * Arguments:
+ * left  -- The view whose elements are kept
+ * right -- The view the elements must also be in
+ *
+ * Returns:
+ * A view containing the elements of the first view that are also in the second. NULL if the
+ * combined view would have more than SET_VIEW_MAX_NODES nodes, in which case the caller keeps both
+ * views.
+ */
+extern SetView *setViewIntersect( SetView *left, SetView *right );
+
+/*
+ * Creates a view of the difference of two views, which it takes ownership of.
+ *
+ * Arguments:
+ * left  -- The view whose elements are kept
+ * right -- The view whose elements are excluded
+ *
+ * Returns:
+ * A view containing the elements of the first view that are not in the second. NULL if the combined
+ * view would have more than SET_VIEW_MAX_NODES nodes, in which case the caller keeps both views.
+ */
+extern SetView *setViewDifference( SetView *left, SetView *right );
+
+/*
+ * Determines whether an element is in a view by testing the underlying sets, without iterating.
+ *
+ * Arguments:
+ * view    -- The view to search through
+ * element -- The element to check the view for
+ *
+ * Returns:
+ * True if the element is in the view, false otherwise
+ */
+extern bool setViewContains( SetView *view, void *element );
+
+/*
+ * Positions an iterator before the smallest element of a view. The iterator needs no freeing.
+ *
+ * Arguments:
+ * iterator -- The iterator that is being set up
+ * view     -- The view that will be walked
+ */
+extern void setViewIteratorInit( SetViewIterator *iterator, SetView *view );
+
+/*
+ * Advances an iterator to the next element of its view.
+ *
+ * Arguments:
+ * iterator -- The iterator to advance
+ *
+ * Returns:
+ * The next element in order, or NULL once every element has been returned
+ */
+extern void *setViewIteratorNext( SetViewIterator *iterator );
+
+/*
+ * Applies the consumer function to every element of a view, in order.
+ *
+ * Arguments:
+ * view     -- The view whose elements will be consumed
+ * consumer -- The function that will be applied to every element of the view
+ */
+extern void setViewForEach( SetView *view, ElementConsumer consumer );
+
+/*
+ * Counts the elements of a view. This walks the whole view.
+ *
+ * Arguments:
+ * view -- The view whose elements are being counted
+ *
+ * Returns:
+ * The number of elements in the view
+ */
+extern int setViewCount( SetView *view );
+
+/*
+ * Frees a view along with the views it combines. The underlying sets are not freed.
+ *
+ * Arguments:
+ * view -- The view that is being freed
+ */
+extern void setViewFree( SetView *view );
+
+#endif
@@ -0,0 +1,96 @@
+#include <stdlib.h>
+#include <time.h>
+
+#include "bloom.h"
+#include "utils.h"
+
+/* Test functions */
+void testNewBloomFilter();
+void testNoFalseNegatives();
+void testFalsePositiveRate();
+void testBloomClear();
+
+int main( int argc, char *argv[] ) {
+    setDebuggingLevel( E_ERROR );
+    srand( time(NULL) );
+
+    testNewBloomFilter();
+    testNoFalseNegatives();
+    testFalsePositiveRate();
+    testBloomClear();
+
+    return 0;
+}
+
+void testNewBloomFilter() {
+    BloomFilter *filter = newBloomFilter( 1000 );
+
+    assertNotNull( filter, "The new filter shouldn't be null!\n" );
+    assertTrue( filter->numBlocks * BLOOM_BLOCK_BITS >= 1000 * BLOOM_BITS_PER_ELEMENT,
+            "The filter should have at least %d bits!\n", 1000 * BLOOM_BITS_PER_ELEMENT );
+    assertTrue( ((unsigned long) filter->blocks) % CACHE_LINE_SIZE == 0,
+            "The blocks should be aligned to cache lines!\n" );
+    assertFalse( bloomMightContain( filter, 42 ), "An empty filter shouldn't contain anything!\n" );
+
+    bloomFree( filter );
+}
+
+void testNoFalseNegatives() {
+    const int numElements = 10000;
+    BloomFilter *filter = newBloomFilter( numElements );
+    unsigned long hashes[ numElements ];
+
+    for( int i = 0; i < numElements; i++ ) {
+        hashes[i] = (unsigned long) rand();
+        bloomAdd( filter, hashes[i] );
+    }
+
+    assertTrue( filter->size == numElements, "Filter size should be %d, was %d\n", numElements,
+            filter->size );
+
+    for( int i = 0; i < numElements; i++ ) {
+        assertTrue( bloomMightContain( filter, hashes[i] ), "Filter should contain %lu!\n",
+                hashes[i] );
+    }
+
+    bloomFree( filter );
+}
+
+void testFalsePositiveRate() {
+    const int numElements = 10000;
+    BloomFilter *filter = newBloomFilter( numElements );
+
+    // Sequential integers are a worst case for an unmixed hash
+    for( int i = 0; i < numElements; i++ ) {
+        bloomAdd( filter, i );
+    }
+
+    int falsePositives = 0;
+    for( int i = numElements; i < 2 * numElements; i++ ) {
+        falsePositives += bloomMightContain( filter, i );
+    }
+
+    // The expected rate is around 1%, so 3% leaves plenty of room
+    assertTrue( falsePositives < numElements * 3 / 100, "%d false positives out of %d lookups!\n",
+            falsePositives, numElements );
+
+    bloomFree( filter );
+}
+
+void testBloomClear() {
+    BloomFilter *filter = newBloomFilter( 100 );
+
+    for( int i = 0; i < 100; i++ ) {
+        bloomAdd( filter, i );
+    }
+
+    bloomClear( filter );
+    assertTrue( filter->size == 0, "Filter size should be 0 after clearing, was %d\n",
+            filter->size );
+
+    for( int i = 0; i < 100; i++ ) {
+        assertFalse( bloomMightContain( filter, i ), "Cleared filter shouldn't contain %d!\n", i );
+    }
+
+    bloomFree( filter );
+}
@@ -11,11 +11,38 @@ void testTreeInsertion();
 void testTreeFind();
 void testTraversals();
 void testTreeRemoval();
+void testSortedArrayBuild();
+void testSplitJoin();
+void testJoinOperations();
+void testBatchFind();
+void testSplayTree();
+void testShapeStats();
+void testRebalance();
+void testTraversalOrders();
+void testDegenerateTree();
+void testDegenerateJoins();
+void testMinMax();
+void testInsertHint();
+void testTreapMaintenance();
 
 /* Functions used in testing */
 void printNode( BSTNode *node );
 int comparisonFunction( void *aPtr, void *bPtr );
+int countingComparison( void *aPtr, void *bPtr );
 int *mallocInt( int a );
+BST *rangeTree( int start, int end, int step );
+int parentsAreValid( BSTNode *node );
+void checkExtremes( BST *bst );
+void recordNode( BSTNode *node );
+BST *rightVine( int numElements );
+BST *plainTree();
+
+/* The number of times countingComparison has been called */
+long comparisons = 0;
+
+/* The elements supplied to recordNode, in the order they were visited */
+int *visits = NULL;
+int numVisits = 0;
 
 int main( int argc, char *argv[] ) {
     setDebuggingLevel( E_ERROR );
@@ -26,6 +53,19 @@ int main( int argc, char *argv[] ) {
     testTreeFind();
     testTraversals();
     testTreeRemoval();
+    testSortedArrayBuild();
+    testSplitJoin();
+    testJoinOperations();
+    testBatchFind();
+    testSplayTree();
+    testShapeStats();
+    testRebalance();
+    testTraversalOrders();
+    testDegenerateTree();
+    testDegenerateJoins();
+    testMinMax();
+    testInsertHint();
+    testTreapMaintenance();
 }
 
 void testTreeCreation() {
@@ -164,7 +204,687 @@ void testTreeRemoval() {
     bstFree( bst );
 }
 
+void testSortedArrayBuild() {
+    const int numElements = 1000;
+    void **sorted = malloc( sizeof(void *) * numElements );
+
+    for( int i = 0; i < numElements; i++ ) {
+        sorted[i] = mallocInt( i );
+    }
+
+    BST *bst = bstFromSortedArray( comparisonFunction, sorted, numElements );
+    assertTrue( bst->size == numElements, "BST size should be %d, was %d!\n", numElements,
+            bst->size );
+    assertTrue( bst->root->data == sorted[ numElements / 2 ],
+            "The root should be the middle element!\n" );
+
+    // The tree should hold every element, in order
+    void **elements = bstElements( bst );
+    for( int i = 0; i < numElements; i++ ) {
+        assertTrue( elements[i] == sorted[i], "Element %d is out of place!\n", i );
+        assertNotNull( bstFind( bst, sorted[i] ), "Could not find %d in the tree!\n", i );
+    }
+
+    // Parent pointers should allow an in-order walk with successor
+    int count = 0;
+    BSTNode *node = bst->root;
+    while( node->left ) {
+        node = node->left;
+    }
+
+    for( ; node != NULL; node = successor( node ) ) {
+        count++;
+    }
+
+    assertTrue( count == numElements, "Successor walk visited %d nodes, expected %d!\n", count,
+            numElements );
+
+    free( elements );
+    free( sorted );
+    bstFree( bst );
+}
+
+void testSplitJoin() {
+    const int numElements = 1000;
+    BST *bst = rangeTree( 0, numElements, 1 );
+    BST *less = NULL;
+    BST *greater = NULL;
+
+    // Split around an element that is in the tree
+    int *key = mallocInt( 400 );
+    int *found = bstSplit( bst, key, &less, &greater );
+
+    assertTrue( found != NULL && *found == 400, "Split should have found 400!\n" );
+    assertTrue( less->size == BST_SIZE_UNKNOWN && greater->size == BST_SIZE_UNKNOWN,
+            "Splitting shouldn't count the halves!\n" );
+    assertTrue( bstSize( less ) == 400, "Lesser tree size should be 400, was %d!\n", less->size );
+    assertTrue( bstSize( greater ) == numElements - 401,
+            "Greater tree size should be %d, was %d!\n", numElements - 401, greater->size );
+    assertTrue( parentsAreValid( less->root ) && parentsAreValid( greater->root ),
+            "Parent pointers are invalid after splitting!\n" );
+
+    void **lessElements = bstElements( less );
+    for( int i = 0; i < less->size; i++ ) {
+        assertTrue( *(int *) lessElements[i] == i, "Lesser tree is out of order at %d!\n", i );
+    }
+    free( lessElements );
+
+    // Joining around the found element should restore the original tree
+    BST *joined = bstJoin( less, found, greater );
+    assertTrue( joined->size == numElements, "Joined tree size should be %d, was %d!\n",
+            numElements, joined->size );
+    assertTrue( parentsAreValid( joined->root ), "Parent pointers are invalid after joining!\n" );
+    assertTrue( joined->treap, "Joining treaps should give a treap!\n" );
+
+    void **elements = bstElements( joined );
+    for( int i = 0; i < numElements; i++ ) {
+        assertTrue( *(int *) elements[i] == i, "Joined tree is out of order at %d!\n", i );
+    }
+    free( elements );
+
+    // Splitting around a missing element shouldn't find anything
+    *key = numElements * 2;
+    found = bstSplit( joined, key, &less, &greater );
+    assertNull( found, "Split should not have found %d!\n", *key );
+    assertTrue( less->size == numElements && greater->size == 0,
+            "All elements should be in the lesser tree!\n" );
+
+    joined = bstJoin( less, NULL, greater );
+    assertTrue( joined->size == numElements, "Joined tree size should be %d, was %d!\n",
+            numElements, joined->size );
+
+    free( key );
+    bstFree( joined );
+}
+
+void testJoinOperations() {
+    const int numElements = 20000;
+    ThreadPool *pool = newThreadPool( 4 );
+
+    for( int parallel = 0; parallel <= 1; parallel++ ) {
+        ThreadPool *operationPool = parallel ? pool : NULL;
+
+        // Multiples of 2 and multiples of 3 overlap on the multiples of 6
+        BST *evens = rangeTree( 0, numElements, 2 );
+        BST *threes = rangeTree( 0, numElements, 3 );
+        BST *unionResult = bstUnion( bstCopy( evens ), bstCopy( threes ), operationPool );
+        BST *intersectResult = bstIntersect( bstCopy( evens ), bstCopy( threes ), operationPool );
+        BST *differenceResult = bstDifference( bstCopy( evens ), bstCopy( threes ), operationPool );
+
+        int expectedUnion = 0;
+        int expectedIntersect = 0;
+        int expectedDifference = 0;
+        for( int i = 0; i < numElements; i++ ) {
+            int isEven = i % 2 == 0;
+            int isThree = i % 3 == 0;
+
+            expectedUnion += isEven || isThree;
+            expectedIntersect += isEven && isThree;
+            expectedDifference += isEven && ! isThree;
+
+            int *element = mallocInt( i );
+            assertTrue( (bstFind( unionResult, element ) != NULL) == (isEven || isThree),
+                    "Union membership of %d is wrong!\n", i );
+            assertTrue( (bstFind( intersectResult, element ) != NULL) == (isEven && isThree),
+                    "Intersection membership of %d is wrong!\n", i );
+            assertTrue( (bstFind( differenceResult, element ) != NULL) == (isEven && ! isThree),
+                    "Difference membership of %d is wrong!\n", i );
+            free( element );
+        }
+
+        assertTrue( unionResult->size == expectedUnion, "Union size should be %d, was %d!\n",
+                expectedUnion, unionResult->size );
+        assertTrue( intersectResult->size == expectedIntersect,
+                "Intersection size should be %d, was %d!\n", expectedIntersect,
+                intersectResult->size );
+        assertTrue( differenceResult->size == expectedDifference,
+                "Difference size should be %d, was %d!\n", expectedDifference,
+                differenceResult->size );
+        assertTrue( parentsAreValid( unionResult->root ) && parentsAreValid( intersectResult->root )
+                && parentsAreValid( differenceResult->root ), "Parent pointers are invalid!\n" );
+
+        // The results share their elements with the original trees
+        bstFreeStructure( unionResult );
+        bstFreeStructure( intersectResult );
+        bstFreeStructure( differenceResult );
+        bstFree( evens );
+        bstFree( threes );
+    }
+
+    threadPoolFree( pool );
+}
+
+void testBatchFind() {
+    const int numElements = 1000;
+    const int numKeys = 3 * numElements;
+    BST *bst = rangeTree( 0, 2 * numElements, 2 );
+    void **keys = malloc( sizeof(void *) * numKeys );
+    void **results = malloc( sizeof(void *) * numKeys );
+
+    // Even keys are in the tree and odd keys aren't, including some past either end of it
+    for( int i = 0; i < numKeys; i++ ) {
+        keys[i] = mallocInt( i - numElements / 2 );
+    }
+
+    int found = bstFindBatch( bst, keys, numKeys, results );
+    assertTrue( found == numElements, "Batch should have found %d keys, found %d!\n", numElements,
+            found );
+
+    for( int i = 0; i < numKeys; i++ ) {
+        assertTrue( results[i] == bstFind( bst, keys[i] ), "Batch result %d doesn't match!\n", i );
+        free( keys[i] );
+    }
+
+    // Batches smaller than the number of searches in flight still work
+    BST *empty = newBST( comparisonFunction );
+    int *missing = mallocInt( 7 );
+    assertTrue( bstFindBatch( empty, (void **) &missing, 1, results ) == 0,
+            "Nothing should be found in an empty tree!\n" );
+    assertNull( results[0], "The result for an empty tree should be NULL!\n" );
+
+    free( missing );
+    free( keys );
+    free( results );
+    bstFree( empty );
+    bstFree( bst );
+}
+
+void testSplayTree() {
+    const int numElements = 500;
+    BST *bst = newSplayTree( comparisonFunction );
+
+    // Ascending inserts would make a plain tree a list, but each one is splayed to the root
+    for( int i = 0; i < numElements; i++ ) {
+        bstInsert( bst, mallocInt( i ) );
+        assertTrue( *(int *) bst->root->data == i, "The inserted element should be the root!\n" );
+    }
+
+    int *duplicate = mallocInt( 10 );
+    bstInsert( bst, duplicate );
+    assertTrue( bst->size == numElements, "Size should be %d, was %d\n", numElements, bst->size );
+    assertTrue( *(int *) bst->root->data == 10, "A duplicate insert should splay the original!\n" );
+    free( duplicate );
+
+    for( int i = 0; i < numElements; i += 7 ) {
+        int *element = mallocInt( i );
+        assertTrue( *(int *) bstFind( bst, element ) == i, "%d should be in the tree!\n", i );
+        assertTrue( *(int *) bst->root->data == i, "A found element should be the root!\n" );
+        assertTrue( parentsAreValid( bst->root ), "Parent pointers are invalid after splaying!\n" );
+        free( element );
+    }
+
+    int *missing = mallocInt( numElements );
+    assertNull( bstFind( bst, missing ), "%d should not be in the tree!\n", numElements );
+    assertTrue( *(int *) bst->root->data == numElements - 1,
+            "A failed search should splay the last node it visited!\n" );
+    assertNull( bstRemove( bst, missing ), "Removing a missing element should return NULL!\n" );
+    free( missing );
+
+    for( int i = 0; i < numElements; i += 2 ) {
+        int *element = mallocInt( i );
+        free( bstRemove( bst, element ) );
+        free( element );
+    }
+
+    assertTrue( bst->size == numElements / 2, "Size should be %d, was %d\n", numElements / 2,
+            bst->size );
+    assertTrue( parentsAreValid( bst->root ), "Parent pointers are invalid after removal!\n" );
+
+    // The remaining odd numbers should still be in order
+    void **elements = bstElements( bst );
+    for( int i = 0; i < bst->size; i++ ) {
+        assertTrue( *(int *) elements[i] == 2 * i + 1, "Element %d is out of order!\n", i );
+    }
+
+    free( elements );
+    bstFree( bst );
+}
+
+void testShapeStats() {
+    BSTShapeStats stats;
+    BST *bst = plainTree();
+
+    bstShapeStats( bst, &stats );
+    assertTrue( stats.size == 0 && stats.height == 0 && stats.averageDepth == 0,
+            "An empty tree should have no shape!\n" );
+
+    // 4 at the root, 2 and 6 below it, then 1, 3, 5 and 7, then 8 at the bottom
+    int order[] = { 4, 2, 6, 1, 3, 5, 7, 8 };
+    for( int i = 0; i < 8; i++ ) {
+        bstInsert( bst, mallocInt( order[i] ) );
+    }
+
+    bstShapeStats( bst, &stats );
+    assertTrue( stats.size == 8, "Size should be 8, was %d\n", stats.size );
+    assertTrue( stats.height == 4, "Height should be 4, was %d\n", stats.height );
+    assertTrue( stats.averageDepth == 21.0 / 8, "Average depth should be 2.625, was %f\n",
+            stats.averageDepth );
+    assertTrue( bstHeight( bst ) == 4, "Height should be 4, was %d\n", bstHeight( bst ) );
+
+    bstFree( bst );
+}
+
+void testRebalance() {
+    int sizes[] = { 0, 1, 2, 3, 7, 8, 100, 1023, 5000 };
+
+    for( int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++ ) {
+        int size = sizes[i];
+        BST *bst = plainTree();
+
+        // Ascending inserts leave the tree as a list
+        for( int j = 0; j < size; j++ ) {
+            bstInsert( bst, mallocInt( j ) );
+        }
+
+        assertTrue( bstHeight( bst ) == size, "The list should have height %d!\n", size );
+        bstRebalance( bst );
+
+        int minimumHeight = 0;
+        while( (1 << minimumHeight) - 1 < size ) {
+            minimumHeight++;
+        }
+
+        BSTShapeStats stats;
+        bstShapeStats( bst, &stats );
+        assertTrue( stats.size == size, "Rebalancing lost nodes: %d of %d\n", stats.size, size );
+        assertTrue( stats.height == minimumHeight, "Height should be %d, was %d\n", minimumHeight,
+                stats.height );
+        assertTrue( parentsAreValid( bst->root ), "Invalid parent pointers after rebalance!\n" );
+        assertTrue( bst->root == NULL || bst->root->parent == NULL, "The root has a parent!\n" );
+
+        void **elements = bstElements( bst );
+        for( int j = 0; j < size; j++ ) {
+            assertTrue( *(int *) elements[j] == j, "Element %d is out of order!\n", j );
+        }
+
+        free( elements );
+        bstFree( bst );
+    }
+}
+
+void testTraversalOrders() {
+    BST *bst = plainTree();
+    int order[] = { 4, 2, 6, 1, 3, 5, 7 };
+    int preOrder[] = { 4, 2, 1, 3, 6, 5, 7 };
+    int postOrder[] = { 1, 3, 2, 5, 7, 6, 4 };
+
+    for( int i = 0; i < 7; i++ ) {
+        bstInsert( bst, mallocInt( order[i] ) );
+    }
+
+    visits = malloc( sizeof(int) * 7 );
+
+    numVisits = 0;
+    bstPreOrder( bst, recordNode );
+    for( int i = 0; i < 7; i++ ) {
+        assertTrue( visits[i] == preOrder[i], "Pre-order visit %d was %d!\n", i, visits[i] );
+    }
+
+    numVisits = 0;
+    bstInOrder( bst, recordNode );
+    for( int i = 0; i < 7; i++ ) {
+        assertTrue( visits[i] == i + 1, "In-order visit %d was %d!\n", i, visits[i] );
+    }
+
+    numVisits = 0;
+    bstPostOrder( bst, recordNode );
+    for( int i = 0; i < 7; i++ ) {
+        assertTrue( visits[i] == postOrder[i], "Post-order visit %d was %d!\n", i, visits[i] );
+    }
+
+    free( visits );
+    bstFree( bst );
+}
+
+void testDegenerateTree() {
+    // Deep enough that recursing once per level would overflow the stack
+    const int numElements = 1000000;
+    BST *bst = rightVine( numElements );
+
+    visits = malloc( sizeof(int) * numElements );
+    numVisits = 0;
+    bstInOrder( bst, recordNode );
+    assertTrue( numVisits == numElements, "Visited %d of %d nodes!\n", numVisits, numElements );
+    for( int i = 0; i < numElements; i++ ) {
+        if( visits[i] != i ) {
+            assertTrue( 0, "In-order visit %d was %d!\n", i, visits[i] );
+            break;
+        }
+    }
+
+    numVisits = 0;
+    bstPostOrder( bst, recordNode );
+    assertTrue( numVisits == numElements && visits[0] == numElements - 1,
+            "The post-order walk should start at the bottom of the vine!\n" );
+    free( visits );
+
+    void **elements = bstElements( bst );
+    assertTrue( *(int *) elements[numElements - 1] == numElements - 1,
+            "The last element should be %d!\n", numElements - 1 );
+    free( elements );
+
+    BST *copy = bstCopy( bst );
+    assertTrue( bstHeight( copy ) == numElements, "The copy should also be a vine!\n" );
+    bstFreeStructure( copy );
+
+    // Removing the root repeatedly walks down the whole vine
+    for( int i = 0; i < 1000; i++ ) {
+        int *element = mallocInt( i );
+        free( bstRemove( bst, element ) );
+        free( element );
+    }
+
+    assertTrue( bst->size == numElements - 1000, "Size should be %d, was %d\n",
+            numElements - 1000, bst->size );
+
+    int *last = mallocInt( numElements - 1 );
+    free( bstRemove( bst, last ) );
+    assertNull( bstFind( bst, last ), "The bottom of the vine should have been removed!\n" );
+    free( last );
+
+    bstFree( bst );
+}
+
+void testDegenerateJoins() {
+    // Sorted inserts produce vines, which aren't heap ordered on the join priorities
+    const int numElements = 200000;
+    const int half = numElements / 2;
+    BST *vine = rightVine( numElements );
+    ThreadPool *pool = newThreadPool( 4 );
+
+    // Splitting and joining walk the vine without recursing once per level
+    BST *less = NULL;
+    BST *greater = NULL;
+    int *key = mallocInt( half );
+    int *found = bstSplit( bstCopy( vine ), key, &less, &greater );
+    free( key );
+
+    assertTrue( found != NULL && *found == half, "The split key should have been found!\n" );
+    assertTrue( bstSize( less ) == half && bstSize( greater ) == numElements - half - 1,
+            "The halves should have %d and %d elements, had %d and %d!\n", half,
+            numElements - half - 1, less->size, greater->size );
+
+    BST *joined = bstJoin( less, found, greater );
+    void **elements = bstElements( joined );
+    assertTrue( bstSize( joined ) == numElements,
+            "The joined tree should have %d elements, had %d!\n", numElements, joined->size );
+    for( int i = 0; i < numElements; i++ ) {
+        if( *(int *) elements[i] != i ) {
+            assertTrue( 0, "Joined element %d was %d!\n", i, *(int *) elements[i] );
+            break;
+        }
+    }
+    free( elements );
+    bstFreeStructure( joined );
+
+    for( int parallel = 0; parallel <= 1; parallel++ ) {
+        ThreadPool *operationPool = parallel ? pool : NULL;
+
+        // The lower half of the vine, which is still a vine
+        BST *lower = NULL;
+        BST *upper = NULL;
+        key = mallocInt( half );
+        found = bstSplit( bstCopy( vine ), key, &lower, &upper );
+        free( key );
+        bstFreeStructure( upper );
+
+        BST *unionResult = bstUnion( bstCopy( vine ), bstCopy( vine ), operationPool );
+        BST *intersectResult = bstIntersect( bstCopy( vine ), bstCopy( lower ), operationPool );
+        BST *differenceResult = bstDifference( bstCopy( vine ), lower, operationPool );
+
+        assertTrue( unionResult->size == numElements, "Union size should be %d, was %d!\n",
+                numElements, unionResult->size );
+        assertTrue( intersectResult->size == half, "Intersection size should be %d, was %d!\n",
+                half, intersectResult->size );
+        assertTrue( differenceResult->size == numElements - half,
+                "Difference size should be %d, was %d!\n", numElements - half,
+                differenceResult->size );
+
+        // The inputs are rebuilt as treaps, so the results are shallow
+        assertTrue( bstHeight( unionResult ) < 100 && bstHeight( intersectResult ) < 100
+                && bstHeight( differenceResult ) < 100,
+                "The results should be balanced, had heights %d, %d and %d!\n",
+                bstHeight( unionResult ), bstHeight( intersectResult ),
+                bstHeight( differenceResult ) );
+        assertTrue( parentsAreValid( unionResult->root ) && parentsAreValid( intersectResult->root )
+                && parentsAreValid( differenceResult->root ), "Parent pointers are invalid!\n" );
+
+        // Every result shares its elements with the original vine
+        bstFreeStructure( unionResult );
+        bstFreeStructure( intersectResult );
+        bstFreeStructure( differenceResult );
+    }
+
+    threadPoolFree( pool );
+    bstFree( vine );
+}
+
 /* Functions for use in testing */
+void testMinMax() {
+    BST *bst = newBST( comparisonFunction );
+    const int numElements = 1000;
+
+    assertNull( bstMin( bst ), "An empty tree has no minimum!\n" );
+    assertNull( bstMax( bst ), "An empty tree has no maximum!\n" );
+    assertNull( bstPopMin( bst ), "Nothing can be popped from an empty tree!\n" );
+    assertNull( bstPopMax( bst ), "Nothing can be popped from an empty tree!\n" );
+
+    // The extremes follow inserts
+    while( bst->size < numElements ) {
+        int *element = mallocInt( rand() % (10 * numElements) );
+        int size = bst->size;
+
+        bstInsert( bst, element );
+        if( bst->size == size ) {
+            free( element );
+        }
+
+        checkExtremes( bst );
+    }
+
+    // ...and removals, including removals of the extremes themselves
+    for( int i = 0; i < numElements / 4; i++ ) {
+        int value = i % 3 == 0 ? *(int *) bstMin( bst ) : rand() % (10 * numElements);
+        int *element = mallocInt( value );
+        free( bstRemove( bst, element ) );
+        free( element );
+
+        checkExtremes( bst );
+    }
+
+    // Popping from both ends returns the elements in order
+    int *low = bstPopMin( bst );
+    int *high = bstPopMax( bst );
+    assertTrue( *low < *high, "The minimum should be below the maximum!\n" );
+
+    while( bst->size > 0 ) {
+        bool fromLow = bst->size % 2 == 0;
+        int *next = fromLow ? bstPopMin( bst ) : bstPopMax( bst );
+
+        assertTrue( fromLow ? *next > *low : *next < *high, "Popped %d out of order!\n", *next );
+        assertTrue( *next > *low && *next < *high, "Popped %d outside the range!\n", *next );
+
+        if( fromLow ) {
+            free( low );
+            low = next;
+        } else {
+            free( high );
+            high = next;
+        }
+
+        checkExtremes( bst );
+    }
+
+    free( low );
+    free( high );
+    assertNull( bstMin( bst ), "The emptied tree has no minimum!\n" );
+    bstFree( bst );
+
+    // Splaying and rebalancing move nodes without invalidating the extremes
+    BST *splay = newSplayTree( comparisonFunction );
+    for( int i = 0; i < 200; i++ ) {
+        bstInsert( splay, mallocInt( (i * 37) % 200 ) );
+    }
+
+    int *probe = mallocInt( 100 );
+    bstFind( splay, probe );
+    bstRebalance( splay );
+    checkExtremes( splay );
+
+    for( int i = 0; i < 200; i++ ) {
+        int *element = bstPopMin( splay );
+        assertTrue( *element == i, "Expected to pop %d, popped %d!\n", i, *element );
+        assertTrue( parentsAreValid( splay->root ), "Parent pointers are invalid!\n" );
+        free( element );
+    }
+
+    bstFree( splay );
+
+    // Split and joined trees find their extremes again
+    BST *less;
+    BST *greater;
+    *probe = 50;
+    void *middle = bstSplit( rangeTree( 0, 100, 1 ), probe, &less, &greater );
+    assertTrue( *(int *) bstMax( less ) == 49, "The lesser half should end at 49!\n" );
+    assertTrue( *(int *) bstMin( greater ) == 51, "The greater half should start at 51!\n" );
+
+    BST *joined = bstJoin( less, middle, greater );
+    checkExtremes( joined );
+    int *last = bstPopMax( joined );
+    assertTrue( *last == 99, "The joined tree should end at 99!\n" );
+
+    free( last );
+    free( probe );
+    bstFree( joined );
+}
+
+void testInsertHint() {
+    BST *bst = newBST( countingComparison );
+    const int numElements = 10000;
+    BSTNode *hint = NULL;
+
+    // Appending with the previous node as the hint never searches from the root
+    comparisons = 0;
+    for( int i = 0; i < numElements; i += 2 ) {
+        hint = bstInsertHint( bst, hint, mallocInt( i ) );
+        assertTrue( *(int *) hint->data == i, "The returned node should hold %d!\n", i );
+    }
+
+    assertTrue( bst->size == numElements / 2, "BST size should be %d, was %d!\n", numElements / 2,
+            bst->size );
+    assertTrue( comparisons <= numElements / 2, "Appending made %ld comparisons!\n", comparisons );
+    assertTrue( bstHeight( bst ) < 100,
+            "Appending should keep the treap balanced, height was %d!\n", bstHeight( bst ) );
+
+    // A NULL hint appends as well
+    comparisons = 0;
+    BSTNode *last = bstInsertHint( bst, NULL, mallocInt( numElements ) );
+    assertTrue( last == bst->maxNode && comparisons == 1, "A NULL hint should append in O(1)!\n" );
+
+    // Every odd number goes straight after the even number below it
+    bstRebalance( bst );
+    BSTNode *nodes[ numElements / 2 ];
+    int numNodes = 0;
+    for( BSTNode *node = bst->minNode; node != last; node = successor( node ) ) {
+        nodes[ numNodes++ ] = node;
+    }
+
+    for( int i = 0; i < numNodes; i++ ) {
+        int value = *(int *) nodes[i]->data + 1;
+        BSTNode *inserted = bstInsertHint( bst, nodes[i], mallocInt( value ) );
+        assertTrue( successor( nodes[i] ) == inserted, "%d should follow its hint!\n", value );
+    }
+
+    // Equivalent elements aren't inserted, whatever the hint
+    int *duplicate = mallocInt( 1 );
+    assertTrue( *(int *) bstInsertHint( bst, last, duplicate )->data == 1,
+            "The existing node should be returned!\n" );
+    free( duplicate );
+
+    // Descending keys go before their hint, and wrong hints fall back to a search from the root
+    BST *descending = newBST( comparisonFunction );
+    hint = NULL;
+    for( int i = 1; i <= numElements; i++ ) {
+        hint = bstInsertHint( descending, i % 3 == 0 ? descending->root : hint, mallocInt( -i ) );
+    }
+
+    BST *trees[] = { bst, descending };
+    for( int t = 0; t < 2; t++ ) {
+        void **elements = bstElements( trees[t] );
+        for( int i = 1; i < trees[t]->size; i++ ) {
+            assertTrue( *(int *) elements[i - 1] + 1 == *(int *) elements[i],
+                    "The elements should be consecutive integers!\n" );
+        }
+
+        assertTrue( trees[t]->size == numElements + 1 - t, "Tree %d has the wrong size!\n", t );
+        assertTrue( parentsAreValid( trees[t]->root ), "Parent pointers are invalid!\n" );
+        checkExtremes( trees[t] );
+        free( elements );
+    }
+
+    bstFree( descending );
+    bstFree( bst );
+}
+
+void testTreapMaintenance() {
+    BST *bst = newBST( comparisonFunction );
+    const int numElements = 100000;
+    BSTNode *nodes[ 10 ];
+
+    // Sorted inserts would build a vine, but rotating by priority keeps the tree a treap
+    for( int i = 0; i < numElements; i++ ) {
+        BSTNode *node = bstInsertHint( bst, NULL, mallocInt( i ) );
+        if( i % (numElements / 10) == 1 ) {
+            nodes[ i / (numElements / 10) ] = node;
+        }
+    }
+
+    assertTrue( bst->treap, "Inserting should keep the tree a treap!\n" );
+    assertTrue( bstHeight( bst ) < 100, "Sorted inserts should be balanced, height was %d!\n",
+            bstHeight( bst ) );
+
+    // Removed nodes are rotated down, so the remaining elements stay in their nodes
+    for( int i = 0; i < numElements; i += 2 ) {
+        int *element = mallocInt( i );
+        free( bstRemove( bst, element ) );
+        free( element );
+    }
+
+    assertTrue( bst->treap, "Removing should keep the tree a treap!\n" );
+    assertTrue( bst->size == numElements / 2, "BST size should be %d, was %d!\n", numElements / 2,
+            bst->size );
+    assertTrue( bstHeight( bst ) < 100, "Removals should keep the tree balanced, height was %d!\n",
+            bstHeight( bst ) );
+    assertTrue( parentsAreValid( bst->root ), "Parent pointers are invalid!\n" );
+    checkExtremes( bst );
+
+    for( int i = 0; i < 10; i++ ) {
+        int expected = i * (numElements / 10) + 1;
+        assertTrue( *(int *) nodes[i]->data == expected, "Node %d should still hold %d!\n", i,
+                expected );
+    }
+
+    // The join-based operations take treaps as they are
+    BST *evens = newBST( comparisonFunction );
+    for( int i = 0; i < numElements; i += 2 ) {
+        bstInsert( evens, mallocInt( i ) );
+    }
+
+    BST *unionResult = bstUnion( bst, evens, NULL );
+    void **elements = bstElements( unionResult );
+    assertTrue( unionResult->size == numElements, "Union size should be %d, was %d!\n",
+            numElements, unionResult->size );
+    for( int i = 0; i < numElements; i++ ) {
+        if( *(int *) elements[i] != i ) {
+            assertTrue( 0, "Union element %d was %d!\n", i, *(int *) elements[i] );
+            break;
+        }
+    }
+
+    free( elements );
+    bstFree( unionResult );
+}
+
 void printNode( BSTNode *node ) {
     debug( E_DEBUG, "%d ", *(int *)(node->data) );
 }
@@ -188,3 +908,83 @@ int comparisonFunction( void *aPtr, void *bPtr) {
         return 1;
     }
 }
+
+int countingComparison( void *aPtr, void *bPtr ) {
+    comparisons++;
+    return comparisonFunction( aPtr, bPtr );
+}
+
+BST *rangeTree( int start, int end, int step ) {
+    BST *bst = newBST( comparisonFunction );
+
+    // Insert in a shuffled order so that the tree isn't a list
+    for( int offset = 0; offset < 7; offset++ ) {
+        for( int i = start + offset * step; i < end; i += 7 * step ) {
+            bstInsert( bst, mallocInt( i ) );
+        }
+    }
+
+    return bst;
+}
+
+int parentsAreValid( BSTNode *node ) {
+    if( node == NULL ) {
+        return 1;
+    }
+
+    if( node->left && node->left->parent != node ) {
+        return 0;
+    } else if( node->right && node->right->parent != node ) {
+        return 0;
+    }
+
+    return parentsAreValid( node->left ) && parentsAreValid( node->right );
+}
+
+/*
+ * Checks that the tree's minimum and maximum match the ends of an in-order walk.
+ */
+void checkExtremes( BST *bst ) {
+    if( bstSize( bst ) == 0 ) {
+        assertTrue( bstMin( bst ) == NULL && bstMax( bst ) == NULL,
+                "An empty tree has no minimum or maximum!\n" );
+        return;
+    }
+
+    void **elements = bstElements( bst );
+
+    assertTrue( bstMin( bst ) == elements[0], "The minimum should be the first element!\n" );
+    assertTrue( bstMax( bst ) == elements[ bst->size - 1 ],
+            "The maximum should be the last element!\n" );
+
+    free( elements );
+}
+
+void recordNode( BSTNode *node ) {
+    visits[ numVisits++ ] = *(int *) node->data;
+}
+
+/*
+ * Builds a tree where every node is the right child of the one before it, as ascending inserts
+ * would, without paying the quadratic cost of inserting that way.
+ */
+BST *rightVine( int numElements ) {
+    BST *bst = newSplayTree( comparisonFunction );
+
+    // Each new minimum is splayed to the root with the previous tree as its right child
+    for( int i = numElements - 1; i >= 0; i-- ) {
+        bstInsert( bst, mallocInt( i ) );
+    }
+
+    // Later operations shouldn't splay the vine away
+    bst->splay = false;
+    return bst;
+}
+
+BST *plainTree() {
+    BST *bst = newBST( comparisonFunction );
+
+    // Without the treap rotations, the shape of the tree follows the order of the inserts
+    bst->treap = false;
+    return bst;
+}
@@ -0,0 +1,233 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "utils.h"
+#include "btree.h"
+
+/* Test function prototypes */
+void testTreeCreation();
+void testTreeInsertion();
+void testTreeFind();
+void testTreeRemoval();
+void testIteration();
+
+/* Functions used in testing */
+int comparisonFunction( void *aPtr, void *bPtr );
+int *mallocInt( int a );
+int checkNode( BTreeNode *node, int depth, int *leafDepth, int isRoot );
+
+int main( int argc, char *argv[] ) {
+    setDebuggingLevel( E_ERROR );
+    srand( time(NULL) );
+
+    testTreeCreation();
+    testTreeInsertion();
+    testTreeFind();
+    testTreeRemoval();
+    testIteration();
+
+    return 0;
+}
+
+void testTreeCreation() {
+    BTree *btree = newBTree( comparisonFunction );
+
+    assertNotNull( btree, "The new B-tree shouldn't be null!\n" );
+    assertTrue( btree->size == 0, "The new B-tree should be empty!\n" );
+    assertNull( newBTree( NULL ), "A B-tree needs a comparison function!\n" );
+
+    // Nodes fill whole cache lines and start on a line boundary
+    assertTrue( sizeof(BTreeNode) == 4 * CACHE_LINE_SIZE,
+            "Nodes should be 4 cache lines, were %d bytes!\n", (int) sizeof(BTreeNode) );
+    assertTrue( (unsigned long) btree->root % CACHE_LINE_SIZE == 0,
+            "Nodes should be aligned to cache lines!\n" );
+
+    btreeFree( btree );
+}
+
+void testTreeInsertion() {
+    BTree *btree = newBTree( comparisonFunction );
+    const int numElements = 5000;
+    int leafDepth = -1;
+
+    for( int i = 0; i < numElements; i++ ) {
+        assertTrue( btreeInsert( btree, mallocInt( i ) ), "%d should have been inserted!\n", i );
+    }
+
+    assertTrue( btree->size == numElements, "B-tree size should be %d, was %d!\n", numElements,
+            btree->size );
+    assertTrue( checkNode( btree->root, 0, &leafDepth, 1 ), "The B-tree is malformed!\n" );
+
+    // Duplicates are rejected
+    int *duplicate = mallocInt( numElements / 2 );
+    assertFalse( btreeInsert( btree, duplicate ), "Duplicates shouldn't be inserted!\n" );
+    assertTrue( btree->size == numElements, "B-tree size should be %d, was %d!\n", numElements,
+            btree->size );
+    free( duplicate );
+
+    btreeFree( btree );
+}
+
+void testTreeFind() {
+    BTree *btree = newBTree( comparisonFunction );
+    const int numElements = 5000;
+
+    // Insert even numbers in a random order
+    for( int i = 0; i < numElements; i++ ) {
+        int *element = mallocInt( 2 * (rand() % numElements) );
+
+        if( ! btreeInsert( btree, element ) ) {
+            free( element );
+        }
+    }
+
+    for( int i = 0; i < numElements; i++ ) {
+        int *element = mallocInt( 2 * i );
+
+        if( btreeFind( btree, element ) ) {
+            assertTrue( *(int *) btreeFind( btree, element ) == 2 * i, "Found the wrong element!\n" );
+        }
+
+        *element = 2 * i + 1;
+        assertNull( btreeFind( btree, element ), "Found %d, which was never inserted!\n", *element );
+        free( element );
+    }
+
+    btreeFree( btree );
+}
+
+void testTreeRemoval() {
+    BTree *btree = newBTree( comparisonFunction );
+    const int numElements = 5000;
+    int *order = malloc( sizeof(int) * numElements );
+
+    for( int i = 0; i < numElements; i++ ) {
+        btreeInsert( btree, mallocInt( i ) );
+        order[i] = i;
+    }
+
+    // Remove the elements in a random order, checking the tree's shape as it shrinks
+    for( int i = numElements - 1; i > 0; i-- ) {
+        int j = rand() % (i + 1);
+        int swap = order[i];
+        order[i] = order[j];
+        order[j] = swap;
+    }
+
+    for( int i = 0; i < numElements; i++ ) {
+        int *element = mallocInt( order[i] );
+        int *removed = btreeRemove( btree, element );
+
+        assertTrue( removed != NULL && *removed == order[i], "Could not remove %d!\n", order[i] );
+        assertNull( btreeFind( btree, element ), "Could still find %d after removal!\n", order[i] );
+        assertNull( btreeRemove( btree, element ), "Removed %d twice!\n", order[i] );
+
+        if( i % 500 == 0 ) {
+            int leafDepth = -1;
+            assertTrue( checkNode( btree->root, 0, &leafDepth, 1 ),
+                    "The B-tree is malformed after %d removals!\n", i + 1 );
+        }
+
+        free( element );
+        free( removed );
+    }
+
+    assertTrue( btree->size == 0, "B-tree size should be 0, was %d!\n", btree->size );
+
+    free( order );
+    btreeFree( btree );
+}
+
+void testIteration() {
+    BTree *btree = newBTree( comparisonFunction );
+    const int numElements = 3000;
+
+    for( int i = numElements - 1; i >= 0; i-- ) {
+        btreeInsert( btree, mallocInt( i ) );
+    }
+
+    BTreeIterator iterator;
+    int *element;
+    int count = 0;
+
+    btreeIteratorInit( &iterator, btree );
+    while( (element = btreeIteratorNext( &iterator )) != NULL ) {
+        assertTrue( *element == count, "Iterator returned %d, expected %d!\n", *element, count );
+        count++;
+    }
+
+    assertTrue( count == numElements, "Iterator returned %d elements, expected %d!\n", count,
+            numElements );
+
+    void **elements = btreeElements( btree );
+    for( int i = 0; i < numElements; i++ ) {
+        assertTrue( *(int *) elements[i] == i, "Element %d is out of order!\n", i );
+    }
+
+    free( elements );
+    btreeFree( btree );
+}
+
+/* Functions for use in testing */
+int comparisonFunction( void *aPtr, void *bPtr ) {
+    int a = *((int *) aPtr);
+    int b = *((int *) bPtr);
+
+    if( a < b ) {
+        return -1;
+    } else if( a == b ) {
+        return 0;
+    } else {
+        return 1;
+    }
+}
+
+int *mallocInt( int a ) {
+    int *newInt = (int *) malloc( sizeof(int) );
+    *newInt = a;
+
+    return newInt;
+}
+
+/*
+ * Checks that a node's keys are sorted and within the allowed counts, and that every leaf is at the
+ * same depth.
+ */
+int checkNode( BTreeNode *node, int depth, int *leafDepth, int isRoot ) {
+    if( ! isRoot && (node->numKeys < BTREE_MIN_DEGREE - 1 || node->numKeys > BTREE_MAX_KEYS) ) {
+        return 0;
+    }
+
+    for( int i = 1; i < node->numKeys; i++ ) {
+        if( comparisonFunction( node->keys[i - 1], node->keys[i] ) >= 0 ) {
+            return 0;
+        }
+    }
+
+    if( node->leaf ) {
+        if( *leafDepth < 0 ) {
+            *leafDepth = depth;
+        }
+
+        return *leafDepth == depth;
+    }
+
+    for( int i = 0; i <= node->numKeys; i++ ) {
+        BTreeNode *child = node->children[i];
+
+        // Every key in a child must lie between the keys that surround it in the parent
+        if( i > 0 && comparisonFunction( child->keys[0], node->keys[i - 1] ) <= 0 ) {
+            return 0;
+        } else if( i < node->numKeys
+                && comparisonFunction( child->keys[ child->numKeys - 1 ], node->keys[i] ) >= 0 ) {
+            return 0;
+        }
+
+        if( ! checkNode( child, depth + 1, leafDepth, 0 ) ) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
@@ -0,0 +1,284 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "utils.h"
+#include "compactbst.h"
+
+/* Test function prototypes */
+void testTreeCreation();
+void testTreeInsertion();
+void testTreeFind();
+void testTreeRemoval();
+void testNodeReuse();
+void testRelocation();
+void testDegenerateTree();
+
+/* Functions used in testing */
+int comparisonFunction( void *aPtr, void *bPtr );
+int *mallocInt( int a );
+void shuffle( int *values, int numValues );
+CompactBST *compactVine( int numElements );
+
+int main( int argc, char *argv[] ) {
+    setDebuggingLevel( E_ERROR );
+    srand( time(NULL) );
+
+    testTreeCreation();
+    testTreeInsertion();
+    testTreeFind();
+    testTreeRemoval();
+    testNodeReuse();
+    testRelocation();
+    testDegenerateTree();
+
+    return 0;
+}
+
+void testTreeCreation() {
+    CompactBST *bst = newCompactBST( comparisonFunction, 0 );
+
+    assertNotNull( bst, "The new compact tree shouldn't be null!\n" );
+    assertTrue( bst->size == 0, "The new compact tree should be empty!\n" );
+    assertTrue( bst->root == COMPACT_NULL, "The new compact tree should have no root!\n" );
+    assertTrue( sizeof(CompactNode) == 16, "Compact nodes should be 16 bytes, were %d!\n",
+            (int) sizeof(CompactNode) );
+    assertNull( newCompactBST( NULL, 0 ), "A compact tree needs a comparison function!\n" );
+
+    compactBSTFree( bst );
+}
+
+void testTreeInsertion() {
+    CompactBST *bst = newCompactBST( comparisonFunction, 1 );
+    const int numElements = 5000;
+    int *order = malloc( sizeof(int) * numElements );
+
+    for( int i = 0; i < numElements; i++ ) {
+        order[i] = i;
+    }
+
+    // Starting from a capacity of one forces the node array to grow many times
+    shuffle( order, numElements );
+    for( int i = 0; i < numElements; i++ ) {
+        assertTrue( compactBSTInsert( bst, mallocInt( order[i] ) ), "%d should be inserted!\n",
+                order[i] );
+    }
+
+    assertTrue( bst->size == numElements, "Compact tree size should be %d, was %d!\n",
+            numElements, bst->size );
+
+    int *duplicate = mallocInt( numElements / 2 );
+    assertFalse( compactBSTInsert( bst, duplicate ), "Duplicates shouldn't be inserted!\n" );
+    assertFalse( compactBSTInsert( bst, NULL ), "NULL shouldn't be inserted!\n" );
+    free( duplicate );
+
+    void **elements = compactBSTElements( bst );
+    for( int i = 0; i < numElements; i++ ) {
+        assertTrue( *(int *) elements[i] == i, "Element %d is out of order!\n", i );
+    }
+
+    free( elements );
+    free( order );
+    compactBSTFree( bst );
+}
+
+void testTreeFind() {
+    CompactBST *bst = newCompactBST( comparisonFunction, 0 );
+    const int numElements = 5000;
+
+    // Insert even numbers in a random order
+    for( int i = 0; i < numElements; i++ ) {
+        int *element = mallocInt( 2 * (rand() % numElements) );
+
+        if( ! compactBSTInsert( bst, element ) ) {
+            free( element );
+        }
+    }
+
+    for( int i = 0; i < numElements; i++ ) {
+        int *element = mallocInt( 2 * i );
+        int *found = compactBSTFind( bst, element );
+
+        if( found ) {
+            assertTrue( *found == 2 * i, "Found the wrong element!\n" );
+        }
+
+        *element = 2 * i + 1;
+        assertNull( compactBSTFind( bst, element ), "Found %d, which was never inserted!\n",
+                *element );
+        free( element );
+    }
+
+    compactBSTFree( bst );
+}
+
+void testTreeRemoval() {
+    CompactBST *bst = newCompactBST( comparisonFunction, 0 );
+    const int numElements = 5000;
+    int *order = malloc( sizeof(int) * numElements );
+
+    for( int i = 0; i < numElements; i++ ) {
+        order[i] = i;
+    }
+
+    shuffle( order, numElements );
+    for( int i = 0; i < numElements; i++ ) {
+        compactBSTInsert( bst, mallocInt( order[i] ) );
+    }
+
+    // Remove the elements in a different random order, checking the ordering as the tree shrinks
+    shuffle( order, numElements );
+    for( int i = 0; i < numElements; i++ ) {
+        int *element = mallocInt( order[i] );
+        int *removed = compactBSTRemove( bst, element );
+
+        assertTrue( removed != NULL && *removed == order[i], "Could not remove %d!\n", order[i] );
+        assertNull( compactBSTFind( bst, element ), "Could still find %d after removal!\n",
+                order[i] );
+        assertNull( compactBSTRemove( bst, element ), "Removed %d twice!\n", order[i] );
+
+        if( i % 500 == 0 ) {
+            void **elements = compactBSTElements( bst );
+            for( int j = 1; j < bst->size; j++ ) {
+                assertTrue( comparisonFunction( elements[j - 1], elements[j] ) < 0,
+                        "The tree is out of order after %d removals!\n", i + 1 );
+            }
+
+            free( elements );
+        }
+
+        free( element );
+        free( removed );
+    }
+
+    assertTrue( bst->size == 0, "Compact tree size should be 0, was %d!\n", bst->size );
+    assertTrue( bst->root == COMPACT_NULL, "An empty compact tree should have no root!\n" );
+
+    free( order );
+    compactBSTFree( bst );
+}
+
+void testNodeReuse() {
+    CompactBST *bst = newCompactBST( comparisonFunction, 0 );
+    const int numElements = 1000;
+
+    for( int i = 0; i < numElements; i++ ) {
+        compactBSTInsert( bst, mallocInt( i ) );
+    }
+
+    uint32_t used = bst->used;
+
+    // Every removed node goes on the free list and is handed out again before the array grows
+    for( int round = 0; round < 3; round++ ) {
+        for( int i = 0; i < numElements; i += 2 ) {
+            int *element = mallocInt( i );
+            free( compactBSTRemove( bst, element ) );
+            free( element );
+        }
+
+        for( int i = 0; i < numElements; i += 2 ) {
+            compactBSTInsert( bst, mallocInt( i ) );
+        }
+    }
+
+    assertTrue( bst->used == used, "Freed nodes should be reused, used %u slots instead of %u!\n",
+            bst->used, used );
+    assertTrue( bst->size == numElements, "Compact tree size should be %d, was %d!\n",
+            numElements, bst->size );
+
+    compactBSTFree( bst );
+}
+
+void testRelocation() {
+    CompactBST *bst = newCompactBST( comparisonFunction, 0 );
+    const int numElements = 1000;
+
+    for( int i = 0; i < numElements; i++ ) {
+        compactBSTInsert( bst, mallocInt( (i * 7919) % numElements ) );
+    }
+
+    // A byte-for-byte copy of the node array is a working tree, since links are indices
+    CompactBST copy = *bst;
+    copy.nodes = malloc( sizeof(CompactNode) * bst->capacity );
+    memcpy( copy.nodes, bst->nodes, sizeof(CompactNode) * bst->used );
+
+    for( int i = 0; i < numElements; i++ ) {
+        int *element = mallocInt( i );
+        assertTrue( compactBSTFind( &copy, element ) == compactBSTFind( bst, element ),
+                "The copied tree should find %d!\n", i );
+        free( element );
+    }
+
+    free( copy.nodes );
+    compactBSTFree( bst );
+}
+
+void testDegenerateTree() {
+    // Deep enough that recursing once per level would overflow the stack
+    const int numElements = 1000000;
+    CompactBST *bst = compactVine( numElements );
+
+    // Inserting past the maximum walks the whole vine and hangs the new node from its bottom
+    assertTrue( compactBSTInsert( bst, mallocInt( numElements ) ),
+            "%d should be inserted at the bottom of the vine!\n", numElements );
+
+    void **elements = compactBSTElements( bst );
+    for( int i = 0; i <= numElements; i++ ) {
+        if( *(int *) elements[i] != i ) {
+            assertTrue( 0, "Element %d was %d!\n", i, *(int *) elements[i] );
+            break;
+        }
+    }
+
+    free( elements );
+    compactBSTFree( bst );
+}
+
+/* Functions for use in testing */
+int comparisonFunction( void *aPtr, void *bPtr ) {
+    int a = *((int *) aPtr);
+    int b = *((int *) bPtr);
+
+    if( a < b ) {
+        return -1;
+    } else if( a == b ) {
+        return 0;
+    } else {
+        return 1;
+    }
+}
+
+int *mallocInt( int a ) {
+    int *newInt = (int *) malloc( sizeof(int) );
+    *newInt = a;
+
+    return newInt;
+}
+
+void shuffle( int *values, int numValues ) {
+    for( int i = numValues - 1; i > 0; i-- ) {
+        int j = rand() % (i + 1);
+        int swap = values[i];
+        values[i] = values[j];
+        values[j] = swap;
+    }
+}
+
+CompactBST *compactVine( int numElements ) {
+    CompactBST *bst = newCompactBST( comparisonFunction, numElements );
+
+    // Inserting this many elements in sorted order would take quadratic time, so the nodes are
+    // linked into the same right vine directly
+    for( int i = 1; i <= numElements; i++ ) {
+        bst->nodes[i].data = mallocInt( i - 1 );
+        bst->nodes[i].left = COMPACT_NULL;
+        bst->nodes[i].right = i < numElements ? (uint32_t) i + 1 : COMPACT_NULL;
+    }
+
+    bst->root = numElements > 0 ? 1 : COMPACT_NULL;
+    bst->used = (uint32_t) numElements + 1;
+    bst->size = numElements;
+
+    return bst;
+}
@@ -0,0 +1,270 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "utils.h"
+#include "concurrenthashset.h"
+
+/* The number of threads updating the set in the concurrent tests */
+#define NUM_THREADS 4
+
+/* Test function prototypes */
+void testSetCreation();
+void testSetAdd();
+void testSetRemove();
+void testSetGrowth();
+void testConcurrentAdds();
+void testConcurrentMixed();
+
+/* Functions used in testing */
+int comparisonFunction( void *aPtr, void *bPtr );
+unsigned long hashFunction( void *element );
+int *mallocInt( int a );
+int countEntries( ConcurrentHashSet *set );
+void *addRange( void *argument );
+void *churnRange( void *argument );
+
+/* The set shared by the threads in the concurrent tests */
+ConcurrentHashSet *sharedSet = NULL;
+
+/* The number of elements each thread works on in the concurrent tests */
+const int elementsPerThread = 20000;
+
+int main( int argc, char *argv[] ) {
+    setDebuggingLevel( E_ERROR );
+    srand( time(NULL) );
+
+    testSetCreation();
+    testSetAdd();
+    testSetRemove();
+    testSetGrowth();
+    testConcurrentAdds();
+    testConcurrentMixed();
+
+    return 0;
+}
+
+void testSetCreation() {
+    ConcurrentHashSet *set = newConcurrentHashSet( comparisonFunction, hashFunction );
+
+    assertNotNull( set, "The new concurrent hash set shouldn't be null!\n" );
+    assertTrue( concurrentHashSetSize( set ) == 0, "The new set should be empty!\n" );
+    assertTrue( set->table->numBuckets == HASH_SET_INITIAL_BUCKETS,
+            "The new set should have %d buckets!\n", HASH_SET_INITIAL_BUCKETS );
+    assertNull( newConcurrentHashSet( NULL, hashFunction ),
+            "A set needs a comparison function!\n" );
+    assertNull( newConcurrentHashSet( comparisonFunction, NULL ),
+            "A set needs a hash function!\n" );
+
+    concurrentHashSetFree( set );
+}
+
+void testSetAdd() {
+    ConcurrentHashSet *set = newConcurrentHashSet( comparisonFunction, hashFunction );
+    const int numElements = 100;
+
+    for( int i = 0; i < numElements; i++ ) {
+        assertTrue( concurrentHashSetAdd( set, mallocInt( i ) ), "%d should be added!\n", i );
+    }
+
+    int *duplicate = mallocInt( 10 );
+    assertFalse( concurrentHashSetAdd( set, duplicate ), "Duplicates shouldn't be added!\n" );
+    assertFalse( concurrentHashSetAdd( set, NULL ), "NULL shouldn't be added!\n" );
+    free( duplicate );
+
+    assertTrue( concurrentHashSetSize( set ) == numElements, "Set size should be %d, was %d!\n",
+            numElements, concurrentHashSetSize( set ) );
+
+    for( int i = 0; i < 2 * numElements; i++ ) {
+        int *element = mallocInt( i );
+        assertTrue( concurrentHashSetContains( set, element ) == (i < numElements),
+                "%d has the wrong membership!\n", i );
+        free( element );
+    }
+
+    concurrentHashSetFree( set );
+}
+
+void testSetRemove() {
+    ConcurrentHashSet *set = newConcurrentHashSet( comparisonFunction, hashFunction );
+    const int numElements = 1000;
+
+    for( int i = 0; i < numElements; i++ ) {
+        concurrentHashSetAdd( set, mallocInt( i ) );
+    }
+
+    for( int i = 0; i < numElements; i += 2 ) {
+        int *element = mallocInt( i );
+
+        assertTrue( concurrentHashSetRemove( set, element ), "Could not remove %d!\n", i );
+        assertFalse( concurrentHashSetContains( set, element ), "Found %d after removal!\n", i );
+        assertFalse( concurrentHashSetRemove( set, element ), "Removed %d twice!\n", i );
+
+        free( element );
+    }
+
+    assertTrue( concurrentHashSetSize( set ) == numElements / 2, "Set size should be %d, was %d!\n",
+            numElements / 2, concurrentHashSetSize( set ) );
+
+    concurrentHashSetFree( set );
+}
+
+void testSetGrowth() {
+    ConcurrentHashSet *set = newConcurrentHashSet( comparisonFunction, hashFunction );
+    const int numElements = 100000;
+
+    for( int i = 0; i < numElements; i++ ) {
+        concurrentHashSetAdd( set, mallocInt( i ) );
+
+        // While a resize is under way, every element must be in exactly one of the two tables
+        if( i % 997 == 0 ) {
+            assertTrue( countEntries( set ) == i + 1, "The tables should hold %d entries!\n",
+                    i + 1 );
+        }
+    }
+
+    long capacity = set->table->numBuckets * HASH_SET_MAX_LOAD;
+    assertTrue( capacity >= numElements / 2, "The table should have grown, but has %ld buckets!\n",
+            set->table->numBuckets );
+
+    for( int i = 0; i < numElements; i++ ) {
+        int *element = mallocInt( i );
+        assertTrue( concurrentHashSetContains( set, element ), "%d should be in the set!\n", i );
+        free( element );
+    }
+
+    concurrentHashSetFree( set );
+}
+
+void testConcurrentAdds() {
+    pthread_t threads[ NUM_THREADS ];
+    int offsets[ NUM_THREADS ];
+    sharedSet = newConcurrentHashSet( comparisonFunction, hashFunction );
+
+    for( int i = 0; i < NUM_THREADS; i++ ) {
+        offsets[i] = i * elementsPerThread;
+        pthread_create( &threads[i], NULL, addRange, &offsets[i] );
+    }
+
+    for( int i = 0; i < NUM_THREADS; i++ ) {
+        pthread_join( threads[i], NULL );
+    }
+
+    int expected = NUM_THREADS * elementsPerThread;
+    assertTrue( concurrentHashSetSize( sharedSet ) == expected, "Set size should be %d, was %d!\n",
+            expected, concurrentHashSetSize( sharedSet ) );
+    assertTrue( countEntries( sharedSet ) == expected, "The tables should hold %d entries!\n",
+            expected );
+
+    for( int i = 0; i < expected; i++ ) {
+        int *element = mallocInt( i );
+        assertTrue( concurrentHashSetContains( sharedSet, element ), "%d should be found!\n", i );
+        free( element );
+    }
+
+    concurrentHashSetFree( sharedSet );
+}
+
+void testConcurrentMixed() {
+    pthread_t threads[ NUM_THREADS ];
+    int offsets[ NUM_THREADS ];
+    sharedSet = newConcurrentHashSet( comparisonFunction, hashFunction );
+
+    for( int i = 0; i < NUM_THREADS; i++ ) {
+        offsets[i] = i * elementsPerThread;
+        pthread_create( &threads[i], NULL, churnRange, &offsets[i] );
+    }
+
+    for( int i = 0; i < NUM_THREADS; i++ ) {
+        pthread_join( threads[i], NULL );
+    }
+
+    // Every thread removed the odd elements it added
+    int expected = NUM_THREADS * elementsPerThread / 2;
+    assertTrue( concurrentHashSetSize( sharedSet ) == expected, "Set size should be %d, was %d!\n",
+            expected, concurrentHashSetSize( sharedSet ) );
+
+    for( int i = 0; i < NUM_THREADS * elementsPerThread; i++ ) {
+        int *element = mallocInt( i );
+        assertTrue( concurrentHashSetContains( sharedSet, element ) == (i % 2 == 0),
+                "%d has the wrong membership!\n", i );
+        free( element );
+    }
+
+    concurrentHashSetFree( sharedSet );
+}
+
+/* Functions for use in testing */
+void *addRange( void *argument ) {
+    int offset = *(int *) argument;
+
+    for( int i = offset; i < offset + elementsPerThread; i++ ) {
+        assertTrue( concurrentHashSetAdd( sharedSet, mallocInt( i ) ), "%d should be added!\n", i );
+    }
+
+    return NULL;
+}
+
+void *churnRange( void *argument ) {
+    int offset = *(int *) argument;
+
+    // Removals and lookups run while the other threads' adds are resizing the table
+    for( int i = offset; i < offset + elementsPerThread; i++ ) {
+        concurrentHashSetAdd( sharedSet, mallocInt( i ) );
+
+        if( i % 2 == 1 ) {
+            int *element = mallocInt( i );
+
+            assertTrue( concurrentHashSetRemove( sharedSet, element ), "Could not remove %d!\n",
+                    i );
+            assertFalse( concurrentHashSetContains( sharedSet, element ),
+                    "Found %d after removal!\n", i );
+            free( element );
+        }
+    }
+
+    return NULL;
+}
+
+int comparisonFunction( void *aPtr, void *bPtr ) {
+    int a = *((int *) aPtr);
+    int b = *((int *) bPtr);
+
+    if( a < b ) {
+        return -1;
+    } else if( a == b ) {
+        return 0;
+    } else {
+        return 1;
+    }
+}
+
+unsigned long hashFunction( void *element ) {
+    return (unsigned long) *(int *) element;
+}
+
+int *mallocInt( int a ) {
+    int *newInt = (int *) malloc( sizeof(int) );
+    *newInt = a;
+
+    return newInt;
+}
+
+/*
+ * Counts the entries in both of the set's tables. No other thread may be using the set.
+ */
+int countEntries( ConcurrentHashSet *set ) {
+    HashTable *tables[] = { set->table, set->next };
+    int count = 0;
+
+    for( int t = 0; t < 2 && tables[t] != NULL; t++ ) {
+        for( long i = 0; i < tables[t]->numBuckets; i++ ) {
+            for( HashEntry *entry = tables[t]->buckets[i]; entry != NULL; entry = entry->next ) {
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
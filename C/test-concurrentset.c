@@ -0,0 +1,237 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "utils.h"
+#include "concurrentset.h"
+
+/* The number of threads searching the set in testConcurrentReaders */
+#define NUM_READERS 4
+
+/* The number of threads updating the set in testConcurrentWriters */
+#define NUM_WRITERS 4
+
+/* Test function prototypes */
+void testSetCreation();
+void testSetAdd();
+void testSetRemove();
+void testConcurrentReaders();
+void testConcurrentWriters();
+
+/* Functions used in testing */
+int comparisonFunction( void *aPtr, void *bPtr );
+int *mallocInt( int a );
+void *readSet( void *argument );
+void *writeSet( void *argument );
+
+/* The set shared by the threads in the concurrent tests */
+ConcurrentSet *sharedSet = NULL;
+int writerDone = 0;
+
+/* Elements below this are never removed in testConcurrentReaders, and those above never added */
+const int numStable = 1000;
+
+/* The number of elements each thread adds in testConcurrentWriters */
+const int elementsPerWriter = 5000;
+
+int main( int argc, char *argv[] ) {
+    setDebuggingLevel( E_ERROR );
+    srand( time(NULL) );
+
+    testSetCreation();
+    testSetAdd();
+    testSetRemove();
+    testConcurrentReaders();
+    testConcurrentWriters();
+
+    return 0;
+}
+
+void testSetCreation() {
+    ConcurrentSet *set = newConcurrentSet( comparisonFunction );
+
+    assertNotNull( set, "The new concurrent set shouldn't be null!\n" );
+    assertTrue( concurrentSetSize( set ) == 0, "The new concurrent set should be empty!\n" );
+    assertNull( newConcurrentSet( NULL ), "A concurrent set needs a comparison function!\n" );
+
+    concurrentSetFree( set );
+}
+
+void testSetAdd() {
+    ConcurrentSet *set = newConcurrentSet( comparisonFunction );
+    const int numElements = 1000;
+
+    for( int i = 0; i < numElements; i++ ) {
+        assertTrue( concurrentSetAdd( set, mallocInt( i ) ), "%d should be added!\n", i );
+    }
+
+    int *duplicate = mallocInt( 10 );
+    assertFalse( concurrentSetAdd( set, duplicate ), "Duplicates shouldn't be added!\n" );
+    assertFalse( concurrentSetAdd( set, NULL ), "NULL shouldn't be added!\n" );
+    free( duplicate );
+
+    assertTrue( concurrentSetSize( set ) == numElements, "Set size should be %d, was %d!\n",
+            numElements, concurrentSetSize( set ) );
+
+    for( int i = 0; i < numElements; i++ ) {
+        int *element = mallocInt( i );
+        assertTrue( concurrentSetContains( set, element ), "%d should be in the set!\n", i );
+        free( element );
+    }
+
+    concurrentSetFree( set );
+}
+
+void testSetRemove() {
+    ConcurrentSet *set = newConcurrentSet( comparisonFunction );
+    const int numElements = 1000;
+
+    for( int i = 0; i < numElements; i++ ) {
+        concurrentSetAdd( set, mallocInt( i ) );
+    }
+
+    for( int i = 0; i < numElements; i += 2 ) {
+        int *element = mallocInt( i );
+
+        assertTrue( concurrentSetRemove( set, element ), "Could not remove %d!\n", i );
+        assertFalse( concurrentSetContains( set, element ), "Found %d after removal!\n", i );
+        assertFalse( concurrentSetRemove( set, element ), "Removed %d twice!\n", i );
+
+        free( element );
+    }
+
+    assertTrue( concurrentSetSize( set ) == numElements / 2, "Set size should be %d, was %d!\n",
+            numElements / 2, concurrentSetSize( set ) );
+
+    concurrentSetFree( set );
+}
+
+void testConcurrentReaders() {
+    pthread_t readers[ NUM_READERS ];
+    sharedSet = newConcurrentSet( comparisonFunction );
+    writerDone = 0;
+
+    for( int i = 0; i < numStable; i++ ) {
+        concurrentSetAdd( sharedSet, mallocInt( i ) );
+    }
+
+    for( int i = 0; i < NUM_READERS; i++ ) {
+        pthread_create( &readers[i], NULL, readSet, NULL );
+    }
+
+    // Churn elements above the stable range while the readers search
+    for( int round = 0; round < 20; round++ ) {
+        for( int i = numStable; i < 2 * numStable; i++ ) {
+            int *element = mallocInt( i );
+
+            if( ! concurrentSetAdd( sharedSet, element ) ) {
+                free( element );
+            }
+        }
+
+        for( int i = numStable; i < 2 * numStable; i++ ) {
+            int *element = mallocInt( i );
+            concurrentSetRemove( sharedSet, element );
+            free( element );
+        }
+    }
+
+    __atomic_store_n( &writerDone, 1, __ATOMIC_RELEASE );
+    for( int i = 0; i < NUM_READERS; i++ ) {
+        pthread_join( readers[i], NULL );
+    }
+
+    assertTrue( concurrentSetSize( sharedSet ) == numStable, "Set size should be %d, was %d!\n",
+            numStable, concurrentSetSize( sharedSet ) );
+
+    concurrentSetFree( sharedSet );
+}
+
+void testConcurrentWriters() {
+    pthread_t writers[ NUM_WRITERS ];
+    int offsets[ NUM_WRITERS ];
+    sharedSet = newConcurrentSet( comparisonFunction );
+
+    for( int i = 0; i < NUM_WRITERS; i++ ) {
+        offsets[i] = i * elementsPerWriter;
+        pthread_create( &writers[i], NULL, writeSet, &offsets[i] );
+    }
+
+    for( int i = 0; i < NUM_WRITERS; i++ ) {
+        pthread_join( writers[i], NULL );
+    }
+
+    // Every writer removed the odd elements it added
+    int expected = NUM_WRITERS * elementsPerWriter / 2;
+    assertTrue( concurrentSetSize( sharedSet ) == expected, "Set size should be %d, was %d!\n",
+            expected, concurrentSetSize( sharedSet ) );
+
+    for( int i = 0; i < NUM_WRITERS * elementsPerWriter; i++ ) {
+        int *element = mallocInt( i );
+        assertTrue( concurrentSetContains( sharedSet, element ) == (i % 2 == 0),
+                "%d has the wrong membership!\n", i );
+        free( element );
+    }
+
+    concurrentSetFree( sharedSet );
+}
+
+/* Functions for use in testing */
+void *readSet( void *argument ) {
+    int *stable = mallocInt( 0 );
+    int *missing = mallocInt( 0 );
+
+    // rand isn't safe to share between threads, so the readers step through the ranges instead
+    int step = 0;
+    while( ! __atomic_load_n( &writerDone, __ATOMIC_ACQUIRE ) ) {
+        step = (step + 7919) % numStable;
+        *stable = step;
+        *missing = 2 * numStable + *stable;
+
+        assertTrue( concurrentSetContains( sharedSet, stable ), "%d should always be found!\n",
+                *stable );
+        assertFalse( concurrentSetContains( sharedSet, missing ), "%d should never be found!\n",
+                *missing );
+    }
+
+    free( stable );
+    free( missing );
+    return NULL;
+}
+
+void *writeSet( void *argument ) {
+    int offset = *(int *) argument;
+
+    for( int i = offset; i < offset + elementsPerWriter; i++ ) {
+        assertTrue( concurrentSetAdd( sharedSet, mallocInt( i ) ), "%d should be added!\n", i );
+    }
+
+    for( int i = offset + 1; i < offset + elementsPerWriter; i += 2 ) {
+        int *element = mallocInt( i );
+        assertTrue( concurrentSetRemove( sharedSet, element ), "Could not remove %d!\n", i );
+        free( element );
+    }
+
+    return NULL;
+}
+
+int comparisonFunction( void *aPtr, void *bPtr ) {
+    int a = *((int *) aPtr);
+    int b = *((int *) bPtr);
+
+    if( a < b ) {
+        return -1;
+    } else if( a == b ) {
+        return 0;
+    } else {
+        return 1;
+    }
+}
+
+int *mallocInt( int a ) {
+    int *newInt = (int *) malloc( sizeof(int) );
+    *newInt = a;
+
+    return newInt;
+}
@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "utils.h"
+#include "bst.h"
+#include "frozenbst.h"
+
+/* Test function prototypes */
+void testFreeze();
+void testFrozenFind();
+void testFreezeEmptyTree();
+
+/* Functions used in testing */
+int comparisonFunction( void *aPtr, void *bPtr );
+int *mallocInt( int a );
+
+int main( int argc, char *argv[] ) {
+    setDebuggingLevel( E_ERROR );
+    srand( time(NULL) );
+
+    testFreeze();
+    testFrozenFind();
+    testFreezeEmptyTree();
+
+    return 0;
+}
+
+void testFreeze() {
+    BST *bst = newBST( comparisonFunction );
+    const int numElements = 100;
+
+    for( int i = 0; i < numElements; i++ ) {
+        bstInsert( bst, mallocInt( i ) );
+    }
+
+    FrozenBST *frozen = bstFreeze( bst );
+    assertTrue( frozen->size == numElements, "Frozen size should be %d, was %d!\n", numElements,
+            frozen->size );
+
+    // Every element should be ordered with respect to its children
+    for( int i = 1; i <= frozen->size; i++ ) {
+        if( 2 * i <= frozen->size ) {
+            assertTrue( comparisonFunction( frozen->elements[2 * i], frozen->elements[i] ) < 0,
+                    "The left child of %d is out of order!\n", i );
+        }
+
+        if( 2 * i + 1 <= frozen->size ) {
+            assertTrue( comparisonFunction( frozen->elements[2 * i + 1], frozen->elements[i] ) > 0,
+                    "The right child of %d is out of order!\n", i );
+        }
+    }
+
+    // The tree is unchanged and still owns the elements
+    assertTrue( bst->size == numElements, "Freezing shouldn't modify the tree!\n" );
+    frozenBSTFreeStructure( frozen );
+    bstFree( bst );
+}
+
+void testFrozenFind() {
+    const int maxElements = 300;
+
+    // Check sizes that fill the last level of the implicit tree to different degrees
+    for( int numElements = 1; numElements <= maxElements; numElements += 37 ) {
+        BST *bst = newBST( comparisonFunction );
+
+        for( int i = 0; i < numElements; i++ ) {
+            bstInsert( bst, mallocInt( 2 * i ) );
+        }
+
+        FrozenBST *frozen = bstFreeze( bst );
+
+        // Even numbers are in the array and odd numbers aren't
+        for( int i = -2; i <= 2 * numElements + 1; i++ ) {
+            int *element = mallocInt( i );
+            void *found = frozenBSTFind( frozen, element );
+
+            assertTrue( found == bstFind( bst, element ),
+                    "Frozen search for %d with %d elements doesn't match bstFind!\n", i,
+                    numElements );
+            free( element );
+        }
+
+        frozenBSTFreeStructure( frozen );
+        bstFree( bst );
+    }
+}
+
+void testFreezeEmptyTree() {
+    BST *bst = newBST( comparisonFunction );
+    FrozenBST *frozen = bstFreeze( bst );
+    int *element = mallocInt( 1 );
+
+    assertTrue( frozen->size == 0, "Frozen size should be 0, was %d!\n", frozen->size );
+    assertNull( frozenBSTFind( frozen, element ), "Nothing should be found in an empty array!\n" );
+
+    free( element );
+    frozenBSTFree( frozen );
+    bstFree( bst );
+}
+
+/* Functions for use in testing */
+int comparisonFunction( void *aPtr, void *bPtr ) {
+    int a = *((int *) aPtr);
+    int b = *((int *) bPtr);
+
+    if( a < b ) {
+        return -1;
+    } else if( a == b ) {
+        return 0;
+    } else {
+        return 1;
+    }
+}
+
+int *mallocInt( int a ) {
+    int *newInt = (int *) malloc( sizeof(int) );
+    *newInt = a;
+
+    return newInt;
+}
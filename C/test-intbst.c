@@ -0,0 +1,196 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "utils.h"
+#include "intbst.h"
+
+/* Test function prototypes */
+void testTreeCreation();
+void testTreeInsertion();
+void testTreeFind();
+void testTreeRemoval();
+void testLargeKeys();
+
+/* Functions used in testing */
+int *mallocInt( int a );
+void shuffle( int64_t *values, int numValues );
+int parentsAreValid( IntBSTNode *node );
+
+int main( int argc, char *argv[] ) {
+    setDebuggingLevel( E_ERROR );
+    srand( time(NULL) );
+
+    testTreeCreation();
+    testTreeInsertion();
+    testTreeFind();
+    testTreeRemoval();
+    testLargeKeys();
+
+    return 0;
+}
+
+void testTreeCreation() {
+    IntBST *bst = newIntBST();
+
+    assertNotNull( bst, "The new integer tree shouldn't be null!\n" );
+    assertNull( bst->root, "The new integer tree should have no root!\n" );
+    assertTrue( bst->size == 0, "The new integer tree should be empty!\n" );
+
+    intBSTFree( bst );
+}
+
+void testTreeInsertion() {
+    IntBST *bst = newIntBST();
+    const int numElements = 5000;
+    int64_t *order = malloc( sizeof(int64_t) * numElements );
+
+    for( int i = 0; i < numElements; i++ ) {
+        order[i] = i;
+    }
+
+    shuffle( order, numElements );
+    for( int i = 0; i < numElements; i++ ) {
+        assertTrue( intBSTInsert( bst, order[i], NULL ), "%d should be inserted!\n",
+                (int) order[i] );
+    }
+
+    assertFalse( intBSTInsert( bst, numElements / 2, NULL ),
+            "Duplicates shouldn't be inserted!\n" );
+    assertTrue( bst->size == numElements, "Integer tree size should be %d, was %d!\n",
+            numElements, bst->size );
+    assertTrue( parentsAreValid( bst->root ), "Parent pointers are invalid after insertion!\n" );
+
+    int64_t *keys = intBSTKeys( bst );
+    for( int i = 0; i < numElements; i++ ) {
+        assertTrue( keys[i] == i, "Key %d is out of order!\n", i );
+    }
+
+    free( keys );
+    free( order );
+    intBSTFree( bst );
+}
+
+void testTreeFind() {
+    IntBST *bst = newIntBST();
+    const int numElements = 5000;
+
+    // Even keys map to their halves
+    for( int i = 0; i < numElements; i++ ) {
+        int key = 2 * (rand() % numElements);
+        int *value = mallocInt( key / 2 );
+
+        if( ! intBSTInsert( bst, key, value ) ) {
+            free( value );
+        }
+    }
+
+    for( int i = 0; i < numElements; i++ ) {
+        void *value = NULL;
+
+        if( intBSTFind( bst, 2 * i, &value ) ) {
+            assertTrue( *(int *) value == i, "Found the wrong value for %d!\n", 2 * i );
+        }
+
+        assertFalse( intBSTFind( bst, 2 * i + 1, NULL ), "Found %d, which was never inserted!\n",
+                2 * i + 1 );
+    }
+
+    intBSTFree( bst );
+}
+
+void testTreeRemoval() {
+    IntBST *bst = newIntBST();
+    const int numElements = 5000;
+    int64_t *order = malloc( sizeof(int64_t) * numElements );
+
+    for( int i = 0; i < numElements; i++ ) {
+        order[i] = i;
+    }
+
+    shuffle( order, numElements );
+    for( int i = 0; i < numElements; i++ ) {
+        intBSTInsert( bst, order[i], mallocInt( (int) order[i] ) );
+    }
+
+    // Remove the keys in a different random order
+    shuffle( order, numElements );
+    for( int i = 0; i < numElements; i++ ) {
+        void *value = NULL;
+
+        assertTrue( intBSTRemove( bst, order[i], &value ), "Could not remove %d!\n",
+                (int) order[i] );
+        assertTrue( *(int *) value == order[i], "Removed the wrong value for %d!\n",
+                (int) order[i] );
+        assertFalse( intBSTFind( bst, order[i], NULL ), "Could still find %d after removal!\n",
+                (int) order[i] );
+        assertFalse( intBSTRemove( bst, order[i], NULL ), "Removed %d twice!\n", (int) order[i] );
+
+        if( i % 500 == 0 ) {
+            assertTrue( parentsAreValid( bst->root ), "Invalid parent pointers after removal!\n" );
+        }
+
+        free( value );
+    }
+
+    assertTrue( bst->size == 0, "Integer tree size should be 0, was %d!\n", bst->size );
+    assertNull( bst->root, "An empty integer tree should have no root!\n" );
+
+    free( order );
+    intBSTFree( bst );
+}
+
+void testLargeKeys() {
+    IntBST *bst = newIntBST();
+    int64_t keys[] = { INT64_MIN, -1, 0, 1, INT64_MAX, (int64_t) 1 << 40, -((int64_t) 1 << 40) };
+    int numKeys = sizeof(keys) / sizeof(keys[0]);
+
+    for( int i = 0; i < numKeys; i++ ) {
+        assertTrue( intBSTInsert( bst, keys[i], NULL ), "Key %d should be inserted!\n", i );
+    }
+
+    for( int i = 0; i < numKeys; i++ ) {
+        assertTrue( intBSTFind( bst, keys[i], NULL ), "Key %d should be found!\n", i );
+    }
+
+    // Keys that only differ in their high bits must not collide
+    assertFalse( intBSTFind( bst, ((int64_t) 1 << 40) + 1, NULL ), "Found a missing key!\n" );
+
+    int64_t *sorted = intBSTKeys( bst );
+    assertTrue( sorted[0] == INT64_MIN && sorted[numKeys - 1] == INT64_MAX,
+            "Keys should be sorted from INT64_MIN to INT64_MAX!\n" );
+
+    free( sorted );
+    intBSTFreeStructure( bst );
+}
+
+/* Functions for use in testing */
+int *mallocInt( int a ) {
+    int *newInt = (int *) malloc( sizeof(int) );
+    *newInt = a;
+
+    return newInt;
+}
+
+void shuffle( int64_t *values, int numValues ) {
+    for( int i = numValues - 1; i > 0; i-- ) {
+        int j = rand() % (i + 1);
+        int64_t swap = values[i];
+        values[i] = values[j];
+        values[j] = swap;
+    }
+}
+
+int parentsAreValid( IntBSTNode *node ) {
+    if( node == NULL ) {
+        return 1;
+    }
+
+    if( node->left && node->left->parent != node ) {
+        return 0;
+    } else if( node->right && node->right->parent != node ) {
+        return 0;
+    }
+
+    return parentsAreValid( node->left ) && parentsAreValid( node->right );
+}
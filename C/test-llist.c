@@ -11,6 +11,8 @@ void testListCreation();
 void testInserts();
 void testListFind();
 void testRemoval();
+void testSequentialAccess();
+void testUnsortedQueue();
 
 int main( int argc, char *argv[] ) {
     setDebuggingLevel( E_ERROR );
@@ -18,6 +20,8 @@ int main( int argc, char *argv[] ) {
     testInserts();
     testListFind();
     testRemoval();
+    testSequentialAccess();
+    testUnsortedQueue();
 
     return 0;
 }
@@ -161,3 +165,140 @@ void testRemoval() {
     // Free the list
     listFree( list );
 }
+
+void testSequentialAccess() {
+    LList *list = newList( comparisonFunction );
+    const int numElements = 1000;
+
+    // Insert ascending elements, which should resume from the finger each time
+    for( int i = 0; i < numElements; i += 2 ) {
+        listInsert( list, mallocInt(i) );
+    }
+
+    // Fill in the gaps with another ascending stream
+    for( int i = 1; i < numElements; i += 2 ) {
+        listInsert( list, mallocInt(i) );
+    }
+
+    assertTrue( list->size == numElements, "List should have %d elements, has %d\n", numElements,
+            list->size );
+
+    // Find the elements in ascending order, then in descending order
+    for( int i = 0; i < numElements; i++ ) {
+        int *intToFind = mallocInt(i);
+        ListNode *findResult = listFind( list, intToFind );
+        assertNotNull( findResult, "find(%d) should not be NULL!\n", i );
+        free( intToFind );
+    }
+
+    for( int i = numElements - 1; i >= 0; i-- ) {
+        int *intToFind = mallocInt(i);
+        ListNode *findResult = listFind( list, intToFind );
+        assertNotNull( findResult, "find(%d) should not be NULL!\n", i );
+        free( intToFind );
+    }
+
+    // Elements past either end of the list shouldn't be found
+    int *tooLarge = mallocInt( numElements );
+    int *tooSmall = mallocInt( -1 );
+    assertNull( listFind( list, tooLarge ), "find(%d) should be NULL!\n", *tooLarge );
+    assertNull( listFind( list, tooSmall ), "find(%d) should be NULL!\n", *tooSmall );
+    assertNull( listRemove( list, tooLarge ), "remove(%d) should be NULL!\n", *tooLarge );
+    free( tooLarge );
+    free( tooSmall );
+
+    // Remove the even elements in ascending order and ensure the odd ones remain
+    for( int i = 0; i < numElements; i += 2 ) {
+        int *elementToRemove = mallocInt(i);
+        int *removedElement = listRemove( list, elementToRemove );
+        assertNotNull( removedElement, "remove(%d) should not be NULL!\n", i );
+        free( elementToRemove );
+        free( removedElement );
+    }
+
+    for( int i = 0; i < numElements; i++ ) {
+        int *intToFind = mallocInt(i);
+        ListNode *findResult = listFind( list, intToFind );
+
+        if( i % 2 == 0 ) {
+            assertNull( findResult, "find(%d) should be NULL after removal!\n", i );
+        } else {
+            assertNotNull( findResult, "find(%d) should not be NULL!\n", i );
+        }
+
+        free( intToFind );
+    }
+
+    assertTrue( list->size == numElements / 2, "List should have %d elements, has %d\n",
+            numElements / 2, list->size );
+
+    // Free the list
+    listFree( list );
+}
+
+void testUnsortedQueue() {
+    LList *list = newList( NULL );
+    const int numElements = 100;
+
+    assertNull( list->comparisonFunction, "Unsorted list shouldn't have a comparisonFunction!\n" );
+    assertNull( listPopFront( list ), "Popping an empty list should return NULL!\n" );
+    assertNull( listPopBack( list ), "Popping an empty list should return NULL!\n" );
+
+    // Use the list as a FIFO queue
+    for( int i = 0; i < numElements; i++ ) {
+        listInsert( list, mallocInt(i) );
+    }
+
+    for( int i = 0; i < numElements; i++ ) {
+        int *popped = listPopFront( list );
+        assertNotNull( popped, "popFront() should not be NULL!\n" );
+        assertTrue( *popped == i, "popFront() should be %d, was %d\n", i, *popped );
+        free( popped );
+    }
+
+    assertTrue( list->size == 0, "List should be empty, has %d elements\n", list->size );
+
+    // Use the list as a LIFO stack from both ends
+    for( int i = 0; i < numElements; i++ ) {
+        listPushFront( list, mallocInt(i) );
+    }
+
+    for( int i = 0; i < numElements; i++ ) {
+        int *popped = listPopBack( list );
+        assertTrue( *popped == i, "popBack() should be %d, was %d\n", i, *popped );
+        free( popped );
+    }
+
+    // Remove nodes from the middle of the list by reference
+    ListNode *nodes[ numElements ];
+    for( int i = 0; i < numElements; i++ ) {
+        listPushBack( list, mallocInt(i) );
+        nodes[i] = list->tail->prev;
+    }
+
+    for( int i = 1; i < numElements; i += 2 ) {
+        int *removed = listRemoveNode( list, nodes[i] );
+        assertTrue( *removed == i, "removeNode() should be %d, was %d\n", i, *removed );
+        free( removed );
+    }
+
+    assertTrue( list->size == numElements / 2, "List should have %d elements, has %d\n",
+            numElements / 2, list->size );
+
+    // The remaining elements should still be in order and linked in both directions
+    int expected = 0;
+    for( ListNode *current = list->head; current != list->tail; current = current->next ) {
+        assertTrue( *(int *)current->data == expected, "Expected %d, was %d\n", expected,
+                *(int *)current->data );
+        assertTrue( current->next->prev == current, "prev link of %d is broken\n", expected );
+        expected += 2;
+    }
+
+    // Unsorted lists find and remove elements by pointer
+    int *last = list->tail->prev->data;
+    assertTrue( listFind( list, last ) == list->tail->prev, "find() should return the last node\n" );
+    assertTrue( listRemove( list, last ) == last, "remove() should return the last element\n" );
+    free( last );
+
+    listFree( list );
+}
@@ -0,0 +1,324 @@
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "utils.h"
+#include "persistentbst.h"
+
+/* The number of threads reading snapshots in testConcurrentSnapshots */
+#define NUM_READERS 4
+
+/* Test function prototypes */
+void testTreeCreation();
+void testVersions();
+void testSnapshots();
+void testRemoval();
+void testStructuralSharing();
+void testConcurrentSnapshots();
+
+/* Functions used in testing */
+int comparisonFunction( void *aPtr, void *bPtr );
+int *mallocInt( int a );
+int isValidTreap( PersistentNode *node, PersistentNode *low, PersistentNode *high );
+int countSharedNodes( PersistentNode *node );
+int countNodes( PersistentNode *node );
+void *readSnapshots( void *argument );
+
+/* The version shared between the writer and readers in testConcurrentSnapshots */
+PersistentBST *current = NULL;
+pthread_mutex_t currentLock = PTHREAD_MUTEX_INITIALIZER;
+int writerDone = 0;
+
+int main( int argc, char *argv[] ) {
+    setDebuggingLevel( E_ERROR );
+    srand( time(NULL) );
+
+    testTreeCreation();
+    testVersions();
+    testSnapshots();
+    testRemoval();
+    testStructuralSharing();
+    testConcurrentSnapshots();
+
+    return 0;
+}
+
+void testTreeCreation() {
+    PersistentBST *version = newPersistentBST( comparisonFunction );
+
+    assertNotNull( version, "The new persistent tree shouldn't be null!\n" );
+    assertNull( version->root, "The new persistent tree should have no root!\n" );
+    assertTrue( version->size == 0, "The new persistent tree should be empty!\n" );
+    assertNull( newPersistentBST( NULL ), "A persistent tree needs a comparison function!\n" );
+
+    persistentBSTFree( version );
+}
+
+void testVersions() {
+    const int numElements = 200;
+    PersistentBST **versions = malloc( sizeof(PersistentBST *) * (numElements + 1) );
+    int **elements = malloc( sizeof(int *) * numElements );
+
+    versions[0] = newPersistentBST( comparisonFunction );
+    for( int i = 0; i < numElements; i++ ) {
+        elements[i] = mallocInt( (i * 37) % numElements );
+        versions[i + 1] = persistentBSTInsert( versions[i], elements[i] );
+    }
+
+    // Every version still holds exactly the elements that had been inserted when it was made
+    for( int v = 0; v <= numElements; v += 20 ) {
+        assertTrue( versions[v]->size == v, "Version %d should have %d elements, had %d!\n", v, v,
+                versions[v]->size );
+
+        for( int i = 0; i < numElements; i++ ) {
+            assertTrue( (persistentBSTFind( versions[v], elements[i] ) != NULL) == (i < v),
+                    "Version %d has the wrong membership for element %d!\n", v, i );
+        }
+
+        assertTrue( isValidTreap( versions[v]->root, NULL, NULL ), "Version %d is malformed!\n",
+                v );
+    }
+
+    // Inserting a duplicate produces an equal version
+    int *duplicate = mallocInt( 5 );
+    PersistentBST *same = persistentBSTInsert( versions[numElements], duplicate );
+    assertTrue( same->size == numElements, "A duplicate shouldn't be added!\n" );
+    assertTrue( same->root == versions[numElements]->root, "A duplicate should share the root!\n" );
+    free( duplicate );
+
+    void **sorted = persistentBSTElements( same );
+    for( int i = 0; i < numElements; i++ ) {
+        assertTrue( *(int *) sorted[i] == i, "Element %d is out of order!\n", i );
+    }
+
+    free( sorted );
+    persistentBSTFree( same );
+    for( int v = 0; v <= numElements; v++ ) {
+        persistentBSTFreeStructure( versions[v] );
+    }
+
+    free( elements );
+    free( versions );
+}
+
+void testSnapshots() {
+    PersistentBST *version = newPersistentBST( comparisonFunction );
+
+    for( int i = 0; i < 100; i++ ) {
+        PersistentBST *next = persistentBSTInsert( version, mallocInt( i ) );
+        persistentBSTFreeStructure( version );
+        version = next;
+    }
+
+    // A snapshot shares the whole tree
+    int refCount = version->root->refCount;
+    PersistentBST *snapshot = persistentBSTSnapshot( version );
+    assertTrue( snapshot->root == version->root, "A snapshot should share the root!\n" );
+    assertTrue( version->root->refCount == refCount + 1,
+            "A snapshot should hold a reference to the root!\n" );
+
+    // Updating the original leaves the snapshot as it was
+    int *element = mallocInt( 1000 );
+    PersistentBST *next = persistentBSTInsert( version, element );
+    persistentBSTFreeStructure( version );
+
+    assertTrue( snapshot->size == 100, "The snapshot should still have 100 elements!\n" );
+    assertNull( persistentBSTFind( snapshot, element ), "The snapshot shouldn't see updates!\n" );
+    assertNotNull( persistentBSTFind( next, element ), "The new version should see updates!\n" );
+
+    persistentBSTFreeStructure( snapshot );
+    persistentBSTFree( next );
+}
+
+void testRemoval() {
+    const int numElements = 500;
+    PersistentBST *full = newPersistentBST( comparisonFunction );
+
+    for( int i = 0; i < numElements; i++ ) {
+        PersistentBST *next = persistentBSTInsert( full, mallocInt( i ) );
+        persistentBSTFreeStructure( full );
+        full = next;
+    }
+
+    // Remove every even element from a chain of versions derived from the full one
+    PersistentBST *version = persistentBSTSnapshot( full );
+    for( int i = 0; i < numElements; i += 2 ) {
+        int *element = mallocInt( i );
+        void *removed = NULL;
+        PersistentBST *next = persistentBSTRemove( version, element, &removed );
+
+        assertTrue( removed != NULL && *(int *) removed == i, "Could not remove %d!\n", i );
+        assertNull( persistentBSTFind( next, element ), "Could still find %d after removal!\n", i );
+        assertNotNull( persistentBSTFind( version, element ),
+                "The previous version should still have %d!\n", i );
+
+        persistentBSTFreeStructure( version );
+        version = next;
+        free( element );
+    }
+
+    int *missing = mallocInt( -1 );
+    void *removed = missing;
+    PersistentBST *same = persistentBSTRemove( version, missing, &removed );
+    assertNull( removed, "Nothing should be removed for a missing element!\n" );
+    assertTrue( same->size == version->size, "Removing a missing element changed the size!\n" );
+    persistentBSTFreeStructure( same );
+    free( missing );
+
+    assertTrue( version->size == numElements / 2, "Size should be %d, was %d!\n",
+            numElements / 2, version->size );
+    assertTrue( isValidTreap( version->root, NULL, NULL ), "The tree is malformed!\n" );
+    assertTrue( full->size == numElements, "The full version should be unchanged!\n" );
+
+    persistentBSTFreeStructure( version );
+    persistentBSTFree( full );
+}
+
+void testStructuralSharing() {
+    const int numElements = 1 << 14;
+    PersistentBST *version = newPersistentBST( comparisonFunction );
+
+    for( int i = 0; i < numElements; i++ ) {
+        PersistentBST *next = persistentBSTInsert( version, mallocInt( i ) );
+        persistentBSTFreeStructure( version );
+        version = next;
+    }
+
+    // Nodes off the copied path are shared, so almost every node ends up with two references
+    int *element = mallocInt( numElements );
+    PersistentBST *next = persistentBSTInsert( version, element );
+    int copied = numElements - countSharedNodes( version->root );
+    assertTrue( copied < 100, "An insert copied %d of %d nodes!\n", copied, numElements );
+
+    persistentBSTFreeStructure( version );
+    persistentBSTFree( next );
+}
+
+void testConcurrentSnapshots() {
+    const int numUpdates = 20000;
+    int **elements = malloc( sizeof(int *) * numUpdates );
+    pthread_t readers[ NUM_READERS ];
+
+    current = newPersistentBST( comparisonFunction );
+    writerDone = 0;
+
+    for( int i = 0; i < NUM_READERS; i++ ) {
+        pthread_create( &readers[i], NULL, readSnapshots, NULL );
+    }
+
+    // The writer alternates between adding elements and removing older ones
+    for( int i = 0; i < numUpdates; i++ ) {
+        elements[i] = mallocInt( i );
+
+        pthread_mutex_lock( &currentLock );
+        PersistentBST *previous = current;
+        if( i % 3 == 2 ) {
+            current = persistentBSTRemove( previous, elements[i / 2], NULL );
+        } else {
+            current = persistentBSTInsert( previous, elements[i] );
+        }
+        pthread_mutex_unlock( &currentLock );
+
+        persistentBSTFreeStructure( previous );
+    }
+
+    __atomic_store_n( &writerDone, 1, __ATOMIC_RELEASE );
+    for( int i = 0; i < NUM_READERS; i++ ) {
+        pthread_join( readers[i], NULL );
+    }
+
+    assertTrue( isValidTreap( current->root, NULL, NULL ), "The final version is malformed!\n" );
+
+    persistentBSTFreeStructure( current );
+    for( int i = 0; i < numUpdates; i++ ) {
+        free( elements[i] );
+    }
+
+    free( elements );
+}
+
+/* Functions for use in testing */
+void *readSnapshots( void *argument ) {
+    while( ! __atomic_load_n( &writerDone, __ATOMIC_ACQUIRE ) ) {
+        pthread_mutex_lock( &currentLock );
+        PersistentBST *snapshot = persistentBSTSnapshot( current );
+        pthread_mutex_unlock( &currentLock );
+
+        // The snapshot is read without the lock while the writer keeps updating
+        void **elements = persistentBSTElements( snapshot );
+        for( int i = 1; i < snapshot->size; i++ ) {
+            assertTrue( comparisonFunction( elements[i - 1], elements[i] ) < 0,
+                    "A snapshot was out of order!\n" );
+        }
+
+        free( elements );
+        persistentBSTFreeStructure( snapshot );
+    }
+
+    return NULL;
+}
+
+int comparisonFunction( void *aPtr, void *bPtr ) {
+    int a = *((int *) aPtr);
+    int b = *((int *) bPtr);
+
+    if( a < b ) {
+        return -1;
+    } else if( a == b ) {
+        return 0;
+    } else {
+        return 1;
+    }
+}
+
+int *mallocInt( int a ) {
+    int *newInt = (int *) malloc( sizeof(int) );
+    *newInt = a;
+
+    return newInt;
+}
+
+/*
+ * Checks that a subtree is ordered, that every element lies strictly between the bounds, and that
+ * every node's reference count is positive. Balance isn't checked directly, since the priorities
+ * are private to the tree.
+ */
+int isValidTreap( PersistentNode *node, PersistentNode *low, PersistentNode *high ) {
+    if( node == NULL ) {
+        return 1;
+    }
+
+    if( node->refCount <= 0 ) {
+        return 0;
+    } else if( low && comparisonFunction( low->data, node->data ) >= 0 ) {
+        return 0;
+    } else if( high && comparisonFunction( node->data, high->data ) >= 0 ) {
+        return 0;
+    }
+
+    return isValidTreap( node->left, low, node ) && isValidTreap( node->right, node, high );
+}
+
+/*
+ * Counts the nodes of a subtree that are referenced from more than one place. The walk doesn't
+ * descend below a shared node, since everything beneath it is shared as well.
+ */
+int countSharedNodes( PersistentNode *node ) {
+    if( node == NULL ) {
+        return 0;
+    } else if( node->refCount > 1 ) {
+        return countNodes( node );
+    }
+
+    return countSharedNodes( node->left ) + countSharedNodes( node->right );
+}
+
+int countNodes( PersistentNode *node ) {
+    if( node == NULL ) {
+        return 0;
+    }
+
+    return 1 + countNodes( node->left ) + countNodes( node->right );
+}
@@ -0,0 +1,201 @@
+#include <stdlib.h>
+#include <time.h>
+
+#include "utils.h"
+#include "vector.h"
+#include "pqueue.h"
+
+/* Test functions prototypes */
+void testQueueCreation();
+void testPushAndPop();
+void testArities();
+void testHeapify();
+void testDecreaseKey();
+void testHandleRemoval();
+
+/* Functions used in testing */
+int comparisonFunction( void *aPtr, void *bPtr );
+int *mallocInt( int a );
+
+int main( int argc, char *argv[] ) {
+    setDebuggingLevel( E_ERROR );
+    srand( time(NULL) );
+
+    testQueueCreation();
+    testPushAndPop();
+    testArities();
+    testHeapify();
+    testDecreaseKey();
+    testHandleRemoval();
+
+    return 0;
+}
+
+void testQueueCreation() {
+    PriorityQueue *pq = newPriorityQueue( comparisonFunction );
+
+    assertNotNull( pq, "The new queue shouldn't be null!\n" );
+    assertTrue( pq->arity == PQ_DEFAULT_ARITY, "Arity should be %d, was %d\n", PQ_DEFAULT_ARITY,
+            pq->arity );
+    assertTrue( pqIsEmpty( pq ), "The new queue should be empty!\n" );
+    assertNull( pqPeek( pq ), "Peeking an empty queue should return NULL!\n" );
+    assertNull( pqPop( pq ), "Popping an empty queue should return NULL!\n" );
+    assertNull( pqPush( pq, NULL ), "NULL shouldn't be pushed onto the queue!\n" );
+
+    assertNull( newPriorityQueue( NULL ), "A queue without a comparison function should be NULL!\n" );
+    assertNull( newPriorityQueueWithArity( comparisonFunction, 1 ), "Arity 1 should be invalid!\n" );
+
+    pqFree( pq );
+}
+
+void testPushAndPop() {
+    PriorityQueue *pq = newPriorityQueue( comparisonFunction );
+    const int numElements = 1000;
+
+    for( int i = 0; i < numElements; i++ ) {
+        pqPush( pq, mallocInt( rand() % 500 ) );
+    }
+
+    assertTrue( pqSize( pq ) == numElements, "Queue size should be %d, was %d\n", numElements,
+            pqSize( pq ) );
+
+    // Elements should come out in non-decreasing order
+    int previous = -1;
+    for( int i = 0; i < numElements; i++ ) {
+        int *peeked = pqPeek( pq );
+        int *popped = pqPop( pq );
+        assertTrue( peeked == popped, "Peek and pop should return the same element!\n" );
+        assertTrue( *popped >= previous, "Popped %d after %d\n", *popped, previous );
+        previous = *popped;
+        free( popped );
+    }
+
+    assertTrue( pqIsEmpty( pq ), "The queue should be empty!\n" );
+    pqFree( pq );
+}
+
+void testArities() {
+    const int numElements = 500;
+
+    for( int arity = 2; arity <= 8; arity++ ) {
+        PriorityQueue *pq = newPriorityQueueWithArity( comparisonFunction, arity );
+
+        for( int i = numElements - 1; i >= 0; i-- ) {
+            pqPush( pq, mallocInt(i) );
+        }
+
+        for( int i = 0; i < numElements; i++ ) {
+            int *popped = pqPop( pq );
+            assertTrue( *popped == i, "Arity %d: popped %d, expected %d\n", arity, *popped, i );
+            free( popped );
+        }
+
+        pqFree( pq );
+    }
+}
+
+void testHeapify() {
+    Vector *vector = newVector( 10 );
+    const int numElements = 1000;
+
+    for( int i = 0; i < numElements; i++ ) {
+        vectorAdd( vector, mallocInt( rand() ) );
+    }
+
+    PriorityQueue *pq = newPriorityQueueFromVector( vector, comparisonFunction, PQ_DEFAULT_ARITY );
+    assertTrue( pqSize( pq ) == numElements, "Heapified size should be %d, was %d\n", numElements,
+            pqSize( pq ) );
+
+    int previous = -1;
+    while( ! pqIsEmpty( pq ) ) {
+        int *popped = pqPop( pq );
+        assertTrue( *popped >= previous, "Popped %d after %d\n", *popped, previous );
+        previous = *popped;
+    }
+
+    pqFree( pq );
+    freeVector( vector );
+}
+
+void testDecreaseKey() {
+    PriorityQueue *pq = newPriorityQueue( comparisonFunction );
+    const int numElements = 100;
+    PQHandle *handles[ numElements ];
+
+    for( int i = 0; i < numElements; i++ ) {
+        handles[i] = pqPush( pq, mallocInt( 1000 + i ) );
+    }
+
+    // Move the last element to the front of the queue
+    int *last = handles[ numElements - 1 ]->data;
+    *last = 0;
+    pqDecreaseKey( pq, handles[ numElements - 1 ] );
+    assertTrue( pqPeek( pq ) == last, "The decreased element should be at the front!\n" );
+
+    // Decrease every other element and ensure the ordering still holds
+    for( int i = 0; i < numElements - 1; i += 2 ) {
+        *(int *)handles[i]->data -= 500;
+        pqDecreaseKey( pq, handles[i] );
+    }
+
+    int previous = -1;
+    while( ! pqIsEmpty( pq ) ) {
+        int *popped = pqPop( pq );
+        assertTrue( *popped >= previous, "Popped %d after %d\n", *popped, previous );
+        previous = *popped;
+        free( popped );
+    }
+
+    pqFree( pq );
+}
+
+void testHandleRemoval() {
+    PriorityQueue *pq = newPriorityQueue( comparisonFunction );
+    const int numElements = 200;
+    PQHandle *handles[ numElements ];
+
+    for( int i = 0; i < numElements; i++ ) {
+        handles[i] = pqPush( pq, mallocInt( rand() % 1000 ) );
+    }
+
+    // Cancel every third element
+    int removed = 0;
+    for( int i = 0; i < numElements; i += 3 ) {
+        free( pqRemove( pq, handles[i] ) );
+        removed++;
+    }
+
+    assertTrue( pqSize( pq ) == numElements - removed, "Queue size should be %d, was %d\n",
+            numElements - removed, pqSize( pq ) );
+
+    int previous = -1;
+    while( ! pqIsEmpty( pq ) ) {
+        int *popped = pqPop( pq );
+        assertTrue( *popped >= previous, "Popped %d after %d\n", *popped, previous );
+        previous = *popped;
+        free( popped );
+    }
+
+    pqFree( pq );
+}
+
+/* Functions for use in testing */
+int *mallocInt( int a ) {
+    int *newInt = (int *) malloc( sizeof(int) );
+    *newInt = a;
+
+    return newInt;
+}
+
+int comparisonFunction( void *aPtr, void *bPtr) {
+    int a = *((int *) aPtr);
+    int b = *((int *) bPtr);
+
+    if( a < b ) {
+        return -1;
+    } else if( a == b ) {
+        return 0;
+    } else {
+        return 1;
+    }
+}
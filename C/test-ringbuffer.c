@@ -0,0 +1,267 @@
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "utils.h"
+#include "ringbuffer.h"
+
+/* Test functions prototypes */
+void testBufferCreation();
+void testFifoOrdering( RingBufferMode mode );
+void testBatches( RingBufferMode mode );
+void testSpscThreads();
+void testMpmcThreads();
+
+/* Shared state for the threaded tests */
+typedef struct TransferContext {
+    RingBuffer *ringBuffer;
+    long *values;
+    long nextValue;
+    long consumed;
+    long sum;
+} TransferContext;
+
+/* Functions used in testing */
+void *spscProducer( void *argument );
+void *mpmcProducer( void *argument );
+void *mpmcConsumer( void *argument );
+int *mallocInt( int a );
+
+#define NUM_TRANSFERS 1000000
+#define NUM_THREADS 4
+
+int main( int argc, char *argv[] ) {
+    setDebuggingLevel( E_ERROR );
+
+    testBufferCreation();
+    testFifoOrdering( RING_BUFFER_SPSC );
+    testFifoOrdering( RING_BUFFER_MPMC );
+    testBatches( RING_BUFFER_SPSC );
+    testBatches( RING_BUFFER_MPMC );
+    testSpscThreads();
+    testMpmcThreads();
+
+    return 0;
+}
+
+void testBufferCreation() {
+    RingBuffer *ringBuffer = newRingBuffer( 100, RING_BUFFER_SPSC );
+
+    assertNotNull( ringBuffer, "The new ring buffer shouldn't be null!\n" );
+    assertTrue( ringBuffer->capacity == 128, "Capacity should be rounded to 128, was %lu\n",
+            ringBuffer->capacity );
+    assertTrue( ringBufferSize( ringBuffer ) == 0, "The new ring buffer should be empty!\n" );
+    assertNull( ringBufferDequeue( ringBuffer ), "Dequeueing an empty buffer should return NULL!\n" );
+    assertFalse( ringBufferEnqueue( ringBuffer, NULL ), "NULL shouldn't be enqueued!\n" );
+    assertNull( newRingBuffer( 0, RING_BUFFER_MPMC ), "A zero capacity buffer should be NULL!\n" );
+
+    ringBufferFree( ringBuffer );
+}
+
+void testFifoOrdering( RingBufferMode mode ) {
+    RingBuffer *ringBuffer = newRingBuffer( 16, mode );
+
+    // Wrap around the buffer several times, filling it completely each time
+    for( int lap = 0; lap < 5; lap++ ) {
+        for( int i = 0; i < 16; i++ ) {
+            assertTrue( ringBufferEnqueue( ringBuffer, mallocInt(i) ), "Enqueue %d failed!\n", i );
+        }
+
+        int *extra = mallocInt( 16 );
+        assertFalse( ringBufferEnqueue( ringBuffer, extra ), "A full buffer should reject elements!\n" );
+        free( extra );
+        assertTrue( ringBufferSize( ringBuffer ) == 16, "Size should be 16, was %d\n",
+                ringBufferSize( ringBuffer ) );
+
+        for( int i = 0; i < 16; i++ ) {
+            int *dequeued = ringBufferDequeue( ringBuffer );
+            assertTrue( dequeued != NULL && *dequeued == i, "Dequeued the wrong element!\n" );
+            free( dequeued );
+        }
+
+        assertNull( ringBufferDequeue( ringBuffer ), "The buffer should be empty!\n" );
+    }
+
+    // Leave some elements behind for ringBufferFree
+    ringBufferEnqueue( ringBuffer, mallocInt(1) );
+    ringBufferEnqueue( ringBuffer, mallocInt(2) );
+    ringBufferFree( ringBuffer );
+}
+
+void testBatches( RingBufferMode mode ) {
+    RingBuffer *ringBuffer = newRingBuffer( 8, mode );
+    int values[12];
+    void *elements[12];
+
+    for( int i = 0; i < 12; i++ ) {
+        values[i] = i;
+        elements[i] = &values[i];
+    }
+
+    // Only a prefix of the batch fits
+    int added = ringBufferEnqueueBatch( ringBuffer, elements, 12 );
+    assertTrue( added == 8, "Batch enqueue should add 8 elements, added %d\n", added );
+
+    void *dequeued[12];
+    int removed = ringBufferDequeueBatch( ringBuffer, dequeued, 5 );
+    assertTrue( removed == 5, "Batch dequeue should remove 5 elements, removed %d\n", removed );
+
+    added = ringBufferEnqueueBatch( ringBuffer, elements + 8, 4 );
+    assertTrue( added == 4, "Batch enqueue should add 4 elements, added %d\n", added );
+
+    removed += ringBufferDequeueBatch( ringBuffer, dequeued + removed, 12 - removed );
+    assertTrue( removed == 12, "Should have removed 12 elements, removed %d\n", removed );
+
+    for( int i = 0; i < 12; i++ ) {
+        assertTrue( *(int *)dequeued[i] == i, "Element %d was %d\n", i, *(int *)dequeued[i] );
+    }
+
+    // Counts that aren't positive move nothing, rather than being read as huge unsigned counts
+    assertTrue( ringBufferEnqueueBatch( ringBuffer, elements, -1 ) == 0,
+            "A negative batch shouldn't add anything!\n" );
+    assertTrue( ringBufferEnqueueBatch( ringBuffer, elements, 0 ) == 0,
+            "An empty batch shouldn't add anything!\n" );
+    assertTrue( ringBufferSize( ringBuffer ) == 0, "The buffer should still be empty!\n" );
+
+    ringBufferEnqueueBatch( ringBuffer, elements, 2 );
+    assertTrue( ringBufferDequeueBatch( ringBuffer, dequeued, -1 ) == 0,
+            "A negative batch shouldn't remove anything!\n" );
+    assertTrue( ringBufferSize( ringBuffer ) == 2, "Both elements should still be queued!\n" );
+
+    ringBufferFreeStructure( ringBuffer );
+}
+
+void testSpscThreads() {
+    TransferContext context;
+    context.ringBuffer = newRingBuffer( 1024, RING_BUFFER_SPSC );
+    context.values = malloc( sizeof(long) * NUM_TRANSFERS );
+    pthread_t producer;
+
+    for( long i = 0; i < NUM_TRANSFERS; i++ ) {
+        context.values[i] = i;
+    }
+
+    pthread_create( &producer, NULL, spscProducer, &context );
+
+    // The consumer should see every element exactly once, in order
+    long expected = 0;
+    void *batch[64];
+    while( expected < NUM_TRANSFERS ) {
+        int removed = ringBufferDequeueBatch( context.ringBuffer, batch, 64 );
+        if( removed == 0 ) {
+            sched_yield();
+        }
+
+        for( int i = 0; i < removed; i++ ) {
+            long value = *(long *) batch[i];
+            assertTrue( value == expected, "Expected %ld, dequeued %ld\n", expected, value );
+            expected = value + 1;
+        }
+    }
+
+    pthread_join( producer, NULL );
+    ringBufferFreeStructure( context.ringBuffer );
+    free( context.values );
+}
+
+void testMpmcThreads() {
+    TransferContext context;
+    context.ringBuffer = newRingBuffer( 256, RING_BUFFER_MPMC );
+    context.values = malloc( sizeof(long) * NUM_TRANSFERS );
+    context.nextValue = 0;
+    context.consumed = 0;
+    context.sum = 0;
+    pthread_t producers[ NUM_THREADS ];
+    pthread_t consumers[ NUM_THREADS ];
+
+    for( long i = 0; i < NUM_TRANSFERS; i++ ) {
+        context.values[i] = i;
+    }
+
+    for( int i = 0; i < NUM_THREADS; i++ ) {
+        pthread_create( &producers[i], NULL, mpmcProducer, &context );
+        pthread_create( &consumers[i], NULL, mpmcConsumer, &context );
+    }
+
+    for( int i = 0; i < NUM_THREADS; i++ ) {
+        pthread_join( producers[i], NULL );
+        pthread_join( consumers[i], NULL );
+    }
+
+    // Every element should have been consumed exactly once
+    long expectedSum = (long) NUM_TRANSFERS * (NUM_TRANSFERS - 1) / 2;
+    assertTrue( context.consumed == NUM_TRANSFERS, "Consumed %ld elements, expected %d\n",
+            context.consumed, NUM_TRANSFERS );
+    assertTrue( context.sum == expectedSum, "Sum was %ld, expected %ld\n", context.sum, expectedSum );
+    assertTrue( ringBufferSize( context.ringBuffer ) == 0, "The buffer should be empty!\n" );
+
+    ringBufferFreeStructure( context.ringBuffer );
+    free( context.values );
+}
+
+/* Functions used in testing */
+void *spscProducer( void *argument ) {
+    TransferContext *context = argument;
+    long sent = 0;
+    void *batch[64];
+
+    while( sent < NUM_TRANSFERS ) {
+        int batchSize = 0;
+        while( batchSize < 64 && sent + batchSize < NUM_TRANSFERS ) {
+            batch[batchSize] = &context->values[ sent + batchSize ];
+            batchSize++;
+        }
+
+        int added = ringBufferEnqueueBatch( context->ringBuffer, batch, batchSize );
+        if( added == 0 ) {
+            sched_yield();
+        }
+
+        sent += added;
+    }
+
+    return NULL;
+}
+
+void *mpmcProducer( void *argument ) {
+    TransferContext *context = argument;
+    long index;
+
+    while( (index = __atomic_fetch_add( &context->nextValue, 1, __ATOMIC_RELAXED )) < NUM_TRANSFERS ) {
+        while( ! ringBufferEnqueue( context->ringBuffer, &context->values[index] ) ) {
+            // Wait until a consumer makes room
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+void *mpmcConsumer( void *argument ) {
+    TransferContext *context = argument;
+    long sum = 0;
+    void *batch[16];
+
+    while( __atomic_load_n( &context->consumed, __ATOMIC_RELAXED ) < NUM_TRANSFERS ) {
+        int removed = ringBufferDequeueBatch( context->ringBuffer, batch, 16 );
+        if( removed == 0 ) {
+            sched_yield();
+        }
+
+        for( int i = 0; i < removed; i++ ) {
+            sum += *(long *) batch[i];
+        }
+
+        __atomic_fetch_add( &context->consumed, removed, __ATOMIC_RELAXED );
+    }
+
+    __atomic_fetch_add( &context->sum, sum, __ATOMIC_RELAXED );
+    return NULL;
+}
+
+int *mallocInt( int a ) {
+    int *newInt = (int *) malloc( sizeof(int) );
+    *newInt = a;
+
+    return newInt;
+}
@@ -10,15 +10,36 @@ void testSetAdd();
 void testSetRemove();
 void testIsInSet();
 void testSetUnion();
+void testSetUnionMany();
 void testSetIntersect();
 void testSetMapping();
+void testSetDifference();
+void testSetSymmetricDifference();
+void testSetIsSubset();
+void testSetEquals();
+void testBloomFilter();
+void testSetFingerprint();
+void testFrozenSet();
+void testParallelForEach();
+void testParallelMapping();
+void testParallelSetAlgebra();
+void testBTreeBackend();
+void testSplayBackend();
 
 /* Functions used in testing */
 int *mallocInt( int a );
 int *increment(int *x);
+int *halve( int *x );
+Set *rangeSet( int start, int end );
+Set *valueSet( int *values, SetBackend backend, int start, int end );
+unsigned long hashInt( int *x );
+void addToTotal( int *number );
 int comparisonFunction( int *aPtr, int *bPtr);
 void printInt( int *number );
 
+/* Sum of the elements visited by addToTotal */
+long total = 0;
+
 int main( int argc, char *argv[] ) {
     setDebuggingLevel( E_ERROR );
     srand( time(NULL) );
@@ -28,7 +49,20 @@ int main( int argc, char *argv[] ) {
     testIsInSet();
     testSetMapping();
     testSetUnion();
+    testSetUnionMany();
     testSetIntersect();
+    testSetDifference();
+    testSetSymmetricDifference();
+    testSetIsSubset();
+    testSetEquals();
+    testBloomFilter();
+    testSetFingerprint();
+    testFrozenSet();
+    testParallelForEach();
+    testParallelMapping();
+    testParallelSetAlgebra();
+    testBTreeBackend();
+    testSplayBackend();
 }
 
 void testNewSet() {
@@ -158,6 +192,66 @@ void testSetUnion() {
     setFree( unionResult );
 }
 
+void testSetUnionMany() {
+    const int numSets = 30;
+    Set *sets[ numSets ];
+
+    // Overlapping ranges, with an empty set and a B-tree set mixed in
+    for( int i = 0; i < numSets; i++ ) {
+        sets[i] = rangeSet( i * 10, i * 10 + 25 );
+    }
+
+    setFree( sets[5] );
+    sets[5] = newSet( (ComparisonFunction) comparisonFunction );
+    setFree( sets[9] );
+    sets[9] = newSetWithBackend( (ComparisonFunction) comparisonFunction, SET_BACKEND_BTREE );
+    for( int i = 90; i < 115; i++ ) {
+        setAdd( sets[9], mallocInt(i) );
+    }
+
+    Set *unionResult = setUnionMany( sets, numSets );
+
+    // Chaining pairwise unions gives the same set
+    Set *chained = setUnion( sets[0], sets[1], NULL );
+    for( int i = 2; i < numSets; i++ ) {
+        Set *next = setUnion( chained, sets[i], NULL );
+        setFreeStructure( chained );
+        chained = next;
+    }
+
+    assertTrue( setEquals(unionResult, chained),
+            "The merged union should match the chained one!\n" );
+
+    // Elements in several sets come from the earliest one
+    int *fifteen = mallocInt(15);
+    int *found = bstFind( unionResult->elements, fifteen );
+    assertTrue( found == bstFind( sets[0]->elements, fifteen ), "15 should come from set 0!\n" );
+    free( fifteen );
+
+    // The result is in order with no duplicates
+    int expected = 0;
+    SetIterator iterator;
+    setIteratorInit( &iterator, unionResult );
+    for( int *element; (element = setIteratorNext( &iterator )) != NULL; expected++ ) {
+        assertTrue( *element == expected, "Expected %d in the union, found %d!\n", expected,
+                *element );
+    }
+
+    assertTrue( unionResult->size == expected, "Union size should be %d, was %d!\n", expected,
+            unionResult->size );
+
+    Set *single = setUnionMany( sets, 1 );
+    assertTrue( setEquals(single, sets[0]), "The union of one set should equal it!\n" );
+    assertNull( setUnionMany( sets, 0 ), "The union of no sets should be NULL!\n" );
+
+    setFreeStructure( single );
+    setFreeStructure( chained );
+    setFreeStructure( unionResult );
+    for( int i = 0; i < numSets; i++ ) {
+        setFree( sets[i] );
+    }
+}
+
 void testSetIntersect() {
     // Testing bounds
     const int firstStart = 0;
@@ -191,6 +285,207 @@ void testSetIntersect() {
     setFree( second );
 }
 
+void testSetDifference() {
+    Set *first = rangeSet( 0, 30 );
+    Set *second = rangeSet( 10, 40 );
+
+    Set *differenceResult = setDifference( first, second, NULL );
+    assertTrue( differenceResult->size == 10, "Difference size should be 10, was %d\n",
+            differenceResult->size );
+
+    for( int i = 0; i < 40; i++ ) {
+        int *element = mallocInt(i);
+        assertTrue( isInSet(differenceResult, element) == (i < 10),
+                "Difference membership of %d is wrong!\n", i );
+        free( element );
+    }
+
+    // Removing a set from itself leaves nothing
+    Set *emptyResult = setDifference( first, first, NULL );
+    assertTrue( emptyResult->size == 0, "Difference with itself should be empty!\n" );
+
+    setFreeStructure( differenceResult );
+    setFreeStructure( emptyResult );
+    setFree( first );
+    setFree( second );
+}
+
+void testSetSymmetricDifference() {
+    Set *first = rangeSet( 0, 30 );
+    Set *second = rangeSet( 10, 40 );
+
+    Set *result = setSymmetricDifference( first, second, NULL );
+    assertTrue( result->size == 20, "Symmetric difference size should be 20, was %d\n",
+            result->size );
+
+    for( int i = 0; i < 40; i++ ) {
+        int *element = mallocInt(i);
+        assertTrue( isInSet(result, element) == (i < 10 || i >= 30),
+                "Symmetric difference membership of %d is wrong!\n", i );
+        free( element );
+    }
+
+    setFreeStructure( result );
+    setFree( first );
+    setFree( second );
+}
+
+void testSetIsSubset() {
+    Set *full = rangeSet( 0, 50 );
+    Set *middle = rangeSet( 10, 20 );
+    Set *overlapping = rangeSet( 40, 60 );
+    Set *empty = newSet( (ComparisonFunction) comparisonFunction );
+
+    assertTrue( setIsSubset(middle, full), "The middle should be a subset of the full set!\n" );
+    assertTrue( setIsSubset(full, full), "A set should be a subset of itself!\n" );
+    assertTrue( setIsSubset(empty, full), "The empty set should be a subset of any set!\n" );
+    assertFalse( setIsSubset(full, middle), "The full set is larger than the middle!\n" );
+    assertFalse( setIsSubset(overlapping, full), "The overlapping set goes past the full set!\n" );
+    assertFalse( setIsSubset(middle, overlapping), "The middle and overlapping sets differ!\n" );
+
+    setFree( full );
+    setFree( middle );
+    setFree( overlapping );
+    setFree( empty );
+}
+
+void testSetEquals() {
+    Set *first = rangeSet( 0, 50 );
+    Set *second = rangeSet( 0, 50 );
+    Set *shifted = rangeSet( 1, 51 );
+    Set *shorter = rangeSet( 0, 49 );
+
+    assertTrue( setEquals(first, second), "Sets with the same elements should be equal!\n" );
+    assertFalse( setEquals(first, shifted), "Shifted sets should not be equal!\n" );
+    assertFalse( setEquals(first, shorter), "Sets of different sizes should not be equal!\n" );
+
+    setFree( first );
+    setFree( second );
+    setFree( shifted );
+    setFree( shorter );
+}
+
+void testBloomFilter() {
+    Set *set = rangeSet( 0, 100 );
+    setEnableBloomFilter( set, (HashFunction) hashInt );
+
+    // Existing elements are added to the filter when it is enabled
+    for( int i = 0; i < 100; i++ ) {
+        int *element = mallocInt(i);
+        assertTrue( isInSet(set, element), "Couldn't find %d after enabling the filter!\n", i );
+        free( element );
+    }
+
+    // New elements are added to the filter as they are added to the set
+    for( int i = 100; i < 1000; i++ ) {
+        setAdd( set, mallocInt(i) );
+    }
+
+    for( int i = 0; i < 2000; i++ ) {
+        int *element = mallocInt(i);
+        assertTrue( isInSet(set, element) == (i < 1000), "Membership of %d is wrong!\n", i );
+        free( element );
+    }
+
+    // Duplicates are still rejected when the filter is enabled
+    int *duplicate = mallocInt(500);
+    setAdd( set, duplicate );
+    assertTrue( set->size == 1000, "Set size should be 1000, was %d\n", set->size );
+    free( duplicate );
+
+    // Removing most of the set causes the filter to be rebuilt
+    for( int i = 0; i < 900; i++ ) {
+        int *element = mallocInt(i);
+        setRemove( set, element );
+        free( element );
+    }
+
+    for( int i = 0; i < 1000; i++ ) {
+        int *element = mallocInt(i);
+        assertTrue( isInSet(set, element) == (i >= 900), "Membership of %d is wrong!\n", i );
+        free( element );
+    }
+
+    assertTrue( set->removalsSinceRebuild == 0, "The filter should have been rebuilt!\n" );
+
+    setFree( set );
+}
+
+void testSetFingerprint() {
+    Set *set = rangeSet( 0, 100 );
+    Set *same = newSetWithBackend( (ComparisonFunction) comparisonFunction, SET_BACKEND_BTREE );
+    for( int i = 99; i >= 0; i-- ) {
+        setAdd( same, mallocInt(i) );
+    }
+
+    assertTrue( setFingerprint(set) == 0, "A set without a fingerprint should report 0!\n" );
+
+    // Equal sets have equal fingerprints, however their elements were inserted or stored
+    setEnableFingerprint( set, (HashFunction) hashInt );
+    setEnableFingerprint( same, (HashFunction) hashInt );
+    unsigned long original = setFingerprint( set );
+    assertTrue( original == setFingerprint(same), "Equal sets should have equal fingerprints!\n" );
+    assertTrue( setEquals(set, same), "The sets should be equal!\n" );
+
+    // Changes to the set show up in its fingerprint, and undoing them restores it
+    int *element = mallocInt(100);
+    setAdd( set, element );
+    assertTrue( setFingerprint(set) != original, "Adding 100 should change the fingerprint!\n" );
+
+    int *duplicate = mallocInt(100);
+    unsigned long withHundred = setFingerprint( set );
+    setAdd( set, duplicate );
+    assertTrue( setFingerprint(set) == withHundred, "A duplicate shouldn't change it!\n" );
+
+    setRemove( set, duplicate );
+    assertTrue( setFingerprint(set) == original, "Removing 100 should restore the fingerprint!\n" );
+
+    // Unequal sets of the same size are told apart by their fingerprints
+    *duplicate = 0;
+    setRemove( same, duplicate );
+    setAdd( same, mallocInt(100) );
+    assertTrue( set->size == same->size, "The sets should be the same size!\n" );
+    assertTrue( setFingerprint(set) != setFingerprint(same), "The fingerprints should differ!\n" );
+    assertFalse( setEquals(set, same), "The sets should not be equal!\n" );
+
+    // Sets without comparable fingerprints are still compared element by element
+    Set *plain = rangeSet( 0, 100 );
+    assertTrue( setEquals(set, plain), "A set should equal an unfingerprinted copy!\n" );
+    assertFalse( setEquals(same, plain), "The sets should not be equal!\n" );
+
+    free( duplicate );
+    setFree( plain );
+    setFree( same );
+    setFree( set );
+}
+
+void testFrozenSet() {
+    Set *set = rangeSet( 0, 100 );
+    setEnableBloomFilter( set, (HashFunction) hashInt );
+    setFreeze( set );
+
+    for( int i = -10; i < 110; i++ ) {
+        int *element = mallocInt(i);
+        assertTrue( isInSet(set, element) == (i >= 0 && i < 100), "Membership of %d is wrong!\n",
+                i );
+        free( element );
+    }
+
+    // Frozen sets reject modifications
+    int *element = mallocInt(200);
+    setAdd( set, element );
+    assertFalse( isInSet(set, element), "Elements shouldn't be added to a frozen set!\n" );
+    free( element );
+
+    element = mallocInt(50);
+    setRemove( set, element );
+    assertTrue( isInSet(set, element), "Elements shouldn't be removed from a frozen set!\n" );
+    assertTrue( set->size == 100, "Frozen set size should be 100, was %d\n", set->size );
+    free( element );
+
+    setFree( set );
+}
+
 void testSetMapping() {
     Set *set = newSet( (ComparisonFunction) comparisonFunction);
     const int numElements = 50;
@@ -218,6 +513,244 @@ void testSetMapping() {
     setFree( set );
 }
 
+void testParallelForEach() {
+    Set *set = newSet( (ComparisonFunction) comparisonFunction);
+    const int numElements = 10000;
+
+    for( int i = 0; i < numElements; i++ ) {
+        setAdd( set, mallocInt(i) );
+    }
+
+    total = 0;
+    setParallelForEach( set, (ElementConsumer) addToTotal );
+
+    long expectedTotal = (long) numElements * (numElements - 1) / 2;
+    assertTrue( total == expectedTotal, "Total should be %ld, was %ld\n", expectedTotal, total );
+
+    setFree( set );
+}
+
+void testParallelMapping() {
+    Set *set = newSet( (ComparisonFunction) comparisonFunction);
+    const int numElements = 10000;
+
+    for( int i = 0; i < numElements; i++ ) {
+        setAdd( set, mallocInt(i) );
+    }
+
+    // Map increment over the set
+    Set *mapResult = setParallelMap( set, (MapFunction) increment, NULL );
+    assertTrue( mapResult->size == numElements, "Map result size should be %d, was %d\n",
+            numElements, mapResult->size );
+
+    for( int i = 1; i <= numElements; i++ ) {
+        int *elementToFind = mallocInt(i);
+        assertTrue( isInSet(mapResult, elementToFind), "%d should be in the map result!\n", i );
+        free( elementToFind );
+    }
+
+    // Halving maps pairs of elements to the same value, so duplicates must be dropped
+    Set *halvedResult = setParallelMap( set, (MapFunction) halve, NULL );
+    assertTrue( halvedResult->size == numElements / 2, "Halved result size should be %d, was %d\n",
+            numElements / 2, halvedResult->size );
+
+    for( int i = 0; i < numElements / 2; i++ ) {
+        int *elementToFind = mallocInt(i);
+        assertTrue( isInSet(halvedResult, elementToFind), "%d should be in the halved result!\n",
+                i );
+        free( elementToFind );
+    }
+
+    setFree( halvedResult );
+    setFree( mapResult );
+    setFree( set );
+}
+
+void testParallelSetAlgebra() {
+    const int numElements = 5000;
+    const int numSorted = 100000;
+    int *values = malloc( sizeof(int) * 2 * numSorted );
+
+    // The operations consume their sets and drop elements without freeing them, so the sets hold
+    // pointers into one array rather than elements of their own
+    for( int i = 0; i < 2 * numSorted; i++ ) {
+        values[i] = i;
+    }
+
+    // The first set holds [0, numElements) and the second is the same range shifted by half
+    Set *first = valueSet( values, SET_BACKEND_BST, 0, numElements );
+    Set *second = valueSet( values, SET_BACKEND_BST, numElements / 2, numElements * 3 / 2 );
+    assertTrue( first->elements->treap && second->elements->treap,
+            "Tree-backed sets should be treaps!\n" );
+
+    Set *unionResult = setParallelUnion( first, second );
+    Set *intersectionResult = setParallelIntersect(
+            valueSet( values, SET_BACKEND_BST, 0, numElements ),
+            valueSet( values, SET_BACKEND_BST, numElements / 2, numElements * 3 / 2 ) );
+    Set *differenceResult = setParallelDifference(
+            valueSet( values, SET_BACKEND_BST, 0, numElements ),
+            valueSet( values, SET_BACKEND_BST, numElements / 2, numElements * 3 / 2 ) );
+
+    assertTrue( unionResult->size == numElements * 3 / 2, "Union size should be %d, was %d\n",
+            numElements * 3 / 2, unionResult->size );
+    assertTrue( intersectionResult->size == numElements / 2,
+            "Intersection size should be %d, was %d\n", numElements / 2, intersectionResult->size );
+    assertTrue( differenceResult->size == numElements / 2,
+            "Difference size should be %d, was %d\n", numElements / 2, differenceResult->size );
+
+    for( int i = 0; i < 2 * numElements; i++ ) {
+        int *element = mallocInt(i);
+        int inFirst = i < numElements;
+        int inSecond = i >= numElements / 2 && i < numElements * 3 / 2;
+
+        assertTrue( isInSet(unionResult, element) == (inFirst || inSecond),
+                "Union membership of %d is wrong!\n", i );
+        assertTrue( isInSet(intersectionResult, element) == (inFirst && inSecond),
+                "Intersection membership of %d is wrong!\n", i );
+        assertTrue( isInSet(differenceResult, element) == (inFirst && ! inSecond),
+                "Difference membership of %d is wrong!\n", i );
+        free( element );
+    }
+
+    setFreeStructure( unionResult );
+    setFreeStructure( intersectionResult );
+    setFreeStructure( differenceResult );
+
+    // Ascending inserts leave a splay tree as a vine, too deep to walk once per level
+    unionResult = setParallelUnion( valueSet( values, SET_BACKEND_SPLAY, 0, numSorted ),
+            valueSet( values, SET_BACKEND_SPLAY, numSorted / 2, numSorted * 3 / 2 ) );
+    intersectionResult = setParallelIntersect( valueSet( values, SET_BACKEND_SPLAY, 0, numSorted ),
+            valueSet( values, SET_BACKEND_SPLAY, numSorted / 2, numSorted * 3 / 2 ) );
+    differenceResult = setParallelDifference( valueSet( values, SET_BACKEND_SPLAY, 0, numSorted ),
+            valueSet( values, SET_BACKEND_SPLAY, numSorted / 2, numSorted * 3 / 2 ) );
+
+    assertTrue( unionResult->size == numSorted * 3 / 2 && intersectionResult->size == numSorted / 2
+            && differenceResult->size == numSorted / 2,
+            "Sizes should be %d, %d and %d, were %d, %d and %d\n", numSorted * 3 / 2,
+            numSorted / 2, numSorted / 2, unionResult->size, intersectionResult->size,
+            differenceResult->size );
+    assertTrue( bstHeight( unionResult->elements ) < 100
+            && bstHeight( intersectionResult->elements ) < 100
+            && bstHeight( differenceResult->elements ) < 100,
+            "The results of operations on vines should be balanced!\n" );
+
+    setFreeStructure( unionResult );
+    setFreeStructure( intersectionResult );
+    setFreeStructure( differenceResult );
+    free( values );
+}
+
+Set *rangeSet( int start, int end ) {
+    Set *set = newSet( (ComparisonFunction) comparisonFunction );
+
+    // Insert from both ends so that the tree isn't a list
+    for( int low = start, high = end - 1; low <= high; low++, high-- ) {
+        setAdd( set, mallocInt(low) );
+        if( high != low ) {
+            setAdd( set, mallocInt(high) );
+        }
+    }
+
+    return set;
+}
+
+Set *valueSet( int *values, SetBackend backend, int start, int end ) {
+    Set *set = newSetWithBackend( (ComparisonFunction) comparisonFunction, backend );
+
+    for( int i = start; i < end; i++ ) {
+        setAdd( set, &values[i] );
+    }
+
+    return set;
+}
+
+void testBTreeBackend() {
+    Set *set = newSetWithBackend( (ComparisonFunction) comparisonFunction, SET_BACKEND_BTREE );
+    int numElements = 500;
+
+    for( int i = numElements - 1; i >= 0; i-- ) {
+        setAdd( set, mallocInt(i) );
+    }
+
+    // Duplicates are rejected by the B-tree itself
+    int *duplicate = mallocInt(7);
+    setAdd( set, duplicate );
+    assertTrue( set->size == numElements, "B-tree set size should be %d, was %d\n", numElements,
+            set->size );
+    free( duplicate );
+
+    for( int i = 0; i < numElements; i += 2 ) {
+        int *element = mallocInt(i);
+        setRemove( set, element );
+        free( element );
+    }
+
+    assertTrue( set->size == numElements / 2, "B-tree set size should be %d, was %d\n",
+            numElements / 2, set->size );
+
+    for( int i = -1; i <= numElements; i++ ) {
+        int *element = mallocInt(i);
+        assertTrue( isInSet(set, element) == (i >= 0 && i < numElements && i % 2 == 1),
+                "B-tree membership of %d is wrong!\n", i );
+        free( element );
+    }
+
+    // Operations mix freely with tree-backed sets and keep the first set's backend
+    Set *range = rangeSet( 0, numElements );
+    Set *difference = setDifference( range, set, NULL );
+    Set *odd = setDifference( set, difference, NULL );
+    assertTrue( odd->backend == SET_BACKEND_BTREE, "The difference should be B-tree backed!\n" );
+    assertTrue( setEquals(odd, set), "Removing the even numbers should leave the odd ones!\n" );
+    assertTrue( setIsSubset(set, range), "The odd numbers should be a subset of the range!\n" );
+    assertFalse( setEquals(set, range), "The odd numbers should not equal the range!\n" );
+
+    // The parallel union consumes both halves, so it is given the B-tree backed copy of the set
+    Set *unionResult = setParallelUnion( odd, difference );
+    assertTrue( setEquals(unionResult, range), "The halves should join back into the range!\n" );
+
+    setEnableBloomFilter( set, (HashFunction) hashInt );
+    setFreeze( set );
+    for( int i = 0; i < numElements; i++ ) {
+        int *element = mallocInt(i);
+        assertTrue( isInSet(set, element) == (i % 2 == 1),
+                "Frozen B-tree membership of %d is wrong!\n", i );
+        free( element );
+    }
+
+    setFreeStructure( unionResult );
+    setFree( range );
+    setFree( set );
+}
+
+void testSplayBackend() {
+    Set *set = newSetWithBackend( (ComparisonFunction) comparisonFunction, SET_BACKEND_SPLAY );
+
+    for( int i = 0; i < 100; i++ ) {
+        setAdd( set, mallocInt(i) );
+    }
+
+    assertTrue( set->size == 100, "Splay set size should be 100, was %d\n", set->size );
+
+    // Repeated lookups of a hot element leave it at the root
+    int *hot = mallocInt(42);
+    for( int i = 0; i < 3; i++ ) {
+        assertTrue( isInSet(set, hot), "42 should be in the splay set!\n" );
+    }
+
+    assertTrue( *(int *) set->elements->root->data == 42, "42 should be at the root!\n" );
+    free( hot );
+
+    Set *range = rangeSet( 50, 150 );
+    Set *difference = setDifference( set, range, NULL );
+    assertTrue( difference->backend == SET_BACKEND_SPLAY, "The difference should splay!\n" );
+    assertTrue( difference->size == 50, "Difference size should be 50, was %d\n",
+            difference->size );
+
+    setFreeStructure( difference );
+    setFree( range );
+    setFree( set );
+}
+
 int *mallocInt( int a ) {
     int *newInt = (int *) malloc( sizeof(int) );
     *newInt = a;
@@ -244,6 +777,20 @@ int *increment(int *x) {
     return result;
 }
 
+int *halve( int *x ) {
+    int *result = malloc( sizeof(int) );
+    *result = (*x) / 2;
+    return result;
+}
+
+void addToTotal( int *number ) {
+    __atomic_add_fetch( &total, *number, __ATOMIC_RELAXED );
+}
+
+unsigned long hashInt( int *x ) {
+    return (unsigned long) *x;
+}
+
 void printInt( int *number ) {
     printf( "%d ", *number );
 }
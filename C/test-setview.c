@@ -0,0 +1,280 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "utils.h"
+#include "setview.h"
+
+/* Test function prototypes */
+void testSingleSetView();
+void testUnionView();
+void testIntersectionView();
+void testDifferenceView();
+void testNestedViews();
+void testEmptyViews();
+void testLargestView();
+
+/* Functions used in testing */
+int comparisonFunction( void *aPtr, void *bPtr );
+int *mallocInt( int a );
+Set *multiplesSet( int factor, int limit, SetBackend backend );
+void checkView( SetView *view, bool (*expected)( int ), int limit );
+bool inUnion( int value );
+bool inIntersection( int value );
+bool inDifference( int value );
+bool inNested( int value );
+void addToTotal( void *element );
+
+/* Sum of the elements visited by addToTotal */
+long total = 0;
+
+/* Every test set holds the multiples of some number below this */
+const int valueLimit = 600;
+
+int main( int argc, char *argv[] ) {
+    setDebuggingLevel( E_ERROR );
+    srand( time(NULL) );
+
+    testSingleSetView();
+    testUnionView();
+    testIntersectionView();
+    testDifferenceView();
+    testNestedViews();
+    testEmptyViews();
+    testLargestView();
+
+    return 0;
+}
+
+void testSingleSetView() {
+    Set *set = multiplesSet( 3, valueLimit, SET_BACKEND_BST );
+    SetView *view = newSetView( set );
+
+    assertTrue( setViewCount( view ) == set->size, "The view should have %d elements, had %d!\n",
+            set->size, setViewCount( view ) );
+
+    // The view hands out the set's own elements rather than copies
+    SetIterator setIterator;
+    SetViewIterator viewIterator;
+    void *element;
+
+    setIteratorInit( &setIterator, set );
+    setViewIteratorInit( &viewIterator, view );
+    while( (element = setIteratorNext( &setIterator )) != NULL ) {
+        assertTrue( setViewIteratorNext( &viewIterator ) == element,
+                "The view should return the set's elements!\n" );
+    }
+
+    assertNull( setViewIteratorNext( &viewIterator ), "The view should be exhausted!\n" );
+
+    total = 0;
+    setViewForEach( view, addToTotal );
+    assertTrue( total == 3L * 199 * 200 / 2, "The elements should sum to %ld, was %ld!\n",
+            3L * 199 * 200 / 2, total );
+
+    setViewFree( view );
+    setFree( set );
+}
+
+void testUnionView() {
+    Set *twos = multiplesSet( 2, valueLimit, SET_BACKEND_BST );
+    Set *threes = multiplesSet( 3, valueLimit, SET_BACKEND_BTREE );
+    SetView *view = setViewUnion( newSetView( twos ), newSetView( threes ) );
+
+    checkView( view, inUnion, valueLimit );
+
+    // Elements in both sets are returned once, from the first set
+    int *six = mallocInt( 6 );
+    SetViewIterator iterator;
+    void *element;
+
+    setViewIteratorInit( &iterator, view );
+    while( (element = setViewIteratorNext( &iterator )) != NULL ) {
+        if( comparisonFunction( element, six ) == 0 ) {
+            assertTrue( isInSet( twos, element ), "Six should come from the first set!\n" );
+        }
+    }
+
+    free( six );
+    setViewFree( view );
+    setFree( twos );
+    setFree( threes );
+}
+
+void testIntersectionView() {
+    Set *twos = multiplesSet( 2, valueLimit, SET_BACKEND_BST );
+    Set *threes = multiplesSet( 3, valueLimit, SET_BACKEND_SPLAY );
+    SetView *view = setViewIntersect( newSetView( twos ), newSetView( threes ) );
+
+    checkView( view, inIntersection, valueLimit );
+
+    // The view matches the materialized intersection
+    Set *intersection = setIntersect( twos, threes, NULL );
+    assertTrue( setViewCount( view ) == intersection->size,
+            "The view should have %d elements, had %d!\n", intersection->size,
+            setViewCount( view ) );
+
+    setFreeStructure( intersection );
+    setViewFree( view );
+    setFree( twos );
+    setFree( threes );
+}
+
+void testDifferenceView() {
+    Set *twos = multiplesSet( 2, valueLimit, SET_BACKEND_BTREE );
+    Set *threes = multiplesSet( 3, valueLimit, SET_BACKEND_BST );
+    SetView *view = setViewDifference( newSetView( twos ), newSetView( threes ) );
+
+    checkView( view, inDifference, valueLimit );
+
+    setViewFree( view );
+    setFree( twos );
+    setFree( threes );
+}
+
+void testNestedViews() {
+    Set *twos = multiplesSet( 2, valueLimit, SET_BACKEND_BST );
+    Set *threes = multiplesSet( 3, valueLimit, SET_BACKEND_BST );
+    Set *fives = multiplesSet( 5, valueLimit, SET_BACKEND_BTREE );
+    Set *sevens = multiplesSet( 7, valueLimit, SET_BACKEND_BST );
+
+    // ((twos | threes) & fives) - sevens
+    SetView *view = setViewDifference(
+            setViewIntersect(
+                setViewUnion( newSetView( twos ), newSetView( threes ) ),
+                newSetView( fives ) ),
+            newSetView( sevens ) );
+
+    checkView( view, inNested, valueLimit );
+
+    setViewFree( view );
+    setFree( twos );
+    setFree( threes );
+    setFree( fives );
+    setFree( sevens );
+}
+
+void testEmptyViews() {
+    Set *empty = newSet( comparisonFunction );
+    Set *twos = multiplesSet( 2, valueLimit, SET_BACKEND_BST );
+
+    SetView *unionView = setViewUnion( newSetView( empty ), newSetView( twos ) );
+    SetView *intersectionView = setViewIntersect( newSetView( twos ), newSetView( empty ) );
+    SetView *differenceView = setViewDifference( newSetView( twos ), newSetView( empty ) );
+
+    assertTrue( setViewCount( unionView ) == twos->size, "Union with nothing changed the set!\n" );
+    assertTrue( setViewCount( intersectionView ) == 0, "Intersection with nothing isn't empty!\n" );
+    assertTrue( setViewCount( differenceView ) == twos->size,
+            "Removing nothing changed the set!\n" );
+
+    setViewFree( unionView );
+    setViewFree( intersectionView );
+    setViewFree( differenceView );
+    setFree( empty );
+    setFree( twos );
+}
+
+void testLargestView() {
+    Set *twos = multiplesSet( 2, valueLimit, SET_BACKEND_BST );
+    Set *threes = multiplesSet( 3, valueLimit, SET_BACKEND_BTREE );
+
+    // Alternately adding both sets leaves a view with every node it is allowed
+    SetView *view = newSetView( twos );
+    while( view->nodes + 2 <= SET_VIEW_MAX_NODES ) {
+        Set *next = view->nodes % 4 == 1 ? threes : twos;
+        view = setViewUnion( view, newSetView( next ) );
+    }
+
+    assertTrue( view->nodes == SET_VIEW_MAX_NODES - 1, "The view should have %d nodes, had %d!\n",
+            SET_VIEW_MAX_NODES - 1, view->nodes );
+    checkView( view, inUnion, valueLimit );
+
+    // A view that would need more cursors than an iterator holds is refused
+    SetView *single = newSetView( twos );
+    SetView *combined = setViewIntersect( view, single );
+    assertNull( combined, "The oversized view should be refused!\n" );
+
+    setViewFree( single );
+    setViewFree( view );
+    setFree( twos );
+    setFree( threes );
+}
+
+/* Functions for use in testing */
+int comparisonFunction( void *aPtr, void *bPtr ) {
+    int a = *((int *) aPtr);
+    int b = *((int *) bPtr);
+
+    if( a < b ) {
+        return -1;
+    } else if( a == b ) {
+        return 0;
+    } else {
+        return 1;
+    }
+}
+
+int *mallocInt( int a ) {
+    int *newInt = (int *) malloc( sizeof(int) );
+    *newInt = a;
+
+    return newInt;
+}
+
+Set *multiplesSet( int factor, int limit, SetBackend backend ) {
+    Set *set = newSetWithBackend( comparisonFunction, backend );
+
+    for( int i = 0; i < limit; i += factor ) {
+        setAdd( set, mallocInt( i ) );
+    }
+
+    return set;
+}
+
+/*
+ * Checks that a view's iteration returns exactly the values below the limit that the predicate
+ * accepts, in order, and that its membership tests agree.
+ */
+void checkView( SetView *view, bool (*expected)( int ), int limit ) {
+    SetViewIterator iterator;
+    int *probe = mallocInt( 0 );
+
+    setViewIteratorInit( &iterator, view );
+
+    for( int value = 0; value < limit; value++ ) {
+        *probe = value;
+
+        assertTrue( setViewContains( view, probe ) == expected( value ),
+                "%d has the wrong membership!\n", value );
+
+        if( expected( value ) ) {
+            int *element = setViewIteratorNext( &iterator );
+            assertTrue( element != NULL && *element == value, "The view should return %d next!\n",
+                    value );
+        }
+    }
+
+    assertNull( setViewIteratorNext( &iterator ), "The view returned too many elements!\n" );
+
+    free( probe );
+}
+
+bool inUnion( int value ) {
+    return value % 2 == 0 || value % 3 == 0;
+}
+
+bool inIntersection( int value ) {
+    return value % 2 == 0 && value % 3 == 0;
+}
+
+bool inDifference( int value ) {
+    return value % 2 == 0 && value % 3 != 0;
+}
+
+bool inNested( int value ) {
+    return inUnion( value ) && value % 5 == 0 && value % 7 != 0;
+}
+
+void addToTotal( void *element ) {
+    total += *(int *) element;
+}
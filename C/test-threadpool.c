@@ -0,0 +1,210 @@
+#include <stdlib.h>
+
+#include "utils.h"
+#include "threadpool.h"
+
+/* Test functions prototypes */
+void testPoolCreation();
+void testParallelFor();
+void testForkJoin();
+void testExternalSpawns();
+void testDefaultPool();
+void testParallelSort();
+
+/* Functions used in testing */
+typedef struct FibonacciTask {
+    ThreadPool *pool;
+    int n;
+    long result;
+} FibonacciTask;
+
+void squareRange( int start, int end, void *context );
+void fibonacciTask( void *argument );
+void incrementTask( void *argument );
+long fibonacci( int n );
+int comparisonFunction( void *aPtr, void *bPtr );
+
+int main( int argc, char *argv[] ) {
+    setDebuggingLevel( E_ERROR );
+
+    testPoolCreation();
+    testParallelFor();
+    testForkJoin();
+    testExternalSpawns();
+    testDefaultPool();
+    testParallelSort();
+
+    return 0;
+}
+
+void testPoolCreation() {
+    ThreadPool *pool = newThreadPool( 3 );
+
+    assertNotNull( pool, "The new pool shouldn't be null!\n" );
+    assertTrue( pool->numWorkers == 3, "Pool should have 3 workers, has %d\n", pool->numWorkers );
+
+    threadPoolFree( pool );
+
+    pool = newThreadPool( 0 );
+    assertTrue( pool->numWorkers >= 1, "Pool should have at least one worker!\n" );
+    threadPoolFree( pool );
+}
+
+void testParallelFor() {
+    ThreadPool *pool = newThreadPool( 4 );
+    const int numElements = 10000;
+    long *values = malloc( sizeof(long) * numElements );
+
+    for( int i = 0; i < numElements; i++ ) {
+        values[i] = i;
+    }
+
+    // Every index should be processed exactly once, with both explicit and automatic grain sizes
+    parallelFor( pool, 0, numElements, 1000, squareRange, values );
+    parallelFor( pool, 0, numElements, 0, squareRange, values );
+
+    for( int i = 0; i < numElements; i++ ) {
+        long expected = (long) i * i * i * i;
+        assertTrue( values[i] == expected, "values[%d] should be %ld, was %ld\n", i, expected,
+                values[i] );
+    }
+
+    // Empty ranges shouldn't call the function
+    parallelFor( pool, 10, 10, 1, squareRange, NULL );
+
+    free( values );
+    threadPoolFree( pool );
+}
+
+void testForkJoin() {
+    ThreadPool *pool = newThreadPool( 4 );
+
+    for( int n = 0; n <= 20; n += 5 ) {
+        FibonacciTask task = { pool, n, 0 };
+        fibonacciTask( &task );
+        assertTrue( task.result == fibonacci(n), "fib(%d) should be %ld, was %ld\n", n, fibonacci(n),
+                task.result );
+    }
+
+    threadPoolFree( pool );
+}
+
+void testExternalSpawns() {
+    ThreadPool *pool = newThreadPool( 2 );
+    const int numTasks = 1000;
+    Task *tasks[ numTasks ];
+    int counter = 0;
+
+    for( int i = 0; i < numTasks; i++ ) {
+        tasks[i] = threadPoolSpawn( pool, incrementTask, &counter );
+    }
+
+    for( int i = 0; i < numTasks; i++ ) {
+        threadPoolJoin( pool, tasks[i] );
+    }
+
+    assertTrue( counter == numTasks, "Counter should be %d, was %d\n", numTasks, counter );
+    threadPoolFree( pool );
+}
+
+void testDefaultPool() {
+    ThreadPool *pool = defaultThreadPool();
+
+    assertNotNull( pool, "The default pool shouldn't be null!\n" );
+    assertTrue( pool == defaultThreadPool(), "The default pool should be shared!\n" );
+
+    FibonacciTask task = { pool, 15, 0 };
+    fibonacciTask( &task );
+    assertTrue( task.result == fibonacci(15), "fib(15) should be %ld, was %ld\n", fibonacci(15),
+            task.result );
+}
+
+void testParallelSort() {
+    ThreadPool *pool = newThreadPool( 4 );
+    const int numElements = 50000;
+    int *values = malloc( sizeof(int) * numElements );
+    void **elements = malloc( sizeof(void *) * numElements );
+
+    for( int i = 0; i < numElements; i++ ) {
+        values[i] = rand() % 1000;
+        elements[i] = &values[i];
+    }
+
+    parallelSort( pool, elements, numElements, comparisonFunction );
+
+    for( int i = 1; i < numElements; i++ ) {
+        assertTrue( comparisonFunction( elements[i - 1], elements[i] ) <= 0,
+                "Elements %d and %d are out of order!\n", i - 1, i );
+    }
+
+    // Every element should still be present exactly once
+    long sum = 0;
+    long expectedSum = 0;
+    for( int i = 0; i < numElements; i++ ) {
+        sum += *(int *) elements[i];
+        expectedSum += values[i];
+    }
+
+    assertTrue( sum == expectedSum, "Sum should be %ld, was %ld\n", expectedSum, sum );
+
+    free( elements );
+    free( values );
+    threadPoolFree( pool );
+}
+
+/* Functions for use in testing */
+void squareRange( int start, int end, void *context ) {
+    long *values = context;
+
+    for( int i = start; i < end; i++ ) {
+        values[i] *= values[i];
+    }
+}
+
+void fibonacciTask( void *argument ) {
+    FibonacciTask *task = argument;
+
+    if( task->n < 2 ) {
+        task->result = task->n;
+        return;
+    }
+
+    FibonacciTask first = { task->pool, task->n - 1, 0 };
+    FibonacciTask second = { task->pool, task->n - 2, 0 };
+
+    Task *spawned = threadPoolSpawn( task->pool, fibonacciTask, &first );
+    fibonacciTask( &second );
+    threadPoolJoin( task->pool, spawned );
+
+    task->result = first.result + second.result;
+}
+
+void incrementTask( void *argument ) {
+    __atomic_fetch_add( (int *) argument, 1, __ATOMIC_RELAXED );
+}
+
+long fibonacci( int n ) {
+    long previous = 0;
+    long current = n > 0 ? 1 : 0;
+
+    for( int i = 1; i < n; i++ ) {
+        long next = previous + current;
+        previous = current;
+        current = next;
+    }
+
+    return current;
+}
+
+int comparisonFunction( void *aPtr, void *bPtr) {
+    int a = *((int *) aPtr);
+    int b = *((int *) bPtr);
+
+    if( a < b ) {
+        return -1;
+    } else if( a == b ) {
+        return 0;
+    } else {
+        return 1;
+    }
+}
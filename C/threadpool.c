@@ -0,0 +1,662 @@
+/*
+ * A work-stealing thread pool shared by the parallel container operations. Each worker owns a
+ * Chase-Lev deque (see "Correct and Efficient Work-Stealing for Weak Memory Models", Le et al.) and
+ * runs the tasks it spawns in LIFO order, while idle workers steal the oldest tasks from the top of
+ * other workers' deques.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "threadpool.h"
+
+#define INITIAL_DEQUE_CAPACITY 64
+
+/* Pieces of an array smaller than this are sorted without spawning any tasks */
+#define PARALLEL_SORT_CUTOFF 2048
+
+/* Pieces of an array smaller than this are sorted with an insertion sort */
+#define INSERTION_SORT_CUTOFF 16
+
+/*
+ * Describes a piece of a parallelFor range.
+ */
+typedef struct RangeTask {
+    ThreadPool *pool;
+    int start;
+    int end;
+    int grain;
+    RangeFunction function;
+    void *context;
+} RangeTask;
+
+/*
+ * Describes a piece of an array being sorted by parallelSort. The sorted result is written to
+ * elements, and scratch is a buffer of the same size that can be used for merging.
+ */
+typedef struct SortTask {
+    ThreadPool *pool;
+    void **elements;
+    void **scratch;
+    int numElements;
+    ComparisonFunction compare;
+} SortTask;
+
+/* The worker running on the current thread, or NULL if the thread isn't owned by a pool */
+static __thread Worker *currentWorker = NULL;
+
+/* The pool returned by defaultThreadPool */
+static ThreadPool *sharedPool = NULL;
+static pthread_once_t sharedPoolOnce = PTHREAD_ONCE_INIT;
+
+/* Implementation specific helper functions */
+TaskArray *newTaskArray( long capacity );
+TaskArray *growTaskArray( TaskArray *array, long top, long bottom );
+void dequeInit( TaskDeque *deque );
+void dequePush( TaskDeque *deque, Task *task );
+Task *dequeTake( TaskDeque *deque );
+Task *dequeSteal( TaskDeque *deque );
+void dequeFree( TaskDeque *deque );
+Task *findTask( ThreadPool *pool, Worker *self );
+void runTask( Task *task );
+void notifyWorkers( ThreadPool *pool );
+void *workerMain( void *argument );
+void createSharedPool();
+void runRange( void *argument );
+void runSort( void *argument );
+void insertionSort( void **elements, int numElements, ComparisonFunction compare );
+
+/*
+ * Allocates a circular task array. The capacity must be a power of two.
+ *
+ * Arguments:
+ * capacity -- The number of tasks the array can hold
+ *
+ * Returns:
+ * The newly allocated array
+ */
+TaskArray *newTaskArray( long capacity ) {
+    TaskArray *array = malloc( sizeof(TaskArray) );
+    array->capacity = capacity;
+    array->tasks = calloc( capacity, sizeof(Task *) );
+    array->previous = NULL;
+
+    return array;
+}
+
+/*
+ * Copies the live tasks of a full array into a new array with twice the capacity.
+ *
+ * Arguments:
+ * array  -- The array that is full
+ * top    -- The deque's current top index
+ * bottom -- The deque's current bottom index
+ *
+ * Returns:
+ * The new array, which keeps a reference to the old one
+ */
+TaskArray *growTaskArray( TaskArray *array, long top, long bottom ) {
+    TaskArray *grown = newTaskArray( array->capacity * 2 );
+
+    for( long i = top; i < bottom; i++ ) {
+        grown->tasks[ i & (grown->capacity - 1) ] = array->tasks[ i & (array->capacity - 1) ];
+    }
+
+    grown->previous = array;
+    return grown;
+}
+
+/*
+ * Initializes an empty deque.
+ *
+ * Arguments:
+ * deque -- The deque to initialize
+ */
+void dequeInit( TaskDeque *deque ) {
+    deque->top = 0;
+    deque->bottom = 0;
+    deque->array = newTaskArray( INITIAL_DEQUE_CAPACITY );
+}
+
+/*
+ * Pushes a task onto the bottom of the deque. Only the owning worker may call this.
+ *
+ * Arguments:
+ * deque -- The deque to push onto
+ * task  -- The task to push
+ */
+void dequePush( TaskDeque *deque, Task *task ) {
+    long bottom = __atomic_load_n( &deque->bottom, __ATOMIC_RELAXED );
+    long top = __atomic_load_n( &deque->top, __ATOMIC_ACQUIRE );
+    TaskArray *array = __atomic_load_n( &deque->array, __ATOMIC_RELAXED );
+
+    if( bottom - top > array->capacity - 1 ) {
+        array = growTaskArray( array, top, bottom );
+        __atomic_store_n( &deque->array, array, __ATOMIC_RELEASE );
+    }
+
+    __atomic_store_n( &array->tasks[ bottom & (array->capacity - 1) ], task, __ATOMIC_RELAXED );
+    __atomic_thread_fence( __ATOMIC_RELEASE );
+    __atomic_store_n( &deque->bottom, bottom + 1, __ATOMIC_RELAXED );
+}
+
+/*
+ * Takes the most recently pushed task from the bottom of the deque. Only the owning worker may call
+ * this. When a single task is left, the owner races thieves for it with a compare-and-swap on top.
+ *
+ * Arguments:
+ * deque -- The deque to take from
+ *
+ * Returns:
+ * The task, or NULL if the deque was empty
+ */
+Task *dequeTake( TaskDeque *deque ) {
+    long bottom = __atomic_load_n( &deque->bottom, __ATOMIC_RELAXED ) - 1;
+    TaskArray *array = __atomic_load_n( &deque->array, __ATOMIC_RELAXED );
+    __atomic_store_n( &deque->bottom, bottom, __ATOMIC_RELAXED );
+    __atomic_thread_fence( __ATOMIC_SEQ_CST );
+    long top = __atomic_load_n( &deque->top, __ATOMIC_RELAXED );
+
+    if( top > bottom ) {
+        // The deque was empty
+        __atomic_store_n( &deque->bottom, bottom + 1, __ATOMIC_RELAXED );
+        return NULL;
+    }
+
+    Task *task = __atomic_load_n( &array->tasks[ bottom & (array->capacity - 1) ], __ATOMIC_RELAXED );
+
+    if( top == bottom ) {
+        // This was the last task, so a thief may be trying to take it as well
+        if( ! __atomic_compare_exchange_n( &deque->top, &top, top + 1, 0, __ATOMIC_SEQ_CST,
+                    __ATOMIC_RELAXED ) ) {
+            task = NULL;
+        }
+
+        __atomic_store_n( &deque->bottom, bottom + 1, __ATOMIC_RELAXED );
+    }
+
+    return task;
+}
+
+/*
+ * Steals the oldest task from the top of the deque. Any thread may call this.
+ *
+ * Arguments:
+ * deque -- The deque to steal from
+ *
+ * Returns:
+ * The task, or NULL if the deque was empty or another thread took the task first
+ */
+Task *dequeSteal( TaskDeque *deque ) {
+    long top = __atomic_load_n( &deque->top, __ATOMIC_ACQUIRE );
+    __atomic_thread_fence( __ATOMIC_SEQ_CST );
+    long bottom = __atomic_load_n( &deque->bottom, __ATOMIC_ACQUIRE );
+
+    if( top >= bottom ) {
+        return NULL;
+    }
+
+    TaskArray *array = __atomic_load_n( &deque->array, __ATOMIC_ACQUIRE );
+    Task *task = __atomic_load_n( &array->tasks[ top & (array->capacity - 1) ], __ATOMIC_RELAXED );
+
+    if( ! __atomic_compare_exchange_n( &deque->top, &top, top + 1, 0, __ATOMIC_SEQ_CST,
+                __ATOMIC_RELAXED ) ) {
+        return NULL;
+    }
+
+    return task;
+}
+
+/*
+ * Frees a deque's arrays, including those it has outgrown.
+ *
+ * Arguments:
+ * deque -- The deque whose memory is being freed
+ */
+void dequeFree( TaskDeque *deque ) {
+    TaskArray *array = deque->array;
+
+    while( array != NULL ) {
+        TaskArray *previous = array->previous;
+        free( array->tasks );
+        free( array );
+        array = previous;
+    }
+}
+
+/*
+ * Creates a new thread pool and starts its workers.
+ *
+ * Arguments:
+ * numWorkers -- The number of worker threads. If this is not positive, one worker is started for
+ *               every online processor.
+ *
+ * Returns:
+ * A newly allocated thread pool
+ */
+ThreadPool *newThreadPool( int numWorkers ) {
+    if( numWorkers <= 0 ) {
+        numWorkers = (int) sysconf( _SC_NPROCESSORS_ONLN );
+
+        if( numWorkers <= 0 ) {
+            numWorkers = 1;
+        }
+    }
+
+    ThreadPool *pool = malloc( sizeof(ThreadPool) );
+    pool->numWorkers = numWorkers;
+    pool->workers = calloc( numWorkers, sizeof(Worker) );
+    pool->injectionQueue = newList( NULL );
+    pool->injectedTasks = 0;
+    pool->generation = 0;
+    pool->sleepers = 0;
+    pool->shutdown = 0;
+    pthread_mutex_init( &pool->injectionLock, NULL );
+    pthread_mutex_init( &pool->sleepLock, NULL );
+    pthread_cond_init( &pool->workAvailable, NULL );
+
+    // Every deque must exist before any worker starts stealing
+    for( int i = 0; i < numWorkers; i++ ) {
+        pool->workers[i].pool = pool;
+        pool->workers[i].seed = (unsigned int) i * 2654435761u + 1;
+        dequeInit( &pool->workers[i].deque );
+    }
+
+    for( int i = 0; i < numWorkers; i++ ) {
+        pthread_create( &pool->workers[i].thread, NULL, workerMain, &pool->workers[i] );
+    }
+
+    debug( E_DEBUG, "Started thread pool with %d workers\n", numWorkers );
+    return pool;
+}
+
+/*
+ * Creates the shared pool. This is only ever called once, through pthread_once.
+ */
+void createSharedPool() {
+    sharedPool = newThreadPool( 0 );
+}
+
+/*
+ * Returns the thread pool shared by the library's parallel container operations. The pool is created
+ * the first time this is called and has one worker per online processor.
+ *
+ * Returns:
+ * The shared thread pool
+ */
+ThreadPool *defaultThreadPool() {
+    pthread_once( &sharedPoolOnce, createSharedPool );
+    return sharedPool;
+}
+
+/*
+ * Finds a task for a thread to run. Workers check their own deque first. Then the injection queue is
+ * checked, and finally the other workers' deques are checked starting from a random victim.
+ *
+ * Arguments:
+ * pool -- The pool to find a task in
+ * self -- The worker that is looking for a task, or NULL if the thread isn't one of the pool's workers
+ *
+ * Returns:
+ * A task to run, or NULL if none could be found
+ */
+Task *findTask( ThreadPool *pool, Worker *self ) {
+    Task *task = NULL;
+
+    if( self != NULL ) {
+        task = dequeTake( &self->deque );
+
+        if( task != NULL ) {
+            return task;
+        }
+    }
+
+    if( __atomic_load_n( &pool->injectedTasks, __ATOMIC_ACQUIRE ) > 0 ) {
+        pthread_mutex_lock( &pool->injectionLock );
+        task = listPopFront( pool->injectionQueue );
+
+        if( task != NULL ) {
+            __atomic_fetch_sub( &pool->injectedTasks, 1, __ATOMIC_RELEASE );
+        }
+
+        pthread_mutex_unlock( &pool->injectionLock );
+
+        if( task != NULL ) {
+            return task;
+        }
+    }
+
+    unsigned int seed = self != NULL ? self->seed : (unsigned int)(unsigned long) &task;
+    int firstVictim = rand_r( &seed ) % pool->numWorkers;
+
+    if( self != NULL ) {
+        self->seed = seed;
+    }
+
+    for( int i = 0; i < pool->numWorkers && task == NULL; i++ ) {
+        Worker *victim = &pool->workers[ (firstVictim + i) % pool->numWorkers ];
+
+        if( victim != self ) {
+            task = dequeSteal( &victim->deque );
+        }
+    }
+
+    return task;
+}
+
+/*
+ * Runs a task and marks it as done.
+ *
+ * Arguments:
+ * task -- The task to run
+ */
+void runTask( Task *task ) {
+    task->function( task->argument );
+    __atomic_store_n( &task->done, 1, __ATOMIC_RELEASE );
+}
+
+/*
+ * Tells sleeping workers that new work is available. The generation is increased before sleepers is
+ * read, and workers increase sleepers before they check the generation, so either this sees the
+ * sleeper or the sleeper sees the new generation.
+ *
+ * Arguments:
+ * pool -- The pool whose workers should be notified
+ */
+void notifyWorkers( ThreadPool *pool ) {
+    __atomic_fetch_add( &pool->generation, 1, __ATOMIC_SEQ_CST );
+
+    if( __atomic_load_n( &pool->sleepers, __ATOMIC_SEQ_CST ) > 0 ) {
+        pthread_mutex_lock( &pool->sleepLock );
+        pthread_cond_broadcast( &pool->workAvailable );
+        pthread_mutex_unlock( &pool->sleepLock );
+    }
+}
+
+/*
+ * The main loop of a worker thread. Workers run tasks until the pool shuts down, sleeping whenever a
+ * full search for work comes up empty.
+ *
+ * Arguments:
+ * argument -- The worker that this thread is running as
+ */
+void *workerMain( void *argument ) {
+    Worker *self = argument;
+    ThreadPool *pool = self->pool;
+    currentWorker = self;
+
+    while( 1 ) {
+        unsigned long generation = __atomic_load_n( &pool->generation, __ATOMIC_SEQ_CST );
+        Task *task = findTask( pool, self );
+
+        if( task != NULL ) {
+            runTask( task );
+            continue;
+        }
+
+        pthread_mutex_lock( &pool->sleepLock );
+        __atomic_fetch_add( &pool->sleepers, 1, __ATOMIC_SEQ_CST );
+
+        while( __atomic_load_n( &pool->generation, __ATOMIC_SEQ_CST ) == generation &&
+                ! pool->shutdown ) {
+            pthread_cond_wait( &pool->workAvailable, &pool->sleepLock );
+        }
+
+        __atomic_fetch_sub( &pool->sleepers, 1, __ATOMIC_SEQ_CST );
+        int shutdown = pool->shutdown;
+        pthread_mutex_unlock( &pool->sleepLock );
+
+        if( shutdown ) {
+            break;
+        }
+    }
+
+    currentWorker = NULL;
+    return NULL;
+}
+
+/*
+ * Spawns a task onto the pool. Every spawned task must eventually be joined with threadPoolJoin.
+ *
+ * Arguments:
+ * pool     -- The pool that will run the task
+ * function -- The function the task runs
+ * argument -- The argument supplied to the function
+ *
+ * Returns:
+ * The spawned task
+ */
+Task *threadPoolSpawn( ThreadPool *pool, TaskFunction function, void *argument ) {
+    Task *task = malloc( sizeof(Task) );
+    task->function = function;
+    task->argument = argument;
+    task->done = 0;
+
+    Worker *self = currentWorker;
+
+    if( self != NULL && self->pool == pool ) {
+        dequePush( &self->deque, task );
+    } else {
+        pthread_mutex_lock( &pool->injectionLock );
+        listPushBack( pool->injectionQueue, task );
+        __atomic_fetch_add( &pool->injectedTasks, 1, __ATOMIC_RELEASE );
+        pthread_mutex_unlock( &pool->injectionLock );
+    }
+
+    notifyWorkers( pool );
+    return task;
+}
+
+/*
+ * Waits for a spawned task to finish and frees it. While waiting, the calling thread runs other tasks
+ * from the pool rather than blocking, so tasks may spawn and join subtasks freely.
+ *
+ * Arguments:
+ * pool -- The pool that the task was spawned onto
+ * task -- The task to wait for
+ */
+void threadPoolJoin( ThreadPool *pool, Task *task ) {
+    Worker *self = currentWorker != NULL && currentWorker->pool == pool ? currentWorker : NULL;
+
+    while( ! __atomic_load_n( &task->done, __ATOMIC_ACQUIRE ) ) {
+        Task *other = findTask( pool, self );
+
+        if( other != NULL ) {
+            runTask( other );
+        } else {
+            sched_yield();
+        }
+    }
+
+    free( task );
+}
+
+/*
+ * Processes a piece of a parallelFor range, splitting it in half until it is no larger than the
+ * grain size.
+ *
+ * Arguments:
+ * argument -- The RangeTask describing the piece of the range
+ */
+void runRange( void *argument ) {
+    RangeTask *range = argument;
+
+    if( range->end - range->start <= range->grain ) {
+        range->function( range->start, range->end, range->context );
+        return;
+    }
+
+    // The halves live on this stack frame, which outlives the spawned task because it is joined here
+    int middle = range->start + (range->end - range->start) / 2;
+    RangeTask left = *range;
+    RangeTask right = *range;
+    left.end = middle;
+    right.start = middle;
+
+    Task *task = threadPoolSpawn( range->pool, runRange, &right );
+    runRange( &left );
+    threadPoolJoin( range->pool, task );
+}
+
+/*
+ * Applies the range function to every index in [start, end) using the pool's workers. The range is
+ * split in half recursively, with one half spawned and the other half run by the current thread,
+ * until the pieces are no larger than the grain size. This returns once every index has been
+ * processed.
+ *
+ * Arguments:
+ * pool     -- The pool whose workers will process the range
+ * start    -- The first index in the range
+ * end      -- One past the last index in the range
+ * grain    -- The largest piece of the range that will be processed without being split. If this is
+ *             not positive, a grain size is chosen from the number of workers.
+ * function -- The function applied to each piece of the range
+ * context  -- Data supplied to every call to the function
+ */
+void parallelFor( ThreadPool *pool, int start, int end, int grain, RangeFunction function,
+        void *context ) {
+    if( end <= start ) {
+        return;
+    }
+
+    // Aim for several pieces per worker so that stealing can balance uneven work
+    if( grain <= 0 ) {
+        grain = (end - start) / (pool->numWorkers * 8);
+
+        if( grain < 1 ) {
+            grain = 1;
+        }
+    }
+
+    RangeTask range = { pool, start, end, grain, function, context };
+    runRange( &range );
+}
+
+/*
+ * Sorts small arrays in place with an insertion sort.
+ *
+ * Arguments:
+ * elements    -- The elements to sort
+ * numElements -- The number of elements in the array
+ * compare     -- The function used to order the elements
+ */
+void insertionSort( void **elements, int numElements, ComparisonFunction compare ) {
+    for( int i = 1; i < numElements; i++ ) {
+        void *element = elements[i];
+        int j = i - 1;
+
+        while( j >= 0 && compare( elements[j], element ) > 0 ) {
+            elements[j + 1] = elements[j];
+            j--;
+        }
+
+        elements[j + 1] = element;
+    }
+}
+
+/*
+ * Sorts a piece of a parallelSort array. Both halves are sorted, with the first half spawned as a
+ * task when the piece is large enough, and then they are merged through the scratch buffer.
+ *
+ * Arguments:
+ * argument -- The SortTask describing the piece of the array
+ */
+void runSort( void *argument ) {
+    SortTask *sort = argument;
+    int numElements = sort->numElements;
+
+    if( numElements <= INSERTION_SORT_CUTOFF ) {
+        insertionSort( sort->elements, numElements, sort->compare );
+        return;
+    }
+
+    int half = numElements / 2;
+    SortTask left = { sort->pool, sort->elements, sort->scratch, half, sort->compare };
+    SortTask right = { sort->pool, sort->elements + half, sort->scratch + half, numElements - half,
+        sort->compare };
+
+    if( numElements >= PARALLEL_SORT_CUTOFF ) {
+        Task *task = threadPoolSpawn( sort->pool, runSort, &left );
+        runSort( &right );
+        threadPoolJoin( sort->pool, task );
+    } else {
+        runSort( &left );
+        runSort( &right );
+    }
+
+    // Merge the sorted halves into the scratch buffer and copy them back
+    int i = 0;
+    int j = half;
+    int k = 0;
+    while( i < half && j < numElements ) {
+        if( sort->compare( sort->elements[j], sort->elements[i] ) < 0 ) {
+            sort->scratch[k++] = sort->elements[j++];
+        } else {
+            sort->scratch[k++] = sort->elements[i++];
+        }
+    }
+
+    while( i < half ) {
+        sort->scratch[k++] = sort->elements[i++];
+    }
+
+    // Anything left in the second half is already in its final position
+    for( int m = 0; m < k; m++ ) {
+        sort->elements[m] = sort->scratch[m];
+    }
+}
+
+/*
+ * Sorts an array of elements using a parallel merge sort on the pool's workers. The two halves of
+ * every sufficiently large piece of the array are sorted concurrently and then merged.
+ *
+ * Arguments:
+ * pool               -- The pool whose workers will sort the array
+ * elements           -- The elements to sort
+ * numElements        -- The number of elements in the array
+ * comparisonFunction -- The function used to order the elements
+ */
+void parallelSort( ThreadPool *pool, void **elements, int numElements,
+        ComparisonFunction comparisonFunction ) {
+    if( numElements < 2 ) {
+        return;
+    }
+
+    void **scratch = malloc( sizeof(void *) * numElements );
+    SortTask sort = { pool, elements, scratch, numElements, comparisonFunction };
+    runSort( &sort );
+    free( scratch );
+}
+
+/*
+ * Stops the pool's workers and frees the pool. Every spawned task must have been joined first.
+ *
+ * Arguments:
+ * pool -- The pool that is being freed
+ */
+void threadPoolFree( ThreadPool *pool ) {
+    pthread_mutex_lock( &pool->sleepLock );
+    pool->shutdown = 1;
+    __atomic_fetch_add( &pool->generation, 1, __ATOMIC_SEQ_CST );
+    pthread_cond_broadcast( &pool->workAvailable );
+    pthread_mutex_unlock( &pool->sleepLock );
+
+    for( int i = 0; i < pool->numWorkers; i++ ) {
+        pthread_join( pool->workers[i].thread, NULL );
+    }
+
+    for( int i = 0; i < pool->numWorkers; i++ ) {
+        dequeFree( &pool->workers[i].deque );
+    }
+
+    pthread_mutex_destroy( &pool->injectionLock );
+    pthread_mutex_destroy( &pool->sleepLock );
+    pthread_cond_destroy( &pool->workAvailable );
+
+    // The injection queue is empty once every task has been joined
+    listFree( pool->injectionQueue );
+    free( pool->workers );
+    free( pool );
+}
@@ -0,0 +1,169 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <pthread.h>
+
+#include "llist.h"
+#include "utils.h"
+
+/*
+ * A task function performs a unit of work on the argument it was spawned with.
+ */
+typedef void (*TaskFunction)(void *);
+
+/*
+ * A range function performs work on the indices in [start, end) of some collection. The context is
+ * whatever was supplied to parallelFor.
+ */
+typedef void (*RangeFunction)(int start, int end, void *context);
+
+/*
+ * A unit of work that has been spawned onto a thread pool. A task is finished once done is set, and
+ * is freed when it is joined.
+ */
+typedef struct Task {
+    TaskFunction function;
+    void *argument;
+    int done;
+} Task;
+
+/*
+ * The circular array backing a task deque. When a deque grows, the previous array is kept until the
+ * deque is freed because thieves may still be reading from it.
+ */
+typedef struct TaskArray {
+    long capacity;
+    Task **tasks;
+    struct TaskArray *previous;
+} TaskArray;
+
+/*
+ * A Chase-Lev work-stealing deque. The owning worker pushes and takes tasks at the bottom without
+ * locking, while other threads steal tasks from the top.
+ */
+typedef struct TaskDeque {
+    long top;
+    char padding[CACHE_LINE_SIZE - sizeof(long)];
+    long bottom;
+    TaskArray *array;
+} TaskDeque;
+
+/*
+ * A thread owned by a pool, along with the deque of tasks it has spawned.
+ */
+typedef struct Worker {
+    struct ThreadPool *pool;
+    pthread_t thread;
+    unsigned int seed;
+    TaskDeque deque;
+} Worker;
+
+/*
+ * A work-stealing thread pool. Tasks spawned by a worker go onto that worker's deque, while tasks
+ * spawned by other threads go onto the shared injection queue. Idle workers steal from the injection
+ * queue and from each other, and sleep when there is nothing left to steal.
+ *
+ * The generation counter is increased every time work is made available, so that a worker which saw
+ * no work in a given generation knows it is safe to sleep until the generation changes.
+ */
+typedef struct ThreadPool {
+    int numWorkers;
+    Worker *workers;
+
+    /* Tasks spawned by threads outside of the pool */
+    LList *injectionQueue;
+    int injectedTasks;
+    pthread_mutex_t injectionLock;
+
+    /* Sleeping and waking idle workers */
+    pthread_mutex_t sleepLock;
+    pthread_cond_t workAvailable;
+    unsigned long generation;
+    int sleepers;
+    int shutdown;
+} ThreadPool;
+
+/*
+ * Creates a new thread pool and starts its workers.
+ *
+ * Arguments:
+ * numWorkers -- The number of worker threads. If this is not positive, one worker is started for
+ *               every online processor.
+ *
+ * Returns:
+ * A newly allocated thread pool
+ */
+extern ThreadPool *newThreadPool( int numWorkers );
+
+/*
+ * Returns the thread pool shared by the library's parallel container operations. The pool is created
+ * the first time this is called and has one worker per online processor.
+ *
+ * Returns:
+ * The shared thread pool
+ */
+extern ThreadPool *defaultThreadPool();
+
+/*
+ * Spawns a task onto the pool. Every spawned task must eventually be joined with threadPoolJoin.
+ *
+ * Arguments:
+ * pool     -- The pool that will run the task
+ * function -- The function the task runs
+ * argument -- The argument supplied to the function
+ *
+ * Returns:
+ * The spawned task
+ */
+extern Task *threadPoolSpawn( ThreadPool *pool, TaskFunction function, void *argument );
+
+/*
+ * Waits for a spawned task to finish and frees it. While waiting, the calling thread runs other tasks
+ * from the pool rather than blocking, so tasks may spawn and join subtasks freely.
+ *
+ * Arguments:
+ * pool -- The pool that the task was spawned onto
+ * task -- The task to wait for
+ */
+extern void threadPoolJoin( ThreadPool *pool, Task *task );
+
+/*
+ * Applies the range function to every index in [start, end) using the pool's workers. The range is
+ * split in half recursively, with one half spawned and the other half run by the current thread,
+ * until the pieces are no larger than the grain size. This returns once every index has been
+ * processed.
+ *
+ * Arguments:
+ * pool     -- The pool whose workers will process the range
+ * start    -- The first index in the range
+ * end      -- One past the last index in the range
+ * grain    -- The largest piece of the range that will be processed without being split. If this is
+ *             not positive, a grain size is chosen from the number of workers.
+ * function -- The function applied to each piece of the range
+ * context  -- Data supplied to every call to the function
+ */
+extern void parallelFor( ThreadPool *pool, int start, int end, int grain, RangeFunction function,
+        void *context );
+
+/*
+ * Sorts an array of elements using a parallel merge sort on the pool's workers. The two halves of
+ * every sufficiently large piece of the array are sorted concurrently and then merged.
+ *
+ * Arguments:
+ * pool               -- The pool whose workers will sort the array
+ * elements           -- The elements to sort
+ * numElements        -- The number of elements in the array
+ * comparisonFunction -- The function used to order the elements
+ */
+extern void parallelSort( ThreadPool *pool, void **elements, int numElements,
+        ComparisonFunction comparisonFunction );
+
+/*
+ * Stops the pool's workers and frees the pool. Every spawned task must have been joined first.
+ *
+ * Arguments:
+ * pool -- The pool that is being freed
+ */
+extern void threadPoolFree( ThreadPool *pool );
+
+#endif
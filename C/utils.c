@@ -87,6 +87,28 @@ void vdebug( int debugType, const char *format, va_list args ) {
     }
 }
 
+/*
+ * Scrambles the bits of a hash so that every bit of the result depends on every bit of the input.
+ * Hashes such as the identity on integers, or addresses, leave most of their bits predictable, and
+ * mixing them first lets callers use any subset of the bits. This is the finalizer of the
+ * SplitMix64 generator.
+ *
+ * Arguments:
+ * x -- The hash to scramble
+ *
+ * Returns:
+ * The scrambled hash
+ */
+uint64_t mixHash( uint64_t x ) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+
+    return x;
+}
+
 /*
  * Provides the concrete implementation of the assertion testing and output. On test failure, this
  * will print a message in the following format:
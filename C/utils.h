@@ -6,6 +6,7 @@
  * Created by Christopher Chapline.
  *
  */
+#include <stdint.h>
 #include <stdio.h>
 
 #ifndef UTILS_H
@@ -19,6 +20,16 @@
 #define E_INFO      16
 #define E_ALL       E_FATAL | E_ERROR | E_WARNING | E_DEBUG | E_INFO
 
+/* The size of a cache line, used to keep data written by different threads from false sharing */
+#define CACHE_LINE_SIZE 64
+
+/* Hints that the memory at an address will be read soon, on compilers that support it */
+#if defined(__GNUC__)
+#define PREFETCH(address) __builtin_prefetch( (address) )
+#else
+#define PREFETCH(address) ((void) (address))
+#endif
+
 /* Assert macros */
 #define assertTrue(assertionValue, msgFormat, ...) __assert((assertionValue), __FILE__, __LINE__, __func__, msgFormat,  ##__VA_ARGS__ )
 #define assertFalse(assertionValue, msgFormat, ...) __assert(((assertionValue) == 0), __FILE__, __LINE__, __func__, msgFormat,  ##__VA_ARGS__ )
@@ -62,6 +73,20 @@ extern void setDebuggingLevel( int debugLevel );
  */
 extern void setDebugOutputStream( FILE *outputStream );
 
+/*
+ * Scrambles the bits of a hash so that every bit of the result depends on every bit of the input.
+ * Hashes such as the identity on integers, or addresses, leave most of their bits predictable, and
+ * mixing them first lets callers use any subset of the bits. This is the finalizer of the
+ * SplitMix64 generator.
+ *
+ * Arguments:
+ * x -- The hash to scramble
+ *
+ * Returns:
+ * The scrambled hash
+ */
+extern uint64_t mixHash( uint64_t x );
+
 /*
  * Provides the concrete implementation of the assertion testing and output. On test failure, this
  * will print a message in the following format:
@@ -32,6 +32,12 @@ int isInBounds( Vector *vector, int indexToCheck ) {
 void resizeIfNecessary( Vector *vector ) {
     if( vector->size == vector->capacity ) {
         int newCapacity = (vector->capacity * 1.25);
+
+        // Small capacities don't grow when multiplied, so make sure there is always room for more
+        if( newCapacity <= vector->capacity ) {
+            newCapacity = vector->capacity + 4;
+        }
+
         void** newElements  = (void **)realloc( vector->elements, sizeof(void *) * newCapacity );
 
         if( ! newElements ) {